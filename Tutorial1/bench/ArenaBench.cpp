@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <AnimAsset.h>
+#include <Arena.h>
+#include <Timer.h>
+
+#include "Bench.h"
+
+/* Loads and unloads many characters from a binary asset, like a level
+* streaming crowds in and out: every skeleton and mesh output on the heap
+* (one allocation per array) vs all of them in one arena released at once:
+*	Benchmarks arena [characters] [bones] [vertices] [rounds]
+*/
+
+#define ARENA_BENCH_FILE "arena_bench.ska"
+
+/* Writes a synthetic character to ARENA_BENCH_FILE */
+static int writeCharacter(int bones, int vertices)
+{
+	Skeleton skel;
+	AnimClip clip;
+	SkinMesh mesh;
+
+	benchBuildRig(&skel, bones);
+	benchBuildClip(&clip, bones, 2);
+	benchBuildMesh(&mesh, vertices, bones);
+
+	return AnimAsset::Write(ARENA_BENCH_FILE, skel, clip, mesh);
+}
+
+int benchArena(int argc, char **argv)
+{
+	int characters = argc > 0 ? atoi(argv[0]) : 1000;
+	int bones = argc > 1 ? atoi(argv[1]) : 60;
+	int vertices = argc > 2 ? atoi(argv[2]) : 500;
+	int rounds = argc > 3 ? atoi(argv[3]) : 20;
+	AnimAsset asset;
+	Arena arena;
+	Skeleton *skel;
+	SkinMesh *mesh;
+	double heapLoad = 0.0, heapFree = 0.0, arenaLoad = 0.0, arenaFree = 0.0;
+	int i, r, ok = 1;
+	float sum = 0.0f;
+	Timer timer;
+
+	if (characters < 1 || bones < 1 || vertices < 1 || rounds < 1)
+	{
+		fprintf(stderr, "Usage: arena [characters] [bones] [vertices] [rounds]\n");
+		return EXIT_FAILURE;
+	}
+
+	srand(1);
+	if (!writeCharacter(bones, vertices) || !asset.Open(ARENA_BENCH_FILE))
+	{
+		fprintf(stderr, "arena: can't write %s\n", ARENA_BENCH_FILE);
+		return EXIT_FAILURE;
+	}
+
+	for (r = 0; r < rounds; r++)
+	{
+		/* Heap: every array is a separate allocation, freed one by one */
+		timer.Reset();
+		skel = new Skeleton[characters];
+		mesh = new SkinMesh[characters];
+		for (i = 0; i < characters; i++)
+		{
+			ok &= asset.LoadSkeleton(skel[i]);
+			asset.AttachMesh(mesh[i]);
+		}
+		heapLoad += timer.GetElapsed();
+		for (i = 0; i < characters; i++)
+			sum += skel[i].GetX()[bones - 1];
+
+		timer.Reset();
+		delete[] skel;
+		delete[] mesh;
+		heapFree += timer.GetElapsed();
+
+		/* Arena: the same data in a few big chunks, freed in one call */
+		timer.Reset();
+		skel = new Skeleton[characters];
+		mesh = new SkinMesh[characters];
+		for (i = 0; i < characters; i++)
+		{
+			ok &= asset.LoadSkeleton(skel[i], arena);
+			ok &= asset.AttachMesh(mesh[i], arena);
+		}
+		arenaLoad += timer.GetElapsed();
+		for (i = 0; i < characters; i++)
+			sum += skel[i].GetX()[bones - 1];
+
+		/* The objects own nothing; the arena goes after them */
+		timer.Reset();
+		delete[] skel;
+		delete[] mesh;
+		arena.Release();
+		arenaFree += timer.GetElapsed();
+	}
+
+	benchSink = sum;
+
+	printf("%d characters, %d bones, %d vertices, %d rounds (us per round)\n",
+		characters, bones, vertices, rounds);
+	printf("%-6s %12s %12s %12s\n", "", "load", "unload", "total");
+	printf("%-6s %12.1f %12.1f %12.1f\n", "heap", heapLoad * 1e6 / rounds, heapFree * 1e6 / rounds,
+		(heapLoad + heapFree) * 1e6 / rounds);
+	printf("%-6s %12.1f %12.1f %12.1f\n", "arena", arenaLoad * 1e6 / rounds, arenaFree * 1e6 / rounds,
+		(arenaLoad + arenaFree) * 1e6 / rounds);
+
+	asset.Close();
+	remove(ARENA_BENCH_FILE);
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <LocalFile.h>
+#include <ThreadPoolIO.h>
+#include <UringIO.h>
+#include <Timer.h>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#endif
+
+#include "Bench.h"
+
+/* Loads many small asset files through the async read API: a blocking
+* Seek/Read loop on one thread, the thread pool backend and io_uring,
+* at queue depths 1 to 64. Each run keeps at most depth reads in flight.
+* The files are written to the current directory and removed at the end.
+* Just written files are in the page cache; "cold" drops them from the
+* cache before every run (Linux only), which is what a first load sees:
+*	Benchmarks async [files] [bytes] [cold]
+*/
+
+#define ASYNC_NAME	"asyncbench_%04d.tmp"
+
+static int fileCount = 1000;
+static int fileSize = 4096;
+static int cold = 0;
+
+/* Sums the bytes read, so a wrong read shows up as a different checksum */
+static unsigned long checksum(unsigned char **buffers)
+{
+	unsigned long sum = 0;
+	int i, k;
+
+	for (i = 0; i < fileCount; i++)
+		for (k = 0; k < fileSize; k += 64)
+			sum = sum * 31 + buffers[i][k];
+
+	return sum;
+}
+
+/* Zeroes every buffer before a run, so a read that is skipped or lands in
+* the wrong buffer changes the checksum
+*/
+static void clearBuffers(unsigned char **buffers)
+{
+	int i;
+
+	for (i = 0; i < fileCount; i++)
+		memset(buffers[i], 0, fileSize);
+}
+
+/* Drops the files from the page cache */
+static void evict(LocalFile **files)
+{
+#if defined(__linux__) && defined(POSIX_FADV_DONTNEED)
+	int i;
+
+	for (i = 0; i < fileCount; i++)
+		posix_fadvise(fileno((FILE *)files[i]->GetInternalData()), 0, 0, POSIX_FADV_DONTNEED);
+#else
+	(void)files;
+#endif
+}
+
+/* Seconds to read all the files with io, depth reads in flight; NULL reads synchronously */
+static double runLoad(AsyncIO *io, int depth, LocalFile **files, unsigned char **buffers, AsyncRequest *requests)
+{
+	int i;
+	Timer timer;
+
+	for (i = 0; i < fileCount; i++)
+	{
+		requests[i] = AsyncRequest(files[i], 0, fileSize, buffers[i]);
+
+		if (!io)
+		{
+			requests[i].result = ThreadPoolIO::ReadNow(requests[i]);
+			continue;
+		}
+
+		/* Sliding window: the oldest read must finish before a new one goes in */
+		if (i >= depth)
+			io->Wait(requests[i - depth]);
+		io->Submit(requests[i]);
+	}
+
+	if (io)
+		io->WaitAll();
+
+	return timer.GetElapsed();
+}
+
+static void report(const char *name, int depth, double seconds, unsigned long sum, unsigned long expected)
+{
+	printf("%-12s %6d %12.0f %10.1f %10.2f%s\n", name, depth, fileCount / seconds,
+		(double)fileCount * fileSize / seconds / (1024.0 * 1024.0), seconds * 1e6 / fileCount,
+		sum == expected ? "" : "  (wrong data)");
+}
+
+int benchAsync(int argc, char **argv)
+{
+	static const int depths[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+	int i, k, positional = 0, result = EXIT_SUCCESS;
+	char name[64];
+	unsigned char *data, **buffers;
+	unsigned long expected;
+	LocalFile **files;
+	AsyncRequest *requests;
+	AsyncIO *io;
+	double seconds;
+
+	for (i = 0; i < argc; i++)
+		if (!strcmp(argv[i], "cold"))
+			cold = 1;
+		else if (positional++ == 0)
+			fileCount = atoi(argv[i]);
+		else
+			fileSize = atoi(argv[i]);
+
+	if (fileCount < 1 || fileSize < 1)
+	{
+		fprintf(stderr, "Usage: async [files] [bytes] [cold]\n");
+		return EXIT_FAILURE;
+	}
+
+	/* Write the files, each with different content */
+	data = new unsigned char[fileSize];
+	expected = 0;
+	for (i = 0; i < fileCount; i++)
+	{
+		FILE *out;
+
+		for (k = 0; k < fileSize; k++)
+			data[k] = (unsigned char)(rand() >> 4);
+
+		sprintf(name, ASYNC_NAME, i);
+		out = fopen(name, "wb");
+		if (!out || fwrite(data, 1, fileSize, out) != (size_t)fileSize)
+		{
+			fprintf(stderr, "Failed to write %s\n", name);
+			if (out)
+				fclose(out);
+			fileCount = i;
+			result = EXIT_FAILURE;
+			break;
+		}
+		fclose(out);
+	}
+	delete[] data;
+
+	files = new LocalFile*[fileCount];
+	buffers = new unsigned char*[fileCount];
+	requests = new AsyncRequest[fileCount];
+	for (i = 0; i < fileCount; i++)
+	{
+		sprintf(name, ASYNC_NAME, i);
+		files[i] = new LocalFile(name, "rb");
+		buffers[i] = new unsigned char[fileSize];
+	}
+
+	if (result == EXIT_SUCCESS)
+	{
+		printf("%d files of %d bytes, %s page cache\n", fileCount, fileSize, cold ? "cold" : "warm");
+		printf("%-12s %6s %12s %10s %10s\n", "backend", "depth", "files/s", "MB/s", "us/file");
+
+		if (cold)
+			evict(files);
+		clearBuffers(buffers);
+		seconds = runLoad(NULL, 1, files, buffers, requests);
+		expected = checksum(buffers);
+		report("blocking", 1, seconds, expected, expected);
+
+		for (k = 0; k < (int)(sizeof(depths) / sizeof(depths[0])); k++)
+		{
+			io = new ThreadPoolIO(depths[k]);
+			if (cold)
+				evict(files);
+			clearBuffers(buffers);
+			seconds = runLoad(io, depths[k], files, buffers, requests);
+			report("thread pool", depths[k], seconds, checksum(buffers), expected);
+			delete io;
+
+			if (!UringIO::IsSupported())
+				continue;
+
+			io = new UringIO(depths[k]);
+			if (cold)
+				evict(files);
+			clearBuffers(buffers);
+			seconds = runLoad(io, depths[k], files, buffers, requests);
+			report("io_uring", depths[k], seconds, checksum(buffers), expected);
+			delete io;
+		}
+
+		if (!UringIO::IsSupported())
+			printf("io_uring is not available\n");
+	}
+
+	for (i = 0; i < fileCount; i++)
+	{
+		delete files[i];
+		delete[] buffers[i];
+		sprintf(name, ASYNC_NAME, i);
+		remove(name);
+	}
+	delete[] files;
+	delete[] buffers;
+	delete[] requests;
+
+	return result;
+}
@@ -0,0 +1,43 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/* Every benchmark is a function taking the remaining command line
+* arguments; they are listed in BenchMain.cpp
+*/
+
+/* Keyframe lookup: linear scan vs binary search vs cursor */
+int benchSampling(int argc, char **argv);
+
+/* Many small file reads: blocking, thread pool, io_uring at queue depths 1-64 */
+int benchAsync(int argc, char **argv);
+
+/* Text skeleton parsing: fileGets/sscanf/strtok vs TextReader */
+int benchTextParse(int argc, char **argv);
+
+/* Forward kinematics: generic flattened loop vs FixedSkeleton on 10/30/100 bones */
+int benchFixedFK(int argc, char **argv);
+
+/* Loading and unloading many characters: per-array heap allocations vs one arena */
+int benchArena(int argc, char **argv);
+
+/* Animating a crowd: plain loop vs the job system, serial, parallel for and job chains */
+int benchJobs(int argc, char **argv);
+
+/* Keeps the optimizer from removing the benchmarked work */
+extern volatile float benchSink;
+
+class Skeleton;
+class AnimClip;
+class SkinMesh;
+
+/* Fixture helpers, in BenchUtil.cpp: a random float in [-range, range],
+* a rig of chains of four bones hanging from the root (like limbs), a clip
+* with random angle and length keys for every bone and a mesh of random
+* vertices, each with SKIN_INFLUENCES random bones
+*/
+float benchRandom(float range);
+void benchBuildRig(Skeleton *skel, int bones);
+void benchBuildClip(AnimClip *clip, int bones, int keys);
+void benchBuildMesh(SkinMesh *mesh, int vertices, int bones);
+
+#endif /*BENCH_H_*/
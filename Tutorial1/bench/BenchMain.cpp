@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "Bench.h"
+
+/* Micro benchmarks for the animation code. They don't need OpenGL, so
+* they also run on machines without a display:
+*	Benchmarks all
+*	Benchmarks sampling
+*/
+
+volatile float benchSink = 0.0f;
+
+typedef struct
+{
+	const char *name;
+	int (*run)(int argc, char **argv);
+	const char *description;
+} Benchmark;
+
+static const Benchmark benchmarks[] =
+{
+	{ "sampling", benchSampling, "keyframe lookup: linear scan, binary search, cursor" },
+	{ "async", benchAsync, "small file loads: blocking, thread pool, io_uring" },
+	{ "textparse", benchTextParse, "1M keyframe text skeleton: sscanf/strtok vs TextReader" },
+	{ "fixedfk", benchFixedFK, "forward kinematics and skinning: generic vs fixed topology" },
+	{ "arena", benchArena, "load and unload 1000 characters: heap vs arena" },
+	{ "jobs", benchJobs, "crowd animation: loop vs work stealing job system" },
+};
+
+#define BENCHMARK_COUNT (int)(sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+int main(int argc, char **argv)
+{
+	int i, ran = 0, result = EXIT_SUCCESS;
+
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s all|<benchmark> [options]\n", argv[0]);
+		for (i = 0; i < BENCHMARK_COUNT; i++)
+			fprintf(stderr, "  %-12s %s\n", benchmarks[i].name, benchmarks[i].description);
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < BENCHMARK_COUNT; i++)
+		if (!strcmp(argv[1], "all") || !strcmp(argv[1], benchmarks[i].name))
+		{
+			printf("== %s ==\n", benchmarks[i].name);
+			if (benchmarks[i].run(argc - 2, argv + 2) != EXIT_SUCCESS)
+				result = EXIT_FAILURE;
+			ran++;
+		}
+
+	if (!ran)
+	{
+		fprintf(stderr, "Unknown benchmark %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	return result;
+}
@@ -0,0 +1,62 @@
+#include <stdlib.h>
+
+#include <Skeleton.h>
+#include <AnimClip.h>
+#include <Skinning.h>
+
+#include "Bench.h"
+
+/* Synthetic data shared by the benchmarks; seed with srand() for
+* repeatable runs
+*/
+
+float benchRandom(float range)
+{
+	return (float)rand() / RAND_MAX * 2.0f * range - range;
+}
+
+void benchBuildRig(Skeleton *skel, int bones)
+{
+	int i;
+
+	for (i = 0; i < bones; i++)
+		skel->AddBone(i == 0 ? -1 : (i % 4 == 1 ? 0 : i - 1),
+			benchRandom(1.0f), benchRandom(1.0f), benchRandom(3.0f), 10.0f + benchRandom(5.0f));
+}
+
+void benchBuildClip(AnimClip *clip, int bones, int keys)
+{
+	Keyframe *key = new Keyframe[keys];
+	int i, k;
+
+	for (i = 0; i < bones; i++)
+	{
+		for (k = 0; k < keys; k++)
+		{
+			key[k].time = k * 20;
+			key[k].angle = benchRandom(3.0f);
+			key[k].length = 10.0f + benchRandom(2.0f);
+		}
+		clip->AddKeyframes(i, key, keys);
+	}
+
+	delete[] key;
+}
+
+void benchBuildMesh(SkinMesh *mesh, int vertices, int bones)
+{
+	int i, k, bone[SKIN_INFLUENCES];
+	float weight[SKIN_INFLUENCES];
+
+	mesh->Resize(vertices);
+	for (i = 0; i < vertices; i++)
+	{
+		mesh->SetPosition(i, benchRandom(100.0f), benchRandom(100.0f));
+		for (k = 0; k < SKIN_INFLUENCES; k++)
+		{
+			bone[k] = rand() % bones;
+			weight[k] = 0.1f + (float)rand() / RAND_MAX;
+		}
+		mesh->SetInfluences(i, bone, weight, SKIN_INFLUENCES);
+	}
+}
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <Skeleton.h>
+#include <Skinning.h>
+#include <FixedSkeleton.h>
+#include <Timer.h>
+
+#include "Bench.h"
+
+/* Compares the generic flattened forward kinematics (Skeleton::ComputeWorld,
+* a loop over the parent indices) with FixedSkeleton, where the hierarchy is
+* a template parameter and the compiler unrolls it, on 10, 30 and 100 bone
+* rigs. Both are measured alone and followed by skinning a mesh:
+*	Benchmarks fixedfk [bone updates] [vertices]
+*/
+
+/* The shape of benchBuildRig: chains of four bones hanging from the root */
+template <int N>
+struct BenchTopology
+{
+	enum { BONE_COUNT = N };
+
+	template <int Bone>
+	struct Parent
+	{
+		enum { VALUE = Bone == 0 ? -1 : (Bone % 4 == 1 ? 0 : Bone - 1) };
+	};
+};
+
+/* Runs one rig size; returns 0 when the two paths disagree */
+template <int N>
+static int runRig(int updates, int vertices)
+{
+	typedef FixedSkeleton< BenchTopology<N> > Fixed;
+
+	Skeleton skel;
+	SkinMesh mesh;
+	SkinStream stream;
+	float *outX = new float[vertices], *outY = new float[vertices];
+	float *angle, sum = 0.0f, diff = 0.0f, d;
+	Affine2 generic[N];
+	double times[4];
+	int i, iterations = updates / N, skins = iterations / 10 + 1;
+	Timer timer;
+
+	benchBuildRig(&skel, N);
+	benchBuildMesh(&mesh, vertices, N);
+	stream = mesh.GetStream();
+	angle = skel.GetAngles();
+
+	if (!Fixed::Matches(skel))
+	{
+		fprintf(stderr, "fixedfk: the rig doesn't match its topology\n");
+		return 0;
+	}
+
+	/* Same results: compare the palettes */
+	skel.ComputeWorld();
+	for (i = 0; i < N; i++)
+		generic[i] = skel.GetWorld(i);
+	Fixed::ComputeWorld(skel);
+	for (i = 0; i < N; i++)
+	{
+		d = (float)(fabs(generic[i].tx - skel.GetWorld(i).tx) + fabs(generic[i].ty - skel.GetWorld(i).ty) +
+			fabs(generic[i].a - skel.GetWorld(i).a) + fabs(generic[i].b - skel.GetWorld(i).b));
+		if (d > diff)
+			diff = d;
+	}
+
+	/* The root angle changes every time, so no pass can be skipped */
+	timer.Reset();
+	for (i = 0; i < iterations; i++)
+	{
+		angle[0] += 1e-4f;
+		skel.ComputeWorld();
+		sum += skel.GetWorld(N - 1).tx;
+	}
+	times[0] = timer.GetElapsed() * 1e9 / iterations;
+
+	timer.Reset();
+	for (i = 0; i < iterations; i++)
+	{
+		angle[0] += 1e-4f;
+		Fixed::ComputeWorld(skel);
+		sum += skel.GetWorld(N - 1).tx;
+	}
+	times[1] = timer.GetElapsed() * 1e9 / iterations;
+
+	timer.Reset();
+	for (i = 0; i < skins; i++)
+	{
+		angle[0] += 1e-4f;
+		skel.ComputeWorld();
+		SkinVertices(skel.GetPalette(), stream, outX, outY);
+		sum += outX[i % vertices];
+	}
+	times[2] = timer.GetElapsed() * 1e9 / skins;
+
+	timer.Reset();
+	for (i = 0; i < skins; i++)
+	{
+		angle[0] += 1e-4f;
+		Fixed::Skin(skel, stream, outX, outY);
+		sum += outX[i % vertices];
+	}
+	times[3] = timer.GetElapsed() * 1e9 / skins;
+
+	benchSink = sum;
+
+	printf("%5d %12.1f %12.1f %7.2fx %12.1f %12.1f %7.2fx %10g\n", N,
+		times[0], times[1], times[0] / times[1], times[2], times[3], times[2] / times[3], diff);
+
+	delete[] outX;
+	delete[] outY;
+
+	return diff <= 1e-3f;
+}
+
+int benchFixedFK(int argc, char **argv)
+{
+	int updates = argc > 0 ? atoi(argv[0]) : 20000000;
+	int vertices = argc > 1 ? atoi(argv[1]) : 2000;
+	int ok = 1;
+
+	if (updates < 100 || vertices < 1)
+	{
+		fprintf(stderr, "Usage: fixedfk [bone updates] [vertices]\n");
+		return EXIT_FAILURE;
+	}
+
+	srand(1);
+
+	printf("%d bone updates per rig; skinning %d vertices, %d influences (ns per call)\n",
+		updates, vertices, SKIN_INFLUENCES);
+	printf("%5s %12s %12s %8s %12s %12s %8s %10s\n", "bones",
+		"generic FK", "fixed FK", "speedup", "generic+skin", "fixed+skin", "speedup", "max diff");
+
+	ok &= runRig<10>(updates, vertices);
+	ok &= runRig<30>(updates, vertices);
+	ok &= runRig<100>(updates, vertices);
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Skeleton.h>
+#include <AnimClip.h>
+#include <Skinning.h>
+#include <JobSystem.h>
+#include <Timer.h>
+
+#include "Bench.h"
+
+/* Animates a crowd (sampling, forward kinematics and skinning for every
+* character) with a plain loop, with the job system running serially, with
+* a parallel for over all the cores and with one sample -> FK -> skin chain
+* of dependent jobs per character:
+*	Benchmarks jobs [characters] [bones] [vertices] [frames]
+*/
+
+typedef struct
+{
+	Skeleton skeleton;
+	AnimCursor cursor;
+	SkinMesh mesh;
+} BenchCharacter;
+
+typedef struct
+{
+	BenchCharacter *characters;
+	const AnimClip *clip;
+	float time;
+} BenchCrowd;
+
+static void buildCharacter(BenchCharacter *c, const AnimClip *clip, const SkinStream &stream, int bones)
+{
+	benchBuildRig(&c->skeleton, bones);
+	c->cursor.Bind(*clip);
+	c->mesh.Attach(stream);
+}
+
+/* The three stages, for the characters [begin, end) */
+static void sampleJob(void *data, int begin, int end)
+{
+	BenchCrowd *crowd = (BenchCrowd *)data;
+	Pose pose;
+	int i;
+
+	for (i = begin; i < end; i++)
+	{
+		pose = crowd->characters[i].skeleton.GetPose();
+		SamplePose(*crowd->clip, crowd->time, pose, crowd->characters[i].cursor);
+	}
+}
+
+static void fkJob(void *data, int begin, int end)
+{
+	BenchCrowd *crowd = (BenchCrowd *)data;
+	int i;
+
+	for (i = begin; i < end; i++)
+		crowd->characters[i].skeleton.ComputeWorld();
+}
+
+static void skinJob(void *data, int begin, int end)
+{
+	BenchCrowd *crowd = (BenchCrowd *)data;
+	int i;
+
+	for (i = begin; i < end; i++)
+		crowd->characters[i].mesh.Skin(crowd->characters[i].skeleton.GetPalette());
+}
+
+static void animateJob(void *data, int begin, int end)
+{
+	sampleJob(data, begin, end);
+	fkJob(data, begin, end);
+	skinJob(data, begin, end);
+}
+
+/* Milliseconds per frame for one method (0 loop, 1 parallel for, 2 chains) */
+static double runMethod(int method, JobSystem *jobs, BenchCrowd *crowd, int count, int frames, float *checksum)
+{
+	Job *root, *sample, *fk, *skin;
+	int f, i, n;
+	float sum = 0.0f;
+	Timer timer;
+
+	for (f = 0; f < frames; f++)
+	{
+		crowd->time = (float)(f % 140);
+
+		if (method == 0)
+			animateJob(crowd, 0, count);
+		else if (method == 1)
+			jobs->ParallelFor(animateJob, crowd, count);
+		else
+		{
+			/* Each character waits only for its own previous stage */
+			root = jobs->Create(NULL, NULL);
+			for (i = 0; i < count; i++)
+			{
+				sample = jobs->Create(sampleJob, crowd, i, i + 1, root);
+				fk = jobs->Create(fkJob, crowd, i, i + 1, root);
+				skin = jobs->Create(skinJob, crowd, i, i + 1, root);
+				jobs->AddDependency(fk, sample);
+				jobs->AddDependency(skin, fk);
+				jobs->Run(skin);
+				jobs->Run(fk);
+				jobs->Run(sample);
+			}
+			jobs->Run(root);
+			jobs->Wait(root);
+		}
+	}
+	n = crowd->characters[0].mesh.GetVertexCount();
+	for (i = 0; i < count; i++)
+		sum += crowd->characters[i].mesh.GetSkinnedX()[i % n];
+
+	*checksum = sum;
+	benchSink = sum;
+
+	return timer.GetElapsed() * 1e3 / frames;
+}
+
+int benchJobs(int argc, char **argv)
+{
+	int count = argc > 0 ? atoi(argv[0]) : 500;
+	int bones = argc > 1 ? atoi(argv[1]) : 30;
+	int vertices = argc > 2 ? atoi(argv[2]) : 500;
+	int frames = argc > 3 ? atoi(argv[3]) : 100;
+	static const char *names[] = { "loop", "serial jobs", "parallel for", "job chains" };
+	AnimClip clip;
+	SkinMesh mesh;
+	BenchCrowd crowd;
+	JobSystem jobs;
+	double loop = 0.0, time;
+	float reference = 0.0f, checksum;
+	int i, method, ok = 1;
+
+	if (count < 1 || bones < 2 || bones > SKIN_MAX_BONES || vertices < 1 || frames < 1 ||
+		count > JOB_POOL_SIZE / 4)
+	{
+		fprintf(stderr, "Usage: jobs [characters <= %d] [bones] [vertices] [frames]\n", JOB_POOL_SIZE / 4);
+		return EXIT_FAILURE;
+	}
+
+	srand(1);
+	benchBuildClip(&clip, bones, 8);
+	benchBuildMesh(&mesh, vertices, bones);
+
+	crowd.characters = new BenchCharacter[count];
+	crowd.clip = &clip;
+	for (i = 0; i < count; i++)
+		buildCharacter(&crowd.characters[i], &clip, mesh.GetStream(), bones);
+
+	printf("%d characters, %d bones, %d vertices, %d frames, %d processors (ms per frame)\n",
+		count, bones, vertices, frames, Thread::GetProcessorCount());
+
+	for (method = 0; method < 4; method++)
+	{
+		/* The serial job system runs the parallel for on the calling thread */
+		if (!jobs.Start(method == 1 ? 0 : -1))
+		{
+			fprintf(stderr, "jobs: can't start the worker threads\n");
+			ok = 0;
+			break;
+		}
+
+		time = runMethod(method == 0 ? 0 : (method == 3 ? 2 : 1), &jobs, &crowd, count, frames, &checksum);
+		if (method == 0)
+		{
+			loop = time;
+			reference = checksum;
+		}
+		else if (checksum != reference)
+			ok = 0;
+
+		printf("%-14s %3d threads %10.3f %7.2fx\n", names[method],
+			method == 0 ? 1 : jobs.GetWorkerCount(), time, loop / time);
+	}
+
+	if (!ok)
+		fprintf(stderr, "jobs: the results differ\n");
+
+	jobs.Stop();
+	delete[] crowd.characters;
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <AnimClip.h>
+#include <Timer.h>
+
+#include "Bench.h"
+
+/* Compares the ways to find the keyframe interval for a playing clip:
+* a linear scan from the first key (what boneAnimate used to do), a binary
+* search per sample and the per instance cursor. The clip is played
+* forward with a few samples per key and loops at the end, so the cursor
+* also pays for the binary search fallback once per loop.
+*/
+
+#define SAMPLES_PER_KEY	4
+
+/* Last key with times[i] <= time, scanning from the start */
+static int findKeyLinear(const float *times, int count, float time)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		if (times[i] > time)
+			break;
+
+	return i - 1;
+}
+
+/* Nanoseconds per sample for one lookup method (0 linear, 1 binary, 2 cursor) */
+static double runMethod(int method, const float *times, const float *values, int count, int samples, float step)
+{
+	int i, key, cursor = -1;
+	float time = 0.0f, end = times[count - 1], sum = 0.0f;
+	Timer timer;
+
+	for (i = 0; i < samples; i++)
+	{
+		if (method == 0)
+			key = findKeyLinear(times, count, time);
+		else if (method == 1)
+			key = AnimFindKey(times, count, time);
+		else
+			key = AnimFindKeyCursor(times, count, time, cursor);
+
+		sum += AnimInterpolate(times, values, count, key, time);
+
+		/* Loop the clip */
+		time += step;
+		if (time > end)
+			time = 0.0f;
+	}
+
+	benchSink = sum;
+
+	return timer.GetElapsed() * 1e9 / samples;
+}
+
+int benchSampling(int argc, char **argv)
+{
+	static const int keyCounts[] = { 10, 100, 1000, 10000, 100000 };
+
+	int i, k, count, samples, linearSamples;
+	float *times, *values, step, linearStep;
+
+	(void)argc;
+	(void)argv;
+
+	printf("%8s %14s %14s %14s   (ns per sample)\n", "keys", "linear", "binary", "cursor");
+
+	for (k = 0; k < (int)(sizeof(keyCounts) / sizeof(keyCounts[0])); k++)
+	{
+		count = keyCounts[k];
+		times = new float[count];
+		values = new float[count];
+
+		for (i = 0; i < count; i++)
+		{
+			times[i] = (float)i;
+			values[i] = (float)(rand() % 1000) / 100.0f;
+		}
+
+		/* The linear scan is O(keys), so give it fewer samples on long clips;
+		* they are spread over the whole clip so the average scan length is the same
+		*/
+		samples = 4000000;
+		step = 1.0f / SAMPLES_PER_KEY;
+		linearSamples = samples / (count / 10 + 1) + 1000;
+		linearStep = times[count - 1] / linearSamples;
+		if (linearStep < step)
+			linearStep = step;
+
+		printf("%8d %14.2f %14.2f %14.2f\n", count,
+			runMethod(0, times, values, count, linearSamples, linearStep),
+			runMethod(1, times, values, count, samples, step),
+			runMethod(2, times, values, count, samples, step));
+
+		delete[] times;
+		delete[] values;
+	}
+
+	return EXIT_SUCCESS;
+}
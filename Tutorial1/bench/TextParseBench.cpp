@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <MemoryFile.h>
+#include <TextReader.h>
+#include <SkeletonTextParser.h>
+#include <Thread.h>
+#include <Timer.h>
+
+#include "Bench.h"
+
+/* Parses a skeleton text file in the human.txt format with about a
+* million keyframes, the way boneLoadStructure used to (a character at
+* a time through File::Read, sscanf and strtok) and with TextReader and
+* the StringView number parsers. Both read from a MemoryFile, like a
+* mapped file, so only the parsing is measured. Then the parallel
+* SkeletonTextParser, which also builds the skeleton and the clip, runs
+* with 1 to 8 threads:
+*	Benchmarks textparse [bones] [keys per bone]
+*/
+
+/* Builds the text; each bone line carries all its keyframes */
+static char *makeText(int bones, int keys, size_t *size)
+{
+	size_t capacity = (size_t)bones * (keys * 32 + 128), length = 0;
+	char *text = new char[capacity];
+	int b, k, d;
+
+	for (b = 0; b < bones; b++)
+	{
+		for (d = 0; d <= (b ? 1 + b % 4 : 0); d++)
+			text[length++] = '#';
+		length += sprintf(text + length, " 0.0000 0.0000 %.4f %.4f %d Bone%d",
+			(rand() % 6283) / 1000.0f, 10.0f + rand() % 40, b % 3, b);
+
+		for (k = 0; k < keys; k++)
+			length += sprintf(text + length, " %d %.4f %.4f", k * 2,
+				(rand() % 6283) / 1000.0f - 3.1416f, 40.0f + (rand() % 10000) / 1000.0f);
+		text[length++] = '\n';
+	}
+
+	*size = length;
+	return text;
+}
+
+/* The old fgets replacement: one File::Read call per character */
+static char *fileGets(char *buffer, int size, File *file)
+{
+	int i;
+
+	for (i = 0; i < size - 1 && file->Read(&buffer[i], 1, 1) == 1; )
+		if (buffer[i++] == '\n')
+			break;
+
+	buffer[i] = '\0';
+
+	return i ? buffer : NULL;
+}
+
+/* Old loader: returns the sum of all the values, to compare the results */
+static double parseOld(const char *text, size_t size, size_t lineSize, int *keyCount)
+{
+	MemoryFile file(text, size);
+	char *buffer = new char[lineSize], *animBuf = new char[lineSize], *ptr, *token;
+	char depthStr[20], name[20];
+	float x, y, angle, length;
+	int flags, time;
+	double sum = 0.0;
+
+	*keyCount = 0;
+	while (fileGets(buffer, (int)lineSize, &file))
+	{
+		animBuf[0] = '\0';
+		sscanf(buffer, "%s %f %f %f %f %d %s %[^\n]", depthStr, &x, &y,
+			&angle, &length, &flags, name, animBuf);
+		sum += angle + length;
+
+		ptr = animBuf;
+		while ((token = strtok(ptr, " ")))
+		{
+			ptr = NULL;
+			sscanf(token, "%d", &time);
+			token = strtok(ptr, " ");
+			sscanf(token, "%f", &angle);
+			token = strtok(ptr, " ");
+			sscanf(token, "%f", &length);
+
+			sum += time + angle + length;
+			(*keyCount)++;
+		}
+	}
+
+	delete[] buffer;
+	delete[] animBuf;
+
+	return sum;
+}
+
+/* New loader, as in boneLoadStructure */
+static double parseNew(const char *text, size_t size, int *keyCount)
+{
+	MemoryFile file(text, size);
+	TextReader reader(&file);
+	StringView line, token;
+	float x, y, angle, length;
+	int flags, time;
+	double sum = 0.0;
+
+	*keyCount = 0;
+	while (reader.NextLine(line))
+	{
+		if (!line.NextToken(token))
+			continue;
+
+		line.NextToken(token); token.ParseFloat(x);
+		line.NextToken(token); token.ParseFloat(y);
+		line.NextToken(token); token.ParseFloat(angle);
+		line.NextToken(token); token.ParseFloat(length);
+		line.NextToken(token); token.ParseInt(flags);
+		line.NextToken(token);
+		sum += angle + length;
+
+		while (line.NextToken(token))
+		{
+			token.ParseInt(time);
+			line.NextToken(token); token.ParseFloat(angle);
+			line.NextToken(token); token.ParseFloat(length);
+
+			sum += time + angle + length;
+			(*keyCount)++;
+		}
+	}
+
+	return sum;
+}
+
+int benchTextParse(int argc, char **argv)
+{
+	static const int threadCounts[] = { 1, 2, 4, 8 };
+
+	int i, bones = 20, keys = 50000, oldKeys, newKeys, result = EXIT_SUCCESS;
+	size_t size;
+	char *text;
+	double oldSum, newSum, oldTime, newTime, time;
+	Timer timer;
+	SkeletonTextParser parser;
+	Skeleton skeleton;
+	AnimClip clip;
+
+	if (argc > 0)
+		bones = atoi(argv[0]);
+	if (argc > 1)
+		keys = atoi(argv[1]);
+	if (bones < 1 || keys < 1)
+	{
+		fprintf(stderr, "Usage: textparse [bones] [keys per bone]\n");
+		return EXIT_FAILURE;
+	}
+
+	text = makeText(bones, keys, &size);
+	printf("%d bones, %d keyframes, %.1f MB of text\n", bones, bones * keys, size / (1024.0 * 1024.0));
+
+	/* The old loader needs a line buffer as long as the longest line */
+	timer.Reset();
+	oldSum = parseOld(text, size, size + 1, &oldKeys);
+	oldTime = timer.GetElapsed();
+
+	timer.Reset();
+	newSum = parseNew(text, size, &newKeys);
+	newTime = timer.GetElapsed();
+
+	printf("%-22s %10s %10s\n", "", "ms", "MB/s");
+	printf("%-22s %10.1f %10.1f\n", "fileGets+sscanf+strtok", oldTime * 1e3, size / oldTime / (1024.0 * 1024.0));
+	printf("%-22s %10.1f %10.1f\n", "TextReader+StringView", newTime * 1e3, size / newTime / (1024.0 * 1024.0));
+
+	for (i = 0; i < (int)(sizeof(threadCounts) / sizeof(threadCounts[0])); i++)
+	{
+		timer.Reset();
+		if (!parser.Parse(text, size, skeleton, clip, threadCounts[i]) || (int)parser.GetKeyCount() != newKeys)
+		{
+			fprintf(stderr, "SkeletonTextParser failed: %s at line %d\n", parser.GetError(), parser.GetErrorLine());
+			result = EXIT_FAILURE;
+			break;
+		}
+		time = timer.GetElapsed();
+
+		printf("SkeletonTextParser x%-3d %10.1f %10.1f\n", threadCounts[i], time * 1e3, size / time / (1024.0 * 1024.0));
+	}
+
+	printf("speedup %.1fx (%d processors)\n", oldTime / newTime, Thread::GetProcessorCount());
+
+	benchSink = (float)(oldSum + newSum);
+	delete[] text;
+
+	if (oldKeys != newKeys || oldSum != newSum)
+	{
+		fprintf(stderr, "Parsers disagree: %d keys (sum %f) vs %d keys (sum %f)\n", oldKeys, oldSum, newKeys, newSum);
+		return EXIT_FAILURE;
+	}
+
+	return result;
+}
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include Affine2.h
+ */
+#include "../src/math/Affine2.h"
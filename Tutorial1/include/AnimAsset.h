@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include AnimAsset.h
+ */
+#include "../src/anim/AnimAsset.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include AnimClip.h
+ */
+#include "../src/anim/AnimClip.h"
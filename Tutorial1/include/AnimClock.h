@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include AnimClock.h
+ */
+#include "../src/anim/AnimClock.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include Arena.h
+ */
+#include "../src/common/Arena.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include AsyncIO.h
+ */
+#include "../src/io/intf/AsyncIO.h"
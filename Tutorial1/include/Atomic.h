@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include Atomic.h
+ */
+#include "../src/common/Atomic.h"
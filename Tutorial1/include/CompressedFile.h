@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include CompressedFile.h
+ */
+#include "../src/io/impl/CompressedFile.h"
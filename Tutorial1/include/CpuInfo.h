@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include CpuInfo.h
+ */
+#include "../src/common/CpuInfo.h"
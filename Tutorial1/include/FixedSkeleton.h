@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include FixedSkeleton.h
+ */
+#include "../src/anim/FixedSkeleton.h"
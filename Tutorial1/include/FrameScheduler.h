@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include FrameScheduler.h
+ */
+#include "../src/common/FrameScheduler.h"
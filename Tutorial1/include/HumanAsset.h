@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include HumanAsset.h
+ */
+#include "../src/assets/HumanAsset.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include JobSystem.h
+ */
+#include "../src/common/JobSystem.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include MappedFile.h
+ */
+#include "../src/io/impl/MappedFile.h"
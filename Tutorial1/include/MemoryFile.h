@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include MemoryFile.h
+ */
+#include "../src/io/impl/MemoryFile.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include MeshTextParser.h
+ */
+#include "../src/anim/MeshTextParser.h"
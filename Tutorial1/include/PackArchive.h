@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include PackArchive.h
+ */
+#include "../src/io/impl/PackArchive.h"
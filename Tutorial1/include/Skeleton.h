@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include Skeleton.h
+ */
+#include "../src/anim/Skeleton.h"
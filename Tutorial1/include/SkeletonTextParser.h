@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include SkeletonTextParser.h
+ */
+#include "../src/anim/SkeletonTextParser.h"
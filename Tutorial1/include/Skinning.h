@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include Skinning.h
+ */
+#include "../src/anim/Skinning.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include StringView.h
+ */
+#include "../src/common/StringView.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include TaskGraph.h
+ */
+#include "../src/common/TaskGraph.h"
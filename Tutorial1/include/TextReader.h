@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include TextReader.h
+ */
+#include "../src/io/impl/TextReader.h"
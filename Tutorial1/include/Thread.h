@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include Thread.h
+ */
+#include "../src/common/Thread.h"
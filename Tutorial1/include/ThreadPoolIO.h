@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include ThreadPoolIO.h
+ */
+#include "../src/io/impl/ThreadPoolIO.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include Timer.h
+ */
+#include "../src/common/Timer.h"
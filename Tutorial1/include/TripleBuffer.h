@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include TripleBuffer.h
+ */
+#include "../src/common/TripleBuffer.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include Types.h
+ */
+#include "../src/common/Types.h"
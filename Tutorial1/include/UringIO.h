@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include UringIO.h
+ */
+#include "../src/io/impl/UringIO.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include Vec2.h
+ */
+#include "../src/math/Vec2.h"
@@ -0,0 +1,4 @@
+/**
+ * Header generic pentru a include VirtualFileSystem.h
+ */
+#include "../src/io/impl/VirtualFileSystem.h"
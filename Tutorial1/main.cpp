@@ -1,4 +1,5 @@
 #include <LocalFile.h>
+#include <VirtualFileSystem.h>
 #include <CgProgram.h>
 
 static int mainWindow;
@@ -12,636 +13,761 @@ static CgProgram cgProgram;
 #define _USE_MATH_DEFINES   /* Needed in order to be able to access M_PI constants from math.h */
 #include <math.h>
 
+#include <Types.h>
+#include <Affine2.h>
+#include <Skeleton.h>
+#include <Skinning.h>
+#include <AnimClip.h>
+#include <AnimAsset.h>
+#include <AnimClock.h>
+#include <HumanAsset.h>
+#include <FixedSkeleton.h>
+#include <SkeletonTextParser.h>
+#include <MeshTextParser.h>
+#include <Thread.h>
+#include <JobSystem.h>
+#include <TaskGraph.h>
+#include <TripleBuffer.h>
+#include <Timer.h>
+#include <FrameScheduler.h>
+
 /* C code, made for tabs of 8 spaces
 * uint8_t is defined in the standard C header stdint.h
 */
 
 /* Define numbers and flags */
-#define MAX_CHCOUNT			8	/* Max children count */
 #define BONE_ABSOLUTE_ANGLE		0x01	/* Bone angle is absolute or relative to parent */
 #define BONE_ABSOLUTE_POSITION		0x02	/* Bone position is absolute in the world or relative to the parent */
 #define BONE_ABSOLUTE			(BONE_ABSOLUTE_ANGLE | BONE_ABSOLUTE_POSITION)
 #define MAX_BONECOUNT			20
-#define MAX_KFCOUNT				30
 #define MAX_FRAMES				160
-#define MAX_VXCOUNT				4
-#define MAX_MESHVXCOUNT			(MAX_VXCOUNT * MAX_BONECOUNT)
-
+#define MAX_CROWD				1000
+#define ANIM_TICK				(1.0 / 60.0)	/* Seconds between animation ticks, the loaded character's step */
+#define ANIM_FRAME_RATE			60.0		/* Clip frames per second of animation time */
+#define ROOT_SPEED				60.0		/* Walking speed, in units per second of animation time */
 
 
-typedef unsigned char uint8_t;
-typedef unsigned long int uint32_t;
 
 #define RAD2DEG (180.0/M_PI)
 
-typedef struct
-{
-	float x,	/* Coords */
-		y,
-		r,	/* Colors or texture infos */
-		g,
-		b;
-} Vertex;
+SkinMesh body;				/* The body mesh, packed for the skinning kernel */
+
+Skeleton skeleton;			/* Flattened skeleton, parents before children */
+AnimClip clip;				/* Animation loaded with the skeleton */
+AnimCursor cursor;			/* Playback state of the skeleton in the clip */
+AnimAsset asset;			/* Binary asset the clip and mesh are used from */
+VirtualFileSystem vfs;			/* Asset packs and directories, searched in order */
+Arena characterArena;			/* Memory of the skeleton, clip and mesh, freed at once */
+JobSystem jobs;				/* Spreads the characters' animation over all the cores */
 
+/* What is drawn for one bone, already in world coordinates */
 typedef struct
 {
-	uint32_t time;
-	float angle, length;
-} Keyframe;
-
-typedef struct _Bone
+	Vec2 quad[4];
+	Vec2 line[2];
+	float lineColor[2][3];
+	Vec2 joint[6];
+	int jointCount;
+} BoneDrawItem;
+
+/* A character as published for drawing: its last two simulated poses,
+* drawn interpolated between them
+*/
+typedef struct
 {
-	char name[20];				/* Just for the sake of the example */
-	float x,				/* Starting point x */
-		y,				/* Starting point y */
-		a,				/* Angle, in radians */
-		l,				/* Length of the bone */
-		offA,			/* Offsets measures for angle and length */
-		offL;
-
-	uint8_t flags;				/* Bone flags, 8 bits should be sufficient for now */
-	uint8_t childCount;			/* Number of children */
-
-	struct _Bone *child[MAX_CHCOUNT],	/* Pointers to children */
-		*parent;			/* Parent bone */
-	uint32_t keyframeCount;	/* Number of keyframes */
-	Keyframe keyframe[MAX_KFCOUNT];	/* Animation for this bone */
-
-	uint32_t vertexCount;
-	Vertex vertex[MAX_VXCOUNT];
-} Bone;
-
+	BoneDrawItem *drawList;		/* The previous pose, then the current one */
+	double due;			/* When the current pose was due, in Timer seconds */
+	double step;			/* Seconds from the previous pose to the current one */
+} CharacterView;
+
+/* An animated character. The first one is the loaded character, the others
+* are the crowd (-n); they share the clip and the mesh influences, but
+* every one has its own pose, clock and draw lists
+*/
 typedef struct
 {
-	Vertex v;			/* Info on this vertex: position color etc */
-	int boneCount;			/* Number of bones this vertex is connected to*/
-	float weight[MAX_BONECOUNT];	/* Weight for each bone connected */
-	Bone *bone[MAX_BONECOUNT];	/* Pointer to connected bones */
-} BoneVertex;
-
+	Skeleton *skeleton;
+	AnimCursor *cursor;
+	SkinMesh *mesh;
+	AnimClock clock;		/* Simulation step and playback speed */
+	int steps;			/* Steps the clock took in this tick; 0 skips the character */
+	int snap;			/* Jumped: don't interpolate from the previous pose */
+	int frameOffset;		/* Where in the clip the character is */
+	int rootMotion;			/* Walks across the window */
+	float blendWeight;		/* How much of the second layer is blended in */
+	Pose layer;			/* Second layer: the clip half a cycle later */
+	CharacterView view[3];		/* One per slot of the pose exchange */
+} Character;
+
+/* What a launched frame computes */
 typedef struct
 {
-	int vertexCount;		/* Number of vertexes in this mesh */
-	BoneVertex v[MAX_MESHVXCOUNT];	/* Vertices of the mesh */
-} Mesh;
-
-Mesh body;
-Bone *root;
+	double time;			/* When the tick started, in Timer seconds */
+	int animate;			/* Sample the clip, or keep the edited pose */
+	float rootX;			/* Root position of the walking characters */
+	int drawList;			/* Slot of the pose exchange the draw lists are built in */
+	int previous;			/* Slot published by the last tick, or -1 */
+} FrameParams;
+
+Character *characters = NULL;
+int characterCount = 0;
+
+/* sample -> blend -> FK -> skin -> draw lists, run for every frame */
+TaskGraph frameGraph(jobs);
+FrameParams frameParams;
+float rootX = 0.0f;
+
+/* The animation runs on its own thread at a fixed tick and publishes the
+* draw lists through the pose exchange; the display draws the newest ones
+* without waiting. The input handlers hold animationLock while they change
+* what the animation reads, and wake the thread with animationChanged;
+* stopped and unchanged, the thread sleeps on animationWake
+*/
+TripleBuffer poseExchange;
+int publishedSlot = -1;			/* Slot published by the last tick */
+double animationTime = 0.0;		/* When the last tick started */
+int crowdRate = 20;			/* Steps per second of the crowd's clocks */
+Thread animationThread;
+Mutex animationLock;
+Condition animationWake;
+int animationDirty = 0;			/* The input changed the pose or the selection */
+AtomicInt animationRunning;
+
+/* Frames are drawn only when something changed, at most 60 per second */
+FrameScheduler frameScheduler(60.0);
 
 char *currentName = NULL;
 int nameIndex = 0;
 char names[MAX_BONECOUNT][20];
 int animating = 0;
-int frameNum = 0;
+int fixedTopology = 0;			/* The skeleton has the built-in character's hierarchy */
 
-/* Create a bone and return it's address */
-Bone *boneAddChild(Bone *root, float x, float y, float a, float l, unsigned int flags, char *name)
+/* Dump on stdout the skeleton and its animation, in the same format used by boneLoadStructure */
+void skeletonDump(const Skeleton *skel, const AnimClip *anim)
 {
-	Bone *t;
-	int i;
-	
-	if (!root) /* If there is no root, create one */
-	{
-		if (!(root = (Bone *)malloc(sizeof(Bone))))
-			return NULL;
-		root->parent = NULL;
-	}
-	else if (root->childCount < MAX_CHCOUNT) /* If there is space for another child */
-	{
-		/* Allocate the child */
-		if (!(t = (Bone *)malloc(sizeof(Bone))))
-			return NULL; /* Error! */
-
-		t->parent = root; /* Set it's parent */
-		root->child[root->childCount++] = t; /* Increment the childCounter and set the pointer */
-		root = t; /* Change the root */
-	}
-	else /* Can't add a child */
-		return NULL;
-
-	/* Set data */
-	root->x = x;
-	root->y = y;
-	root->a = a;
-	root->l = l;
-	root->flags = flags;
-	root->childCount = 0;
-	root->keyframeCount = 0;
-	root->offA = 0;
-	root->offL = 0;
-	root->vertexCount = 4;
-	
-	if (name)
-		strcpy(root->name, name);
-	else
-		strcpy(root->name, "Bone");
+	int i, b, ca, cl;
+	float time;
 
-	for (i = 0; i < MAX_CHCOUNT; i++)
-		root->child[i] = NULL;
-
-	return root;
+	for (b = 0; b < skel->GetBoneCount(); b++)
+	{
+		/* We print # to signal the level of this bone. Root has level 1 */
+		printf("#");
+		for (i = skel->GetParent(b); i >= 0; i = skel->GetParent(i))
+			printf("#");
+
+		printf(" %4.4f %4.4f %4.4f %4.4f %d %s\n", skel->GetX()[b], skel->GetY()[b],
+			skel->GetAngles()[b], skel->GetLengths()[b], skel->GetFlags(b), skel->GetName(b));
+
+		/* Now print animation info; the loader always creates both channels.
+		* Constant and linear channels keep no keys, so they are sampled */
+		ca = anim->FindChannel(b, ANIM_TARGET_ANGLE);
+		cl = anim->FindChannel(b, ANIM_TARGET_LENGTH);
+		if (ca >= 0 && cl >= 0)
+			for (i = 0; i < anim->GetKeyCount(ca); i++)
+			{
+				time = anim->GetKeyTimes(ca)[i];
+				printf(" %d %4.4f %4.4f", (int)time,
+					anim->SampleChannel(ca, time), anim->SampleChannel(cl, time));
+			}
+		printf("\n");
+	}
 }
 
-/* Free the bones */
-Bone *boneFreeTree(Bone *root)
+/* Load the skeleton and its animation from a text file. The file is
+* parsed in place, with the keyframes split among all the processors
+*/
+int skeletonLoad(char *path, Skeleton *skel, AnimClip *anim)
 {
-	int i;
+	SkeletonTextParser parser;
+	MemoryFile *file;
+	int ok;
 
-	if (!root)
-		return NULL;
+	if (!(file = vfs.OpenMapped(path)))
+	{
+		fprintf(stderr, "Can't open file %s for reading\n", path);
+		return 0;
+	}
 
-	/* Recursively call this function to free subtrees */
-	for (i = 0; i < root->childCount; i++)
-		boneFreeTree(root->child[i]);
+	ok = parser.Parse((const char *)file->GetData(), file->GetLength(), *skel, *anim,
+		Thread::GetProcessorCount());
+	if (!ok)
+		fprintf(stderr, "%s:%d: %s\n", path, parser.GetErrorLine(), parser.GetError());
 
-	free(root);
+	delete file;
 
-	return NULL;
+	return ok;
 }
 
-/* Dump on stdout the bone structure. Root of the tree should have level 1 */
-void boneDumpTree(Bone *root, uint8_t level)
+void meshDraw(SkinMesh *skin, const Skeleton *skel)
 {
-	uint32_t i;
+	int i, n;
 
-	if (!root)
-		return;
+	const float *x, *y;
 
-	for (i = 0; i < level; i++)
-		printf("#"); /* We print # to signal the level of this bone. */
+	n = skin->GetVertexCount();
 
-	printf(" %4.4f %4.4f %4.4f %4.4f %d %s\n", root->x, root->y, root->a, root->l, root->flags, root->name);
+	glPointSize(3.0);
 
-	/* Now print animation info */
-	for (i = 0; i < root->keyframeCount; i++)
-		printf(" %d %4.4f %4.4f", root->keyframe[i].time, root->keyframe[i].angle, root->keyframe[i].length);
-	printf("\n");
+	/* Skinned by the frame graph */
+	x = skin->GetSkinnedX();
+	y = skin->GetSkinnedY();
 
-	/* Recursively call this on my children */
-	for (i = 0; i < root->childCount; i++)
-		boneDumpTree(root->child[i], level + 1);
-}
+	/* Draw loop */
+	glPushAttrib(GL_ALL_ATTRIB_BITS);
 
-void getBoneParentMatrix(Bone *b)
-{
-	if (!b)
-		return;
+	glBegin(GL_POINTS);
+	for (i = 0; i < n; i++)
+		glVertex2f(x[i], y[i]);
+	glEnd();
 
-	if (b->parent)
-	{
-		getBoneParentMatrix(b->parent);
-		glTranslatef(b->parent->l, 0.0, 0.0);
-	}
+	glPopAttrib();
 
-	glTranslatef(b->x, b->y, 0.0); /* For a connected stucture, this is usually 0, 0, 0 */
-	glRotatef(RAD2DEG*(b->a), 0.0, 0.0, 1.0);
 }
 
-Bone *boneLoadStructure(char *path)
+/* Get the joint polygon between bone b and its children, in world coords */
+int boneGetJoints(const Skeleton *skel, int b, Vec2 *v)
 {
-	Bone *root,		/* The root of the tree to load */
-		*temp;		/* A temporary root */
-
-	FILE *file;		/* File to load */
-
-	float x,		/* Bone data */
-		y,
-		angle,
-		length;
-
-	int depth,		/* Depth retrieved from file */
-		actualLevel,	/* Actual depth level */
-		flags;		/* Bone flags */
-		//count;
+	int i, c,
+		cnt = 0;
 
-	uint32_t time;
+	const Affine2 *m;
+	float l;
 
-	char name[20],		/* Buffers for strings */
-		depthStr[20],
-		animBuf[1024],
-		buffer[512],
-		*ptr,
-		*token;
+	if (!skel || !v || skel->GetFirstChild(b) < 0)
+		return 0;
 
-	Keyframe *k;
+	/* We are creating a joint between this bone b and its children
+	* so get its ending vertexes
+	*/
+	l = skel->GetLengths()[b];
+	m = &skel->GetWorld(b);
+	v[0] = m->TransformPoint(Vec2(l, -5.0));
+	v[1] = m->TransformPoint(Vec2(l, 5.0));
+	cnt = 2;
 
-	if (!(file = fopen(path, "r")))
+	/* Now get first 2 vertex for each children */
+	for (i = 0, c = skel->GetFirstChild(b); c >= 0; i++, c = skel->GetNextSibling(c))
 	{
-		fprintf(stderr, "Can't open file %s for reading\n", path);
-		return NULL;
-	}
+		if (i % 2)
+			continue;
 
-	root = NULL;
-	temp = NULL;
-	actualLevel = 0;
+		/* Transform the vertices with the child's world transform */
+		m = &skel->GetWorld(c);
+		v[cnt++] = m->TransformPoint(Vec2(0.0, 5.0));
+		v[cnt++] = m->TransformPoint(Vec2(0.0, -5.0));
+	}
 
-	while (!feof(file))
-	{
-		memset(animBuf, 0, 1024);
+	return cnt;
+}
 
-		/* Read a row from the file (I hope that 1024 characters are sufficient for a row) */
-		fgets(buffer, 1024, file);
+/* Is this bone drawn in red whatever its selection */
+int boneIsRight(const char *name)
+{
+	return !strcmp(name, "RLeg") || !strcmp(name, "RLeg2") ||
+		!strcmp(name, "RArm") || !strcmp(name, "RArm2");
+}
 
-		/* Get the info about this bone*/
-		sscanf(buffer, "%s %f %f %f %f %d %s %[^\n]", depthStr, &x, &y,
-			&angle, &length, &flags, name, animBuf);
+static void setColor(float *color, float r, float g, float b)
+{
+	color[0] = r;
+	color[1] = g;
+	color[2] = b;
+}
 
-		/* Avoid empty strings, but this is ineffective for invalid strings */
-		if (strlen(buffer) < 3)
-			continue;
+/* Build what boneDraw draws for every bone, in world coordinates; this
+* runs in the frame graph, off the render thread
+* TODO: Actually this doesn't handle absolute bones
+*/
+void boneBuildDrawList(const Skeleton *skel, BoneDrawItem *items)
+{
+	int j, selected;
+	const Affine2 *m;
+	BoneDrawItem *item;
+	const char *name;
+	float l;
 
-		/* Calculate the depth */
-		depth = strlen(depthStr) - 1;
-		if (depth < 0 || depth > MAX_CHCOUNT)
+	for (j = 0; j < skel->GetBoneCount(); j++)
+	{
+		item = &items[j];
+		name = skel->GetName(j);
+		l = skel->GetLengths()[j];
+		m = &skel->GetWorld(j);
+		selected = !strcmp(name, currentName);
+
+		/* The quad and the line along the bone */
+		item->quad[0] = m->TransformPoint(Vec2(0.0, 5.0));
+		item->quad[1] = m->TransformPoint(Vec2(0.0, -5.0));
+		item->quad[2] = m->TransformPoint(Vec2(l, -5.0));
+		item->quad[3] = m->TransformPoint(Vec2(l, 5.0));
+		item->line[0] = m->TransformPoint(Vec2(0.0, 0.0));
+		item->line[1] = m->TransformPoint(Vec2(l, 0.0));
+
+		if (boneIsRight(name))
 		{
-			fclose(file);
-			fprintf(stderr, "Wrong bone depth (%s)\n", depthStr);
-			return NULL;
+			setColor(item->lineColor[0], 1.0, 0.0, 0.0);
+			setColor(item->lineColor[1], 1.0, 0.0, 0.0);
 		}
-
-		/* If actual level is too high, go down */
-		for (; actualLevel > depth; actualLevel--)
-			temp = temp->parent;
-
-		/* If no root is defined, make one at level 0 */
-		if (!root && !depth)
+		else if (selected)
 		{
-			root = boneAddChild(NULL, x, y, angle, length, flags, name);
-			temp = root;
+			setColor(item->lineColor[0], 0.0, 0.0, 1.0);
+			setColor(item->lineColor[1], 1.0, 1.0, 0.0);
 		}
 		else
-			temp = boneAddChild(temp, x, y, angle, length, flags, name);
-
-		/* Now check for animation data */
-		if (strlen(animBuf) > 3)
 		{
-			ptr = animBuf;
-			while ((token = strtok(ptr, " ")))
-			{
-				ptr = NULL;
-				sscanf(token, "%d", &time);
-
-				token = strtok(ptr, " ");
-				sscanf(token, "%f", &angle);
-
-				token = strtok(ptr, " ");
-				sscanf(token, "%f", &length);
-
-				printf("Read %d %f %f\n", time, angle, length);
-
-				if (temp->keyframeCount >= MAX_KFCOUNT)
-				{
-					fprintf(stderr, "Can't add more keyframes\n");
-					continue;
-				}
-
-				k = &(temp->keyframe[temp->keyframeCount]);
-
-				k->time = time;
-				k->angle = angle;
-				k->length = length;
-
-				temp->keyframeCount++;
-			}
+			setColor(item->lineColor[0], 1.0, 0.0, 0.0);
+			setColor(item->lineColor[1], 0.0, 1.0, 0.0);
 		}
 
-		
-		/* Since the boneAddChild returns child's address, we go up a level in the hierarchy */
-		actualLevel++;
+		/* Get joint vertexes, these are already in world coords */
+		item->jointCount = boneGetJoints(skel, j, item->joint);
 	}
+}
 
-	fclose(file);
-
-	return root;
+/* Emit a vertex between a and b */
+static void lerpVertex(const Vec2 &a, const Vec2 &b, float t)
+{
+	glVertex2f(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t);
 }
 
-void getBoneMatrix(Bone *b, float m[16])
+/* Draw the bones of one character between two of its draw lists, alpha
+* of the way from prev to items; both have the same bones
+*/
+void boneDraw(const BoneDrawItem *prev, const BoneDrawItem *items, float alpha, int count)
 {
-	if (!b)
-		return;
+	int i, j;
 
-	glPushMatrix();
-	glLoadIdentity();
+	glBegin(GL_QUADS);
+	glColor3f(200 / 256.0, 100 / 256.0, 50 / 256.0);
+	for (j = 0; j < count; j++)
+		for (i = 0; i < 4; i++)
+			lerpVertex(prev[j].quad[i], items[j].quad[i], alpha);
+	glEnd();
 
-	if (b->parent)
+	glBegin(GL_LINES);
+	for (j = 0; j < count; j++)
+		for (i = 0; i < 2; i++)
+		{
+			glColor3fv(items[j].lineColor[i]);
+			lerpVertex(prev[j].line[i], items[j].line[i], alpha);
+		}
+	glEnd();
+
+	/* Draw the joints */
+	glColor3f(0.0, 0.0, 1.0);
+	for (j = 0; j < count; j++)
 	{
-		getBoneParentMatrix(b->parent);
-		glTranslatef(b->parent->l, 0.0, 0.0);
-	}
+		if (!items[j].jointCount)
+			continue;
 
-	/* Now we are at the end of parent's bone
-	* rotate for this bone and
-	* get the matrix and
-	* return
-	*/
-	glRotatef(RAD2DEG*(b->a), 0.0, 0.0, 1.0);
-	glGetFloatv(GL_MODELVIEW_MATRIX, m);
+		glBegin(GL_POLYGON);
+		for (i = 0; i < items[j].jointCount; i++)
+			lerpVertex(prev[j].joint[i], items[j].joint[i], alpha);
+		glEnd();
+	}
 
-	glPopMatrix();
+	// stop drawing mesh for now
+	//meshDraw(&body, skel);
 }
 
-float getBoneAngle(Bone *b)
-{
-	if (!b)
-		return 0;
+/* Frame graph stages; each one handles the characters [begin, end) of
+* the frame and only touches their own data
+*/
 
-	return b->a + getBoneAngle(b->parent);
+/* Does the character get a new draw list: it stepped, or it has none to
+* publish again yet
+*/
+static int characterListed(const Character *c, const FrameParams *params)
+{
+	return c->steps || params->previous < 0;
 }
 
-void meshDraw(Mesh *mesh)
+void stageSample(void *data, const void *frame, int begin, int end)
 {
-	int i, j,
-		n;
-
-	float v[MAX_VXCOUNT * MAX_BONECOUNT][2], /* End vertexes */
-		m[16],
-		tmp[4],
-		x, y;
-
-	n = mesh->vertexCount;
-
-	glPointSize(3.0);
+	const FrameParams *params = (const FrameParams *)frame;
+	Character *c;
+	Pose pose;
+	double time;
+	int i;
 
-	tmp[0] = tmp[1] = 0.0;
-	tmp[2] = 1.0;
-	tmp[3] = 1.0; /* w is always 1.0 */
+	if (!params->animate)
+		return;
 
-	/* Processing loop */
-	for (i = 0; i < n; i++)
+	for (i = begin; i < end; i++)
 	{
-		v[i][0] = v[i][1] = 0.0;
-		tmp[0] = mesh->v[i].v.x;
-		tmp[1] = mesh->v[i].v.y;
+		c = &characters[i];
+		if (!c->steps)
+			continue;
 
-		/* Loop thru the relations with each bone */
-		for (j = 0; j < mesh->v[i].boneCount; j++)
-		{
-			glPushMatrix();
-			glLoadIdentity();
+		/* Only the last step is sampled: the clip has no state between frames */
+		time = fmod(c->clock.GetTime() * ANIM_FRAME_RATE + c->frameOffset, MAX_FRAMES);
+		pose = c->skeleton->GetPose();
+		SamplePose(clip, (float)time, pose, *c->cursor);
+		if (c->blendWeight > 0.0f)
+			SamplePose(clip, (float)fmod(time + MAX_FRAMES / 2, MAX_FRAMES), c->layer);
 
-			/* Get the jth bone position */
-			getBoneMatrix(mesh->v[i].bone[j], m);
+		if (c->rootMotion)
+			c->skeleton->GetX()[0] = params->rootX;
+	}
+}
 
-			glTranslatef(m[12], m[13], 0.0);
-			glRotatef(RAD2DEG*(getBoneAngle(mesh->v[i].bone[j])), 0.0, 0.0, 1.0);
+void stageBlend(void *data, const void *frame, int begin, int end)
+{
+	const FrameParams *params = (const FrameParams *)frame;
+	Character *c;
+	Pose pose;
+	int i;
 
-			glGetFloatv(GL_MODELVIEW_MATRIX, m);
-			glPopMatrix();
+	if (!params->animate)
+		return;
 
-			v[i][0] += (tmp[0] * m[0] + tmp[1] * m[4] + m[12]) * mesh->v[i].weight[j];
-			v[i][1] += (tmp[0] * m[1] + tmp[1] * m[5] + m[13]) * mesh->v[i].weight[j];	
+	for (i = begin; i < end; i++)
+	{
+		c = &characters[i];
+		if (c->steps && c->blendWeight > 0.0f)
+		{
+			pose = c->skeleton->GetPose();
+			BlendPose(pose, c->layer, c->blendWeight, pose);
 		}
 	}
-
-	/* Draw loop */
-	glPushAttrib(GL_ALL_ATTRIB_BITS);
-
-	glBegin(GL_POINTS);
-	for (i = 0; i < n; i++)
-		glVertex2f(v[i][0], v[i][1]);
-	glEnd();
-
-	glPopAttrib();
-
 }
 
-int boneGetJoints(Bone *b, Vertex *v)
+void stageForwardKinematics(void *data, const void *frame, int begin, int end)
 {
-	int i ,
-		cnt = 0;
-
-	float m[4 * 4],
-		x0,
-		y0;
-
-	if (!b || !v || !(b->childCount))
-		return 0;
+	const FrameParams *params = (const FrameParams *)frame;
+	Character *c;
+	int i;
 
-	/* We are creating a joint between this bone b and its children
-	* so get its ending vertexes
-	*/
-	v[0] = b->vertex[b->vertexCount - 2];
-	v[1] = b->vertex[b->vertexCount - 1];
-	cnt = 2;
+	for (i = begin; i < end; i++)
+	{
+		c = &characters[i];
+		if (!characterListed(c, params))
+			continue;
 
-	glPushMatrix();
-	glLoadIdentity();
+		/* The built-in hierarchy has its forward kinematics unrolled at compile time */
+		if (fixedTopology)
+			FixedSkeleton<HumanAsset_Topology>::ComputeWorld(*c->skeleton);
+		else
+			c->skeleton->ComputeWorld();
+	}
+}
 
-	/* Translate the vertex for the length of the bone */
-	glTranslatef(b->l, 0.0, 0.0);
+void stageSkin(void *data, const void *frame, int begin, int end)
+{
+	Character *c;
+	int i;
 
-	/* Now get first 2 vertex for each children */
-	for (i = 0; i < b->childCount; i += 2)	
+	for (i = begin; i < end; i++)
 	{
-		v[2 + i] = b->child[i]->vertex[0];
-		v[3 + i] = b->child[i]->vertex[1];
-		cnt += 2;
+		c = &characters[i];
+		if (c->steps && c->mesh->GetVertexCount())
+			c->mesh->Skin(c->skeleton->GetPalette());
+	}
+}
 
-		/* Transform the vertices */
-		glPushMatrix();
-		glRotatef((GLfloat)(RAD2DEG*(b->child[i]->a)), 0.0, 0.0, 1.0);
+/* Build the current pose of the characters that stepped; the others are
+* published again as they were
+*/
+void stageDrawList(void *data, const void *frame, int begin, int end)
+{
+	const FrameParams *params = (const FrameParams *)frame;
+	const CharacterView *last;
+	CharacterView *view;
+	Character *c;
+	int i, n;
 
-		/* Get the current matrix */
-		glGetFloatv(GL_MODELVIEW_MATRIX, m);
+	for (i = begin; i < end; i++)
+	{
+		c = &characters[i];
+		n = c->skeleton->GetBoneCount();
+		view = &c->view[params->drawList];
+		last = params->previous >= 0 ? &c->view[params->previous] : NULL;
 
-		/* Translate the vertexes multiplying the vector with the actual matrix */
-		x0 = v[2 + i].x;
-		y0 = v[2 + i].y;
-		v[2 + i].x = x0 * m[0] + y0 * m[4] + m[12];
-		v[2 + i].y = x0 * m[1] + y0 * m[5] + m[13];
+		if (!characterListed(c, params))
+		{
+			memcpy(view->drawList, last->drawList, 2 * n * sizeof(BoneDrawItem));
+			view->due = last->due;
+			view->step = last->step;
+			continue;
+		}
 
-		x0 = v[3 + i].x;
-		y0 = v[3 + i].y;
-		v[3 + i].x = x0 * m[0] + y0 * m[4] + m[12];
-		v[3 + i].y = x0 * m[1] + y0 * m[5] + m[13];
+		boneBuildDrawList(c->skeleton, view->drawList + n);
+		if (last && !c->snap)
+			memcpy(view->drawList, last->drawList + n, n * sizeof(BoneDrawItem));
+		else
+			memcpy(view->drawList, view->drawList + n, n * sizeof(BoneDrawItem));
+		c->snap = 0;
 
-		glPopMatrix();
+		view->due = params->time - c->clock.GetAlpha() * c->clock.GetStep();
+		view->step = c->clock.GetStep();
 	}
-
-	glPopMatrix();
-
-	return cnt;
 }
 
-void boneGenQuads(Bone *root)
+/* Declare the frame graph. A character goes through its stages in order,
+* independently of the characters in the other chunks
+*/
+void frameGraphCreate()
 {
-	int i;
-
-	if (!root)
-		return;
-
-	root->vertex[0].x = 0.0;
-	root->vertex[0].y = 5.0;
+	int sample, blend, fk, skin, list;
+
+	sample = frameGraph.AddStage("sample", stageSample, NULL);
+	blend = frameGraph.AddStage("blend", stageBlend, NULL);
+	fk = frameGraph.AddStage("fk", stageForwardKinematics, NULL);
+	skin = frameGraph.AddStage("skin", stageSkin, NULL);
+	list = frameGraph.AddStage("drawlist", stageDrawList, NULL);
+
+	frameGraph.AddDependency(blend, sample);
+	frameGraph.AddDependency(fk, blend);
+	frameGraph.AddDependency(skin, fk);
+	frameGraph.AddDependency(list, skin);
+}
 
-	root->vertex[1].x = 0.0;
-	root->vertex[1].y = -5.0;
+/* Launch a frame of the graph for the current animation state */
+int frameLaunch()
+{
+	FrameParams *params = &frameParams;
 
-	root->vertex[2].x = root->l;
-	root->vertex[2].y = -5.0;
+	params->time = animationTime;
+	params->animate = animating;
+	params->rootX = rootX;
+	params->drawList = poseExchange.GetWriteIndex();
+	params->previous = publishedSlot;
 
-	root->vertex[3].x = root->l;
-	root->vertex[3].y = 5.0;
+	return frameGraph.Launch(characterCount, params);
+}
 
-	for (i = 0; i < 4; i++)
-	{
-		root->vertex[i].r = 200 / 256.0;
-		root->vertex[i].g = 100 / 256.0;
-		root->vertex[i].b = 50 / 256.0;
-	}
+/* Print how long each stage of the last frame worked, summed over the threads */
+void frameGraphPrintTimes()
+{
+	int s;
 
-	for (i = 0; i < root->childCount; i++)
-		boneGenQuads(root->child[i]);
+	printf("Frame: %.3f ms for %d characters on %d threads:", frameGraph.GetFrameTime() * 1e3,
+		characterCount, jobs.GetWorkerCount());
+	for (s = 0; s < frameGraph.GetStageCount(); s++)
+		printf(" %s %.3f", frameGraph.GetStageName(s), frameGraph.GetStageTime(s) * 1e3);
+	printf("\n");
 }
 
-void boneAnimate(Bone *root, int time)
+/* Set up the loaded character and crowdSize copies of it, spread over
+* the window and each one at another moment of the clip
+*/
+void charactersCreate(int crowdSize)
 {
-	uint32_t i;
+	int i, b, n = skeleton.GetBoneCount();
+	Skeleton *skel;
+	Character *c;
+	Pose pose;
 
-	float ang,
-		len,
-		tim;
+	characterCount = crowdSize + 1;
+	characters = new Character[characterCount];
 
-	/* Check for keyframes */
-	for (i = 0; i < root->keyframeCount; i++)			
-		if (root->keyframe[i].time == time)
+	for (i = 0; i < characterCount; i++)
+	{
+		c = &characters[i];
+		if (i == 0)
 		{
-			/* Find the index for the interpolation */
-			if (i != root->keyframeCount - 1)
-			{
-				tim = root->keyframe[i + 1].time - root->keyframe[i].time;
-				ang = root->keyframe[i + 1].angle - root->keyframe[i].angle;
-				len = root->keyframe[i + 1].length - root->keyframe[i].length;
-
-				root->offA = ang / tim;
-				root->offL = len / tim;
-			}
-			else
+			c->skeleton = &skeleton;
+			c->cursor = &cursor;
+			c->mesh = &body;
+			c->clock.SetStep(ANIM_TICK);
+			c->frameOffset = 0;
+			c->rootMotion = 1;
+			c->blendWeight = 0.0f;
+		}
+		else
+		{
+			c->skeleton = skel = new Skeleton;
+			c->cursor = new AnimCursor;
+			c->mesh = new SkinMesh;
+			for (b = 0; b < n; b++)
+				skel->AddBone(skeleton.GetParent(b), skeleton.GetX()[b], skeleton.GetY()[b],
+					skeleton.GetAngles()[b], skeleton.GetLengths()[b], skeleton.GetFlags(b), skeleton.GetName(b));
+			if (n)
 			{
-				root->offA = 0;
-				root->offL = 0;
+				skel->GetX()[0] = -150.0f + (i % 20) * 30.0f;
+				skel->GetY()[0] = -150.0f + (i / 20 % 20) * 30.0f;
 			}
+			/* The crowd is simulated less often and each one plays at its own speed */
+			c->clock.SetStep(1.0 / crowdRate);
+			c->clock.SetTimeScale(0.75f + (i % 5) * 0.125f);
+			c->frameOffset = i * 7 % MAX_FRAMES;
+			c->rootMotion = 0;
+			c->blendWeight = (i % 5) * 0.1f;
+
+			c->cursor->Bind(clip);
+			pose = skel->GetPose();
+			ApplyConstantChannels(clip, pose);
+
+			/* The influences are shared, only the skinned positions are per character */
+			if (!body.IsVariable())
+				c->mesh->Attach(body.GetStream());
 		}
 
-	/* Change animation */
-	root->a += root->offA;
-	root->l += root->offL;
+		/* The second layer starts as the bind pose, like the first */
+		pose = c->skeleton->GetPose();
+		c->layer.boneCount = n;
+		c->layer.x = characterArena.CopyArray(pose.x, n);
+		c->layer.y = characterArena.CopyArray(pose.y, n);
+		c->layer.angle = characterArena.CopyArray(pose.angle, n);
+		c->layer.length = characterArena.CopyArray(pose.length, n);
+
+		c->steps = 0;
+		c->snap = 0;
+		for (b = 0; b < 3; b++)
+			c->view[b].drawList = new BoneDrawItem[n ? 2 * n : 1];
+	}
+}
 
-	/* Call on other bones */
-	for (i = 0; i < root->childCount; i++)
-		boneAnimate(root->child[i], time);
+void reshape(int w, int h)
+{
+	glViewport(0, 0, 600, 600);
+	glMatrixMode(GL_PROJECTION);
+	glOrtho(-200, 500, -200, 500, -1, 1);
+	glMatrixMode(GL_MODELVIEW);
 }
 
-/* TODO: Actually this doesn't handle absolute bones */
-void boneDraw(Bone *root)
+/* One animation tick: advance the clocks by the time since the last tick,
+* compute the characters whose clock took a step and publish the draw
+* lists. Called with animationLock held
+*/
+void animationTick()
 {
-	int i, count;
-	Vertex vert[6];
+	double now = Timer::GetSeconds();
+	Character *c;
+	int i;
 
-	glPushMatrix();
+	for (i = 0; i < characterCount; i++)
+	{
+		c = &characters[i];
+		c->steps = animating ? c->clock.Advance(now - animationTime) : 0;
 
-	/* Draw this bone
-	* 1. Translate to coords
-	* 2. Rotate the matrix
-	* 3. Draw the line
-	* 4. Reach the end position (translate again)
-	*/
-	glTranslatef(root->x, root->y, 0.0);
-	glRotatef((GLfloat)(RAD2DEG*(root->a)), 0.0, 0.0, 1.0);
+		/* Stopped, the edited pose is listed at every tick */
+		if ((!animating || publishedSlot < 0) && !c->steps)
+			c->steps = 1;
+	}
 
-	/**** This code draws the quads ****/
-	glBegin(GL_QUADS);
-	for (i = 0; i < 4; i++)
+	c = &characters[0];
+	if (animating && skeleton.GetBoneCount() && c->steps)
 	{
-		glColor3f(root->vertex[i].r, root->vertex[i].g, root->vertex[i].b);
-		glVertex2f(root->vertex[i].x, root->vertex[i].y);
+		// move the skeleton to the right 
+		rootX += c->steps * c->clock.GetStep() * c->clock.GetTimeScale() * ROOT_SPEED;
+		if (rootX > 470)
+		{
+			rootX = -150;
+			c->snap = 1;
+		}
 	}
-	glEnd();
-
-	/* Then draw the bones normally */
-
-	glBegin(GL_LINES);
-
-	if (!strcmp(root->name, currentName))
-		glColor3f(0.0, 0.0, 1.0);
-	else
-		glColor3f(1.0, 0.0, 0.0);
-
-	if(strcmp(root->name, "RLeg") == 0 || strcmp(root->name, "RLeg2") == 0 ||
-		 strcmp(root->name, "RArm") == 0 || strcmp(root->name, "RArm2") == 0)
-		glColor3f(1.0, 0.0, 0.0);
-
-	glVertex2f(0, 0);
 
-	if (!strcmp(root->name, currentName))
-		glColor3f(1.0, 1.0, 0.0);
-	else
-		glColor3f(0.0, 1.0, 0.0);
-
-
-	if(strcmp(root->name, "RLeg") == 0 || strcmp(root->name, "RLeg2") == 0 ||
-		strcmp(root->name, "RArm") == 0 || strcmp(root->name, "RArm2") == 0)
-		glColor3f(1.0, 0.0, 0.0);
+	animationTime = now;
+	frameGraph.Wait(frameLaunch());
 
-	glVertex2f(root->l, 0);
-	glEnd();
+	publishedSlot = poseExchange.GetWriteIndex();
+	poseExchange.Publish();
+	frameScheduler.RequestRedraw();
+}
 
-	/* Get joint vertexes */
-	count = boneGetJoints(root, vert);
+/* The animation thread: one tick every ANIM_TICK seconds while animating
+* or after the input changed something. When it falls behind, the missed
+* ticks are dropped instead of run back to back
+*/
+void animationMain(void *argument)
+{
+	double next = Timer::GetSeconds(), now;
 
-	/* Draw the joint */
-	glColor3f(0.0, 0.0, 1.0);
-	glBegin(GL_POLYGON);
-	for (i = 0; i < count; i++)
-		glVertex2f(vert[i].x, vert[i].y);
-	glEnd();
+	animationLock.Lock();
+	while (animationRunning.Load())
+	{
+		/* Nothing to compute until the input changes something */
+		if (!animating && !animationDirty)
+		{
+			animationWake.Wait(animationLock);
+			next = animationTime = Timer::GetSeconds();
+			continue;
+		}
 
-	/* Translate to reach the new starting position */
-	glTranslatef(root->l, 0.0, 0.0);
+		animationDirty = 0;
+		animationTick();
+		animationLock.Unlock();
 
-	/* Call function on my children */
-	for (i = 0; i < root->childCount; i++)
-		boneDraw(root->child[i]);
+		next += ANIM_TICK;
+		now = Timer::GetSeconds();
+		if (next > now)
+			Thread::Sleep(next - now);
+		else
+			next = now;
 
-	// stop drawing mesh for now
-	//meshDraw(&body);
+		animationLock.Lock();
+	}
+	animationLock.Unlock();
+}
 
-	glPopMatrix();
+/* Tell the animation thread the input changed what it reads. Called with
+* animationLock held
+*/
+void animationChanged()
+{
+	animationDirty = 1;
+	animationWake.Signal();
 }
 
-void reshape(int w, int h)
+/* Publish the first pose, so there is always one to draw, then start ticking */
+int animationStart()
 {
-	glViewport(0, 0, 600, 600);
-	glMatrixMode(GL_PROJECTION);
-	glOrtho(-200, 500, -200, 500, -1, 1);
-	glMatrixMode(GL_MODELVIEW);
+	animationTime = Timer::GetSeconds();
+	animationTick();
+
+	animationRunning.Store(1);
+	if (!animationThread.Start(animationMain, NULL))
+	{
+		animationRunning.Store(0);
+		return 0;
+	}
+
+	return 1;
 }
 
-void increaseFrameNum()
+/* Stop the animation thread before the objects it uses are destroyed */
+void animationStop()
 {
-	if(frameNum < MAX_FRAMES)
-		frameNum++;
-	else
-		frameNum = 0;
+	animationRunning.Store(0);
+	{
+		ScopedLock lock(animationLock);
+		animationWake.Signal();
+	}
+	animationThread.Join();
 }
 
 void drawScene()
 {
-	
+	const CharacterView *view;
+	double now;
+	float alpha;
+	int slot, i, n, moving = 0;
+
+	/* The newest complete pose; the animation thread keeps writing another slot */
+	poseExchange.Acquire();
+	slot = poseExchange.GetReadIndex();
+	now = Timer::GetSeconds();
+
 	glLoadIdentity();
-	
-	boneGenQuads(root);
-	boneDraw(root);
-	if (animating)
+	for (i = 0; i < characterCount; i++)
 	{
-		boneAnimate(root, frameNum);
-		increaseFrameNum();
+		/* Each character is drawn between its last two steps, by its own clock */
+		view = &characters[i].view[slot];
+		n = characters[i].skeleton->GetBoneCount();
+		alpha = (float)((now - view->due) / view->step);
+		if (alpha < 0.0f)
+			alpha = 0.0f;
+		else if (alpha >= 1.0f)
+			alpha = 1.0f;
+		else
+			moving = 1;
 
-		// move the skeleton to the right 
-		root->x = root->x + 1;
-		if(root->x > 470)
-			root->x = -150;
+		boneDraw(view->drawList, view->drawList + n, alpha, n);
 	}
-	glutPostRedisplay();
+
+	/* Still between two poses: the next frame looks different */
+	if (moving)
+		frameScheduler.RequestRedraw();
 }
 
 // functia de display
@@ -654,83 +780,83 @@ void display(void)
 	glutSwapBuffers();
 }
 
+/* GLUT idle callback: redraw when the scheduler has a frame due, otherwise
+* it sleeps there instead of spinning
+*/
+void frameIdle(void)
+{
+	frameScheduler.SetActive(animating != 0);
+	if (frameScheduler.WaitForFrame())
+		glutPostRedisplay();
+}
+
+/* Print the processor used while animating and while the scene stands still */
+void frameSchedulerPrintUsage()
+{
+	double time;
+	int active;
+
+	for (active = 1; active >= 0; active--)
+	{
+		time = frameScheduler.GetTime(active != 0);
+		printf("CPU %s: %.1f%% of a processor over %.1f s, %.1f frames per second\n",
+			active ? "animated" : "idle", frameScheduler.GetProcessorUsage(active != 0) * 100.0,
+			time, time > 0.0 ? frameScheduler.GetFrameCount(active != 0) / time : 0.0);
+	}
+}
+
 void processMouse(int button, int state, int x, int y)
 {
 	printf("mouse processed\n");
-	if(button == GLUT_LEFT_BUTTON)
+	if(button == GLUT_LEFT_BUTTON && skeleton.GetBoneCount())
 	{
+		ScopedLock lock(animationLock);
+
 		/* We have to translate the click since the
 		*  (0, 0) point is in the middle of the screen
 		* and we have to flip Y coords because in SDL
 		*  it grows inversely to the OpenGL
 		*/
-		root->x = (float)x - 200.0;
-		root->y = 200.0 - (float)y;
-		glutPostRedisplay();
+		skeleton.GetX()[0] = (float)x - 200.0;
+		skeleton.GetY()[0] = 200.0 - (float)y;
+		rootX = skeleton.GetX()[0];
+		characters[0].snap = 1;
+		animationChanged();
 
 	}
 
 }
 
-Bone *boneFindByName(Bone *root, char *name)
+void skeletonListNames(const Skeleton *skel, char names[MAX_BONECOUNT][20])
 {
-	int i;
-	Bone *p;
-
-	/* No bone */
-	if (!root)
-		return NULL;
+	int i, b, present;
 
-	/* Check this name */
-	if (!strcmp(root->name, name))
-		return root;
-
-	for (i = 0; i < root->childCount; i++)
+	for (b = 0; b < skel->GetBoneCount(); b++)
 	{
-		/* Search recursively */
-		p = boneFindByName(root->child[i], name);
-
-		/* Found a bone in this subtree! */
-		if (p)
-			return p;
-	}
-
-	/* No such bone */
-	return NULL;
-}
-
-void boneListNames(Bone *root, char names[MAX_BONECOUNT][20])
-{
-	int i, present;
-
-	if (!root)
-		return;
+		/* Check if this name is already in the list */
+		present = 0;
+		for (i = 0; (i < MAX_BONECOUNT) && (names[i][0] != '\0'); i++)
+			if (!strcmp(names[i], skel->GetName(b)))
+			{
+				present = 1;
+				break;
+			}
 
-	/* Check if this name is already in the list */
-	present = 0;
-	for (i = 0; (i < MAX_BONECOUNT) && (names[i][0] != '\0'); i++)
-		if (!strcmp(names[i], root->name))
+		/* If itsn't present and if there is space in list */
+		if (!present && (i < MAX_BONECOUNT))
 		{
-			present = 1;
-			break;
-		}
+			strcpy(names[i], skel->GetName(b));
 
-	/* If itsn't present and if there is space in list */
-	if (!present && (i < MAX_BONECOUNT))
-	{
-		strcpy(names[i], root->name);
-
-		if (i + 1 < MAX_BONECOUNT)
-			names[i + 1][0] = '\0';
+			if (i + 1 < MAX_BONECOUNT)
+				names[i + 1][0] = '\0';
+		}
 	}
-
-	/* Now fill the list with subtree's names */
-	for (i = 0; i < root->childCount; i++)
-		boneListNames(root->child[i], names);		
 }
 
 void processNormalKeys(unsigned char key, int x, int y)
 {
+	ScopedLock lock(animationLock);
+
 	switch(key)
 	{
 	case 'n':
@@ -747,7 +873,7 @@ void processNormalKeys(unsigned char key, int x, int y)
 
 	case 'd':
 		printf("[FRAME]\n");
-		boneDumpTree(root, 1);
+		skeletonDump(&skeleton, &clip);
 		break;
 
 	case 'a':
@@ -758,90 +884,118 @@ void processNormalKeys(unsigned char key, int x, int y)
 			printf("Animation OFF\n");	
 		break;
 
+	case 't':
+		frameGraphPrintTimes();
+		break;
+
+	case 'u':
+		frameSchedulerPrintUsage();
+		break;
+
 	default:
 		break;
 	}
 	currentName = names[nameIndex];
-	glutPostRedisplay();
+	animationChanged();
 }
 
 void inputKey(int key, int x, int y)
 {
-	Bone *p;
+	ScopedLock lock(animationLock);
+	int p = skeleton.FindBone(currentName);
+
+	if (p < 0)
+		return;
+
 	switch (key) {
 		case GLUT_KEY_LEFT :
-			p = boneFindByName(root, currentName);
-			if (p)
-				p->a += 0.1;
+			skeleton.GetAngles()[p] += 0.1;
 			break;
 		case GLUT_KEY_RIGHT : 
-			p = boneFindByName(root, currentName);
-			if (p)
-				p->a -= 0.1;
+			skeleton.GetAngles()[p] -= 0.1;
 			break;
 		case GLUT_KEY_UP : 
-			p = boneFindByName(root, currentName);
-			printf("up: %f\n", p->l);
-			if (p)
-				p->l += 1;
-			printf("up: %f\n", p->l);
+			printf("up: %f\n", skeleton.GetLengths()[p]);
+			skeleton.GetLengths()[p] += 1;
+			printf("up: %f\n", skeleton.GetLengths()[p]);
 			break;
 		case GLUT_KEY_DOWN : 
-			p = boneFindByName(root, currentName);
-			if (p)
-				p->l -= 1;
+			skeleton.GetLengths()[p] -= 1;
 			break;
 	}
-	glutPostRedisplay();
+	animationChanged();
 }
 
 
-void meshLoadData(char *file, Mesh *mesh, Bone *root)
+/* Load the mesh and build its compact influence stream. Each vertex keeps
+* its maxInfluences heaviest bones; with more than SKIN_INFLUENCES the
+* variable influence format is used
+*/
+void meshLoadData(char *file, SkinMesh *mesh, const Skeleton *skel, int maxInfluences)
 {
-	int i, j;
-	char buffer[256], blist[256], *tok, *str;
-	FILE *fd = fopen(file, "r");
+	MeshTextParser parser;
+	MemoryFile *fd;
 
-	int id;
-	float x, y, w;
+	if (!(fd = vfs.OpenMapped(file)))
+	{
+		fprintf(stderr, "Can't open file %s for reading\n", file);
+		return;
+	}
 
-	/* Get the number of vertexes in this mesh */
-	fgets(buffer, 256, fd);
-	sscanf(buffer, "%d\n", &(mesh->vertexCount));
+	if (!parser.Parse((const char *)fd->GetData(), fd->GetLength(), *skel, *mesh, maxInfluences))
+		fprintf(stderr, "%s:%d: %s\n", file, parser.GetErrorLine(), parser.GetError());
+	else if (parser.GetDroppedCount())
+		fprintf(stderr, "%s: %d influences dropped\n", file, parser.GetDroppedCount());
 
-	/* Now read the vertex data */
-	for (i = 0; i < mesh->vertexCount; i++)
-	{
-		fgets(buffer, 256, fd);
-		sscanf(buffer, "%f %f %[^\n]\n", &x, &y, blist);
-		mesh->v[i].v.x = x;
-		mesh->v[i].v.y = y;
+	delete fd;
 
-		str = blist;
-		j = 0;
-		while ((tok = strtok(str, " ")))
-		{
-			str = NULL;
-			mesh->v[i].bone[j] = boneFindByName(root, tok);
-			printf("Vertex %d bone %s", j, tok);
-			tok = strtok(NULL, " ");
-			mesh->v[i].weight[j] = atof(tok);
-			printf(" is weighted %f\n", mesh->v[i].weight[j]);
-
-			j++;
-		}
-		/* Count of relations */
-		mesh->v[i].boneCount = j;
-		printf("This vertex has %d relations\n", j);
+	printf("Mesh influence data: %d bytes\n", mesh->GetStreamSize());
+}
+
+/* Load the skeleton, the animation and the mesh from the text files */
+void textLoadData(Skeleton *skel, AnimClip *anim, SkinMesh *mesh)
+{
+	skeletonLoad("human.txt", skel, anim);
+	meshLoadData("mesh.txt", mesh, skel, SKIN_INFLUENCES);
+
+	/* Keep the loaded character together in one block of memory */
+	if (!skel->MoveToArena(characterArena) || !anim->MoveToArena(characterArena) ||
+		!mesh->MoveToArena(characterArena))
+		fprintf(stderr, "Can't move the character into its arena\n");
+}
 
+/* Map a binary asset and use its clip and mesh in place */
+int assetLoadData(char *file, Skeleton *skel, AnimClip *anim, SkinMesh *mesh)
+{
+	if (!asset.Open(vfs.OpenMapped(file)))
+	{
+		fprintf(stderr, "Can't open binary asset %s\n", file);
+		return 0;
 	}
 
-	fclose(fd);
+	/* Only the pose and the skinned positions are copied, into the arena */
+	asset.AttachClip(*anim);
+	if (!asset.LoadSkeleton(*skel, characterArena) || !asset.AttachMesh(*mesh, characterArena))
+	{
+		fprintf(stderr, "Invalid skeleton in binary asset %s\n", file);
+		return 0;
+	}
+
+	return 1;
+}
+
+/* Binary assets are recognized by their extension */
+int isAssetFile(const char *file)
+{
+	const char *ext = strrchr(file, '.');
+
+	return ext && !strcmp(ext, ".ska");
 }
 
 int main(int argc, char **argv)
 {
-	int i;
+	int i, threadCount = -1, crowdSize = 0;
+	Pose pose;
 	names[0][0] = '\0';
 
 	
@@ -849,6 +1003,23 @@ int main(int argc, char **argv)
 	//Uint32 sdlVideoFlags = SDL_OPENGL;
 	//uint8_t quit;
 
+	/* Options before the file: -j <threads> runs the animation jobs on that
+	* many threads besides the main one (0 runs them serially, for debugging),
+	* -n <characters> adds a crowd, simulated -r <steps> times per second
+	*/
+	while (argc > 3 && (!strcmp(argv[1], "-j") || !strcmp(argv[1], "-n") || !strcmp(argv[1], "-r")))
+	{
+		if (argv[1][1] == 'j')
+			threadCount = atoi(argv[2]);
+		else if (argv[1][1] == 'r')
+			crowdRate = atoi(argv[2]) > 0 ? atoi(argv[2]) : 1;
+		else
+			crowdSize = atoi(argv[2]);
+		argv[2] = argv[0];
+		argv += 2;
+		argc -= 2;
+	}
+
 	/* We need one parameter: the structure file */
 	if (argc < 2)
 	{
@@ -856,6 +1027,50 @@ int main(int argc, char **argv)
 		return EXIT_FAILURE;
 	}
 
+	/* Assets come from data.pak when it exists, then from the current directory */
+	if (LocalFile::Exists("data.pak") && !vfs.MountPack("data.pak"))
+		fprintf(stderr, "Can't mount data.pak\n");
+	vfs.MountDirectory(".");
+
+	/* -p out.pak file... packs asset files into one archive, -pz also compresses them */
+	if (!strcmp(argv[1], "-p") || !strcmp(argv[1], "-pz"))
+	{
+		if (argc < 4)
+		{
+			fprintf(stderr, "Usage: %s -p|-pz <output.pak> <file>...\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+
+		if (!PackArchive::Write(argv[2], argv + 3, argv + 3, argc - 3, argv[1][2] == 'z'))
+		{
+			fprintf(stderr, "Can't write pack archive %s\n", argv[2]);
+			return EXIT_FAILURE;
+		}
+
+		printf("Wrote pack archive %s with %d files\n", argv[2], argc - 3);
+		return EXIT_SUCCESS;
+	}
+
+	/* -c out.ska converts the text files to a binary asset */
+	if (!strcmp(argv[1], "-c"))
+	{
+		if (argc < 3)
+		{
+			fprintf(stderr, "Usage: %s -c <output.ska>\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+
+		textLoadData(&skeleton, &clip, &body);
+		if (!AnimAsset::Write(argv[2], skeleton, clip, body))
+		{
+			fprintf(stderr, "Can't write binary asset %s\n", argv[2]);
+			return EXIT_FAILURE;
+		}
+
+		printf("Wrote binary asset %s\n", argv[2]);
+		return EXIT_SUCCESS;
+	}
+
 	/* Initialize */
 	glutInit(&argc, argv);
 	glutInitDisplayMode(GLUT_DOUBLE|GLUT_RGB|GLUT_DEPTH);
@@ -887,22 +1102,57 @@ int main(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 	*/
-	root = boneLoadStructure("human.txt");
-	meshLoadData("mesh.txt", &body, root);
+	/* -b uses the built-in character, compiled into the program (see AssetCompiler) */
+	if (!strcmp(argv[1], "-b"))
+		HumanAsset_Attach(skeleton, clip, body);
+	else if (isAssetFile(argv[1]))
+	{
+		if (!assetLoadData(argv[1], &skeleton, &clip, &body))
+			return EXIT_FAILURE;
+	}
+	else
+		textLoadData(&skeleton, &clip, &body);
+
+	fixedTopology = FixedSkeleton<HumanAsset_Topology>::Matches(skeleton);
+
+	printf("Animation: %d channels on %d shared timelines\n",
+		clip.GetChannelCount(), clip.GetTimelineCount());
+	printf("Animation: %d constant and %d linear channels eliminated, %d of %d values kept\n",
+		clip.GetConstantCount(), clip.GetLinearCount(), clip.GetValueCount(), clip.GetSourceKeyCount());
+	cursor.Bind(clip);
+	pose = skeleton.GetPose();
+	ApplyConstantChannels(clip, pose);
+
+	if (!jobs.Start(threadCount))
+		fprintf(stderr, "Can't start the job threads, running serially\n");
+	printf("Jobs: %d worker threads%s\n", jobs.GetWorkerCount(), jobs.IsSerial() ? " (serial)" : "");
+
+	charactersCreate(crowdSize < MAX_CROWD ? crowdSize : MAX_CROWD);
+	frameGraphCreate();
+	if (skeleton.GetBoneCount())
+		rootX = skeleton.GetX()[0];
 
-	boneListNames(root, names);
+	skeletonListNames(&skeleton, names);
 
 	for (i = 0; (i < MAX_BONECOUNT) && (names[i][0] != '\0'); i++)
 		printf("Bone name: %s\n", names[i]);
 
 	currentName = names[nameIndex];
 
+	/* GLUT exits from its main loop; the thread is stopped before the globals are destroyed */
+	if (!animationStart())
+	{
+		fprintf(stderr, "Can't start the animation thread\n");
+		return EXIT_FAILURE;
+	}
+	atexit(animationStop);
+
 
 	glShadeModel(GL_SMOOTH);
 
 
 	glutDisplayFunc(display);
-//	glutIdleFunc(display);
+	glutIdleFunc(frameIdle);
 	glutReshapeFunc(reshape);
 
 	glutMouseFunc(processMouse);
@@ -922,4 +1172,4 @@ int main(int argc, char **argv)
 	
 
 	return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,521 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <vector>
+#include <MappedFile.h>
+#include "AnimAsset.h"
+
+/**
+ * Dimensiunea asteptata a unei sectiuni, dupa numaratorile din antet
+ */
+static uint64_t SectionSize(const AnimAssetHeader& header, int section)
+{
+	// In 64 de biti, ca numaratori mari din antet sa nu dea dimensiuni mici
+	switch (section)
+	{
+	case ANIM_ASSET_BONE_PARENT:
+	case ANIM_ASSET_BONE_X:
+	case ANIM_ASSET_BONE_Y:
+	case ANIM_ASSET_BONE_ANGLE:
+	case ANIM_ASSET_BONE_LENGTH:
+		return (uint64_t)header.boneCount * 4;
+	case ANIM_ASSET_BONE_FLAGS:
+		return (uint64_t)header.boneCount;
+	case ANIM_ASSET_BONE_NAME:
+		return (uint64_t)header.boneCount * BONE_NAME_LENGTH;
+
+	case ANIM_ASSET_TIMELINE_START:
+	case ANIM_ASSET_TIMELINE_KEYS:
+	case ANIM_ASSET_TIMELINE_HASH:
+	case ANIM_ASSET_TIMELINE_FIRST:
+	case ANIM_ASSET_TIMELINE_LAST:
+		return (uint64_t)header.timelineCount * 4;
+	case ANIM_ASSET_TIMES:
+		return (uint64_t)header.timeTotal * 4;
+	case ANIM_ASSET_CHANNEL_BONE:
+	case ANIM_ASSET_CHANNEL_TIMELINE:
+	case ANIM_ASSET_CHANNEL_VALUES:
+	case ANIM_ASSET_CHANNEL_NEXT:
+		return (uint64_t)header.channelCount * 4;
+	case ANIM_ASSET_CHANNEL_TARGET:
+	case ANIM_ASSET_CHANNEL_KIND:
+		return (uint64_t)header.channelCount;
+	case ANIM_ASSET_VALUES:
+		return (uint64_t)header.valueTotal * 4;
+
+	case ANIM_ASSET_MESH_X:
+	case ANIM_ASSET_MESH_Y:
+		return (uint64_t)header.vertexCount * 4;
+	case ANIM_ASSET_MESH_BONE:
+		return (uint64_t)header.vertexCount * SKIN_INFLUENCES;
+	case ANIM_ASSET_MESH_WEIGHT:
+		return (uint64_t)header.vertexCount * SKIN_INFLUENCES * 2;
+	}
+
+	return 0;
+}
+
+/**
+ * Parcurge o lista de canale din fisier: fiecare canal trebuie sa aiba
+ * felul listei (si, pentru cele animate, linia ei de timp) si sa nu fi
+ * aparut in alta lista, deci lista nu poate avea cicluri. Lista se termina
+ * la last, dupa count canale daca count nu este -1
+ */
+static bool CheckChannelList(int first, int last, int count, uint8_t kind, int timeline,
+	const uint8_t* kinds, const int32_t* timelines, const int32_t* next, std::vector<uint8_t>& listed)
+{
+	int n = 0, previous = -1;
+
+	if (first < -1)
+	{
+		return false;
+	}
+
+	for (int c = first; c >= 0; c = next[c])
+	{
+		if (c >= (int)listed.size() || listed[c] || kinds[c] != kind || (timeline >= 0 && timelines[c] != timeline))
+		{
+			return false;
+		}
+
+		listed[c] = 1;
+		previous = c;
+		n++;
+	}
+
+	return previous == last && (count < 0 || n == count);
+}
+
+AnimAsset::AnimAsset() : m_file(NULL), m_header(NULL)
+{
+}
+
+bool AnimAsset::Open(const char* filename)
+{
+	MappedFile* file = new MappedFile();
+	if (!file->Open(filename))
+	{
+		delete file;
+		return false;
+	}
+
+	return this->Open(file);
+}
+
+bool AnimAsset::Open(MemoryFile* file)
+{
+	this->Close();
+
+	if (!file)
+	{
+		return false;
+	}
+
+	m_file = file;
+	m_header = (const AnimAssetHeader*)m_file->GetData();
+	if (!this->Validate())
+	{
+		this->Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool AnimAsset::Validate() const
+{
+	if (m_file->GetLength() < sizeof(AnimAssetHeader))
+	{
+		return false;
+	}
+
+	const AnimAssetHeader& header = *m_header;
+	if (header.magic != ANIM_ASSET_MAGIC || header.version != ANIM_ASSET_VERSION ||
+		header.size > m_file->GetLength())
+	{
+		return false;
+	}
+
+	// Numaratorile sunt folosite ca int si nu pot fi mai mari decat fisierul
+	const uint32_t counts[] = { header.boneCount, header.timelineCount, header.timeTotal,
+		header.channelCount, header.valueTotal, header.vertexCount };
+	for (int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++)
+	{
+		if (counts[i] > INT_MAX || counts[i] > header.size)
+		{
+			return false;
+		}
+	}
+
+	// Fiecare sectiune e aliniata, in interiorul fisierului si are dimensiunea asteptata
+	for (int i = 0; i < ANIM_ASSET_SECTION_COUNT; i++)
+	{
+		const AnimAssetRange& range = header.sections[i];
+		if (range.offset % ANIM_ASSET_ALIGN != 0 || range.size != SectionSize(header, i) ||
+			range.offset > header.size || range.size > header.size - range.offset)
+		{
+			return false;
+		}
+	}
+
+	return this->ValidateClip() && this->ValidateMesh();
+}
+
+bool AnimAsset::ValidateClip() const
+{
+	const AnimAssetHeader& header = *m_header;
+	int timelineCount = (int)header.timelineCount;
+	int channelCount = (int)header.channelCount;
+	const int32_t* start = (const int32_t*)this->GetSection(ANIM_ASSET_TIMELINE_START);
+	const int32_t* keys = (const int32_t*)this->GetSection(ANIM_ASSET_TIMELINE_KEYS);
+	const int32_t* first = (const int32_t*)this->GetSection(ANIM_ASSET_TIMELINE_FIRST);
+	const int32_t* last = (const int32_t*)this->GetSection(ANIM_ASSET_TIMELINE_LAST);
+	const int32_t* bone = (const int32_t*)this->GetSection(ANIM_ASSET_CHANNEL_BONE);
+	const uint8_t* target = (const uint8_t*)this->GetSection(ANIM_ASSET_CHANNEL_TARGET);
+	const uint8_t* kind = (const uint8_t*)this->GetSection(ANIM_ASSET_CHANNEL_KIND);
+	const int32_t* timeline = (const int32_t*)this->GetSection(ANIM_ASSET_CHANNEL_TIMELINE);
+	const int32_t* valueStart = (const int32_t*)this->GetSection(ANIM_ASSET_CHANNEL_VALUES);
+	const int32_t* next = (const int32_t*)this->GetSection(ANIM_ASSET_CHANNEL_NEXT);
+
+	// Fiecare linie de timp are cel putin o cheie, toate in tabloul timpilor
+	for (int t = 0; t < timelineCount; t++)
+	{
+		if (start[t] < 0 || keys[t] <= 0 || keys[t] > (int)header.timeTotal - start[t])
+		{
+			return false;
+		}
+	}
+
+	// Osul, linia de timp si valorile fiecarui canal sunt in limite
+	for (int c = 0; c < channelCount; c++)
+	{
+		if (bone[c] < 0 || bone[c] >= (int)header.boneCount || target[c] > ANIM_TARGET_LENGTH ||
+			kind[c] > ANIM_CHANNEL_ANIMATED || timeline[c] < 0 || timeline[c] >= timelineCount ||
+			next[c] < -1 || next[c] >= channelCount)
+		{
+			return false;
+		}
+
+		int values = kind[c] == ANIM_CHANNEL_CONSTANT ? 1 : (kind[c] == ANIM_CHANNEL_LINEAR ? 2 : keys[timeline[c]]);
+		if (valueStart[c] < 0 || values > (int)header.valueTotal - valueStart[c])
+		{
+			return false;
+		}
+	}
+
+	// Listele de canale se termina si nu se intersecteaza
+	std::vector<uint8_t> listed(channelCount, 0);
+	if (!CheckChannelList(header.constantFirst, header.constantLast, header.constantCount,
+			ANIM_CHANNEL_CONSTANT, -1, kind, timeline, next, listed) ||
+		!CheckChannelList(header.linearFirst, header.linearLast, header.linearCount,
+			ANIM_CHANNEL_LINEAR, -1, kind, timeline, next, listed))
+	{
+		return false;
+	}
+
+	for (int t = 0; t < timelineCount; t++)
+	{
+		if (!CheckChannelList(first[t], last[t], -1, ANIM_CHANNEL_ANIMATED, t, kind, timeline, next, listed))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool AnimAsset::ValidateMesh() const
+{
+	const uint8_t* bone = (const uint8_t*)this->GetSection(ANIM_ASSET_MESH_BONE);
+	uint32_t n = m_header->vertexCount * SKIN_INFLUENCES;
+
+	// Paleta de desenare are cate o matrice pentru fiecare os al scheletului
+	for (uint32_t i = 0; i < n; i++)
+	{
+		if (bone[i] >= m_header->boneCount)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void AnimAsset::Close()
+{
+	delete m_file;
+	m_file = NULL;
+	m_header = NULL;
+}
+
+const void* AnimAsset::GetSection(AnimAssetSection section) const
+{
+	return m_file->GetData() + m_header->sections[section].offset;
+}
+
+bool AnimAsset::LoadSkeleton(Skeleton& skeleton) const
+{
+	const int32_t* parent = (const int32_t*)this->GetSection(ANIM_ASSET_BONE_PARENT);
+	const float* x = (const float*)this->GetSection(ANIM_ASSET_BONE_X);
+	const float* y = (const float*)this->GetSection(ANIM_ASSET_BONE_Y);
+	const float* angle = (const float*)this->GetSection(ANIM_ASSET_BONE_ANGLE);
+	const float* length = (const float*)this->GetSection(ANIM_ASSET_BONE_LENGTH);
+	const uint8_t* flags = (const uint8_t*)this->GetSection(ANIM_ASSET_BONE_FLAGS);
+	const char* names = (const char*)this->GetSection(ANIM_ASSET_BONE_NAME);
+
+	skeleton.Clear();
+
+	for (uint32_t b = 0; b < m_header->boneCount; b++)
+	{
+		// Numele din fisier nu e neaparat terminat cu 0
+		char name[BONE_NAME_LENGTH];
+		memcpy(name, names + b * BONE_NAME_LENGTH, BONE_NAME_LENGTH);
+		name[BONE_NAME_LENGTH - 1] = '\0';
+
+		if (skeleton.AddBone(parent[b], x[b], y[b], angle[b], length[b], flags[b], name) < 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool AnimAsset::LoadSkeleton(Skeleton& skeleton, Arena& arena) const
+{
+	int n = (int)m_header->boneCount;
+	const int32_t* parent = (const int32_t*)this->GetSection(ANIM_ASSET_BONE_PARENT);
+	const char* names = (const char*)this->GetSection(ANIM_ASSET_BONE_NAME);
+
+	// Toate tablourile scheletului intr-o singura bucata a arenei
+	if (!arena.Reserve(n * (3 * sizeof(int) + 4 * sizeof(float) + sizeof(Affine2) + sizeof(uint8_t) +
+		BONE_NAME_LENGTH) + 10 * ARENA_ALIGN))
+	{
+		return false;
+	}
+
+	SkeletonData data;
+	int* parents = arena.CopyArray((const int*)parent, n);
+	char (*name)[BONE_NAME_LENGTH] = arena.AllocateArray<char[BONE_NAME_LENGTH]>(n);
+	int* firstChild = arena.AllocateArray<int>(n);
+	int* nextSibling = arena.AllocateArray<int>(n);
+
+	data.boneCount = n;
+	data.parent = parents;
+	data.x = arena.CopyArray((const float*)this->GetSection(ANIM_ASSET_BONE_X), n);
+	data.y = arena.CopyArray((const float*)this->GetSection(ANIM_ASSET_BONE_Y), n);
+	data.angle = arena.CopyArray((const float*)this->GetSection(ANIM_ASSET_BONE_ANGLE), n);
+	data.length = arena.CopyArray((const float*)this->GetSection(ANIM_ASSET_BONE_LENGTH), n);
+	data.world = arena.AllocateArray<Affine2>(n);
+	data.flags = arena.CopyArray((const uint8_t*)this->GetSection(ANIM_ASSET_BONE_FLAGS), n);
+	data.name = name;
+	data.firstChild = firstChild;
+	data.nextSibling = nextSibling;
+
+	if (!parents || !name || !firstChild || !nextSibling || !data.x || !data.y || !data.angle ||
+		!data.length || !data.world || !data.flags)
+	{
+		return false;
+	}
+
+	for (int b = 0; b < n; b++)
+	{
+		// Aceeasi verificare ca in AddBone: parintele este inaintea osului
+		if (parents[b] < -1 || parents[b] >= b)
+		{
+			return false;
+		}
+
+		// Numele din fisier nu e neaparat terminat cu 0
+		memcpy(name[b], names + b * BONE_NAME_LENGTH, BONE_NAME_LENGTH);
+		name[b][BONE_NAME_LENGTH - 1] = '\0';
+
+		data.world[b] = Affine2::Identity();
+		firstChild[b] = nextSibling[b] = -1;
+	}
+
+	// Legaturile intre frati, de la coada, ca sa pastram ordinea din fisier
+	for (int b = n - 1; b >= 0; b--)
+	{
+		if (parents[b] >= 0)
+		{
+			nextSibling[b] = firstChild[parents[b]];
+			firstChild[parents[b]] = b;
+		}
+	}
+
+	skeleton.Attach(data);
+	return true;
+}
+
+void AnimAsset::AttachClip(AnimClip& clip) const
+{
+	const AnimAssetHeader& header = *m_header;
+	AnimClipData data;
+
+	data.timelineCount = header.timelineCount;
+	data.timelineStart = (const int*)this->GetSection(ANIM_ASSET_TIMELINE_START);
+	data.timelineKeys = (const int*)this->GetSection(ANIM_ASSET_TIMELINE_KEYS);
+	data.timelineHash = (const uint32_t*)this->GetSection(ANIM_ASSET_TIMELINE_HASH);
+	data.timelineFirst = (const int*)this->GetSection(ANIM_ASSET_TIMELINE_FIRST);
+	data.timelineLast = (const int*)this->GetSection(ANIM_ASSET_TIMELINE_LAST);
+	data.timeTotal = header.timeTotal;
+	data.times = (const float*)this->GetSection(ANIM_ASSET_TIMES);
+	data.channelCount = header.channelCount;
+	data.bone = (const int*)this->GetSection(ANIM_ASSET_CHANNEL_BONE);
+	data.target = (const uint8_t*)this->GetSection(ANIM_ASSET_CHANNEL_TARGET);
+	data.kind = (const uint8_t*)this->GetSection(ANIM_ASSET_CHANNEL_KIND);
+	data.timeline = (const int*)this->GetSection(ANIM_ASSET_CHANNEL_TIMELINE);
+	data.valueStart = (const int*)this->GetSection(ANIM_ASSET_CHANNEL_VALUES);
+	data.nextChannel = (const int*)this->GetSection(ANIM_ASSET_CHANNEL_NEXT);
+	data.constantFirst = header.constantFirst;
+	data.constantLast = header.constantLast;
+	data.constantCount = header.constantCount;
+	data.linearFirst = header.linearFirst;
+	data.linearLast = header.linearLast;
+	data.linearCount = header.linearCount;
+	data.valueTotal = header.valueTotal;
+	data.values = (const float*)this->GetSection(ANIM_ASSET_VALUES);
+	data.keyTotal = header.keyTotal;
+	data.duration = header.duration;
+
+	clip.Attach(data);
+}
+
+void AnimAsset::AttachMesh(SkinMesh& mesh) const
+{
+	SkinStream stream;
+
+	stream.vertexCount = m_header->vertexCount;
+	stream.x = (const float*)this->GetSection(ANIM_ASSET_MESH_X);
+	stream.y = (const float*)this->GetSection(ANIM_ASSET_MESH_Y);
+	stream.bone = (const uint8_t*)this->GetSection(ANIM_ASSET_MESH_BONE);
+	stream.weight = (const uint16_t*)this->GetSection(ANIM_ASSET_MESH_WEIGHT);
+
+	mesh.Attach(stream);
+}
+
+bool AnimAsset::AttachMesh(SkinMesh& mesh, Arena& arena) const
+{
+	SkinStream stream;
+	int n = (int)m_header->vertexCount;
+	float* skinnedX = arena.AllocateArray<float>(n);
+	float* skinnedY = arena.AllocateArray<float>(n);
+
+	if (!skinnedX || !skinnedY)
+	{
+		return false;
+	}
+
+	stream.vertexCount = n;
+	stream.x = (const float*)this->GetSection(ANIM_ASSET_MESH_X);
+	stream.y = (const float*)this->GetSection(ANIM_ASSET_MESH_Y);
+	stream.bone = (const uint8_t*)this->GetSection(ANIM_ASSET_MESH_BONE);
+	stream.weight = (const uint16_t*)this->GetSection(ANIM_ASSET_MESH_WEIGHT);
+
+	mesh.Attach(stream, skinnedX, skinnedY);
+	return true;
+}
+
+bool AnimAsset::Write(const char* filename, const Skeleton& skeleton, const AnimClip& clip, const SkinMesh& mesh)
+{
+	if (mesh.IsVariable())
+	{
+		return false;
+	}
+
+	AnimClipData data = clip.GetData();
+	SkinStream stream = mesh.GetStream();
+	int boneCount = skeleton.GetBoneCount();
+
+	AnimAssetHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = ANIM_ASSET_MAGIC;
+	header.version = ANIM_ASSET_VERSION;
+	header.boneCount = boneCount;
+	header.timelineCount = data.timelineCount;
+	header.timeTotal = data.timeTotal;
+	header.channelCount = data.channelCount;
+	header.valueTotal = data.valueTotal;
+	header.keyTotal = data.keyTotal;
+	header.constantFirst = data.constantFirst;
+	header.constantLast = data.constantLast;
+	header.constantCount = data.constantCount;
+	header.linearFirst = data.linearFirst;
+	header.linearLast = data.linearLast;
+	header.linearCount = data.linearCount;
+	header.duration = data.duration;
+	header.vertexCount = stream.vertexCount;
+
+	// Datele oaselor care nu sunt pastrate ca tablouri continue
+	std::vector<uint8_t> flags(boneCount + 1);
+	std::vector<char> names(boneCount * BONE_NAME_LENGTH + 1, '\0');
+	for (int b = 0; b < boneCount; b++)
+	{
+		flags[b] = skeleton.GetFlags(b);
+		strncpy(&names[b * BONE_NAME_LENGTH], skeleton.GetName(b), BONE_NAME_LENGTH - 1);
+	}
+
+	const void* source[ANIM_ASSET_SECTION_COUNT];
+	source[ANIM_ASSET_BONE_PARENT] = skeleton.GetParents();
+	source[ANIM_ASSET_BONE_X] = skeleton.GetX();
+	source[ANIM_ASSET_BONE_Y] = skeleton.GetY();
+	source[ANIM_ASSET_BONE_ANGLE] = skeleton.GetAngles();
+	source[ANIM_ASSET_BONE_LENGTH] = skeleton.GetLengths();
+	source[ANIM_ASSET_BONE_FLAGS] = &flags[0];
+	source[ANIM_ASSET_BONE_NAME] = &names[0];
+	source[ANIM_ASSET_TIMELINE_START] = data.timelineStart;
+	source[ANIM_ASSET_TIMELINE_KEYS] = data.timelineKeys;
+	source[ANIM_ASSET_TIMELINE_HASH] = data.timelineHash;
+	source[ANIM_ASSET_TIMELINE_FIRST] = data.timelineFirst;
+	source[ANIM_ASSET_TIMELINE_LAST] = data.timelineLast;
+	source[ANIM_ASSET_TIMES] = data.times;
+	source[ANIM_ASSET_CHANNEL_BONE] = data.bone;
+	source[ANIM_ASSET_CHANNEL_TARGET] = data.target;
+	source[ANIM_ASSET_CHANNEL_KIND] = data.kind;
+	source[ANIM_ASSET_CHANNEL_TIMELINE] = data.timeline;
+	source[ANIM_ASSET_CHANNEL_VALUES] = data.valueStart;
+	source[ANIM_ASSET_CHANNEL_NEXT] = data.nextChannel;
+	source[ANIM_ASSET_VALUES] = data.values;
+	source[ANIM_ASSET_MESH_X] = stream.x;
+	source[ANIM_ASSET_MESH_Y] = stream.y;
+	source[ANIM_ASSET_MESH_BONE] = stream.bone;
+	source[ANIM_ASSET_MESH_WEIGHT] = stream.weight;
+
+	// Asezam sectiunile una dupa alta, aliniate, dupa antet
+	uint32_t offset = sizeof(AnimAssetHeader);
+	for (int i = 0; i < ANIM_ASSET_SECTION_COUNT; i++)
+	{
+		offset = (offset + ANIM_ASSET_ALIGN - 1) & ~(uint32_t)(ANIM_ASSET_ALIGN - 1);
+		header.sections[i].offset = offset;
+		header.sections[i].size = (uint32_t)SectionSize(header, i);
+		offset += header.sections[i].size;
+	}
+	header.size = offset;
+
+	std::vector<uint8_t> blob(header.size, 0);
+	memcpy(&blob[0], &header, sizeof(header));
+	for (int i = 0; i < ANIM_ASSET_SECTION_COUNT; i++)
+	{
+		if (header.sections[i].size)
+		{
+			memcpy(&blob[header.sections[i].offset], source[i], header.sections[i].size);
+		}
+	}
+
+	FILE* file = fopen(filename, "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	bool ok = fwrite(&blob[0], 1, blob.size(), file) == blob.size();
+	ok = fclose(file) == 0 && ok;
+
+	return ok;
+}
+
+AnimAsset::~AnimAsset()
+{
+	this->Close();
+}
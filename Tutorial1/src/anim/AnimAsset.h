@@ -0,0 +1,191 @@
+#ifndef ANIMASSET_H_
+#define ANIMASSET_H_
+
+#include <stddef.h>
+#include <Types.h>
+#include <Skeleton.h>
+#include <AnimClip.h>
+#include <Skinning.h>
+#include <MemoryFile.h>
+#include <Arena.h>
+
+/**
+ * Semnatura si versiunea formatului binar; versiunea creste la orice
+ * schimbare a structurii de mai jos
+ */
+#define ANIM_ASSET_MAGIC		0x41534B53	// "SKSA"
+#define ANIM_ASSET_VERSION		1
+
+/**
+ * Sectiunile incep la multipli de ANIM_ASSET_ALIGN octeti
+ */
+#define ANIM_ASSET_ALIGN		16
+
+/**
+ * Sectiunile fisierului binar; fiecare este un tablou simplu, exact in
+ * formatul folosit in memorie, ca fisierul sa poata fi folosit pe loc
+ */
+enum AnimAssetSection
+{
+	// Tabela oaselor (structure-of-arrays, ca in Skeleton)
+	ANIM_ASSET_BONE_PARENT,		// int32_t
+	ANIM_ASSET_BONE_X,			// float
+	ANIM_ASSET_BONE_Y,			// float
+	ANIM_ASSET_BONE_ANGLE,		// float
+	ANIM_ASSET_BONE_LENGTH,		// float
+	ANIM_ASSET_BONE_FLAGS,		// uint8_t
+
+	// Tabela numelor: BONE_NAME_LENGTH caractere pe os
+	ANIM_ASSET_BONE_NAME,
+
+	// Clipul (vezi AnimClipData)
+	ANIM_ASSET_TIMELINE_START,	// int32_t
+	ANIM_ASSET_TIMELINE_KEYS,	// int32_t
+	ANIM_ASSET_TIMELINE_HASH,	// uint32_t
+	ANIM_ASSET_TIMELINE_FIRST,	// int32_t
+	ANIM_ASSET_TIMELINE_LAST,	// int32_t
+	ANIM_ASSET_TIMES,			// float
+	ANIM_ASSET_CHANNEL_BONE,	// int32_t
+	ANIM_ASSET_CHANNEL_TARGET,	// uint8_t
+	ANIM_ASSET_CHANNEL_KIND,	// uint8_t
+	ANIM_ASSET_CHANNEL_TIMELINE,// int32_t
+	ANIM_ASSET_CHANNEL_VALUES,	// int32_t
+	ANIM_ASSET_CHANNEL_NEXT,	// int32_t
+	ANIM_ASSET_VALUES,			// float
+
+	// Influentele mesh-ului, in formatul compact (vezi SkinStream)
+	ANIM_ASSET_MESH_X,			// float
+	ANIM_ASSET_MESH_Y,			// float
+	ANIM_ASSET_MESH_BONE,		// uint8_t
+	ANIM_ASSET_MESH_WEIGHT,		// uint16_t
+
+	ANIM_ASSET_SECTION_COUNT
+};
+
+/**
+ * Pozitia unei sectiuni, relativa la inceputul fisierului
+ */
+struct AnimAssetRange
+{
+	uint32_t offset;
+	uint32_t size;
+};
+
+/**
+ * Antetul fisierului binar; toate valorile sunt in ordinea octetilor
+ * masinii (little-endian) si toate legaturile sunt offset-uri
+ */
+struct AnimAssetHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t size;				// Dimensiunea intregului fisier
+
+	uint32_t boneCount;
+
+	// Numaratorile si listele clipului
+	uint32_t timelineCount;
+	uint32_t timeTotal;
+	uint32_t channelCount;
+	uint32_t valueTotal;
+	uint32_t keyTotal;
+	int32_t constantFirst, constantLast, constantCount;
+	int32_t linearFirst, linearLast, linearCount;
+	float duration;
+
+	uint32_t vertexCount;
+
+	AnimAssetRange sections[ANIM_ASSET_SECTION_COUNT];
+};
+
+/**
+ * Fisier binar cu un schelet, clipul lui si influentele mesh-ului.
+ * Fisierul este mapat in memorie si folosit pe loc, fara parsare: clipul
+ * si mesh-ul se ataseaza direct la sectiunile lui, iar din schelet se
+ * copiaza doar poza de legare (care se modifica la animatie). La deschidere
+ * se verifica antetul, limitele sectiunilor si toti indicii si listele din
+ * fisier, ca un fisier stricat sa fie refuzat de Open in loc sa fie citit
+ * in afara tablourilor; timpii, valorile si pozitiile nu se citesc, deci
+ * costul incarcarii ramane dat in mare de paginile folosite efectiv
+ */
+class AnimAsset
+{
+private:
+	/**
+	* Fisierul mapat in memorie si antetul de la inceputul lui
+	*/
+	MemoryFile* m_file;
+	const AnimAssetHeader* m_header;
+
+	/**
+	* Verifica antetul, ca fiecare sectiune are dimensiunea asteptata si ca
+	* indicii clipului si ai mesh-ului sunt in limite
+	*/
+	bool Validate() const;
+	bool ValidateClip() const;
+	bool ValidateMesh() const;
+
+	// Nu copiem fisierele mapate
+	AnimAsset(const AnimAsset&);
+	AnimAsset& operator=(const AnimAsset&);
+
+public:
+	AnimAsset();
+
+	/**
+	* Mapeaza fisierul si ii verifica antetul
+	*/
+	bool Open(const char* filename);
+
+	/**
+	* Foloseste un fisier aflat deja in memorie (de ex. dintr-o arhiva) si ii
+	* verifica antetul; fisierul devine al obiectului si poate fi NULL
+	*/
+	bool Open(MemoryFile* file);
+
+	bool IsOpen() const { return m_header != NULL; }
+
+	/**
+	* Elibereaza maparea; clipurile si mesh-urile atasate nu mai pot fi folosite
+	*/
+	void Close();
+
+	const AnimAssetHeader& GetHeader() const { return *m_header; }
+
+	/**
+	* Inceputul unei sectiuni in fisierul mapat
+	*/
+	const void* GetSection(AnimAssetSection section) const;
+
+	/**
+	* Reconstruieste scheletul din tabela oaselor
+	*/
+	bool LoadSkeleton(Skeleton& skeleton) const;
+
+	/**
+	* Reconstruieste scheletul direct in arena, fara alocari separate;
+	* scheletul ramane atasat la memoria arenei
+	*/
+	bool LoadSkeleton(Skeleton& skeleton, Arena& arena) const;
+
+	/**
+	* Ataseaza clipul si mesh-ul la datele din fisier, fara copiere
+	*/
+	void AttachClip(AnimClip& clip) const;
+	void AttachMesh(SkinMesh& mesh) const;
+
+	/**
+	* Ca AttachMesh, dar pozitiile rezultate se iau din arena
+	*/
+	bool AttachMesh(SkinMesh& mesh, Arena& arena) const;
+
+	/**
+	* Scrie un schelet, un clip si un mesh in formatul binar; mesh-ul
+	* trebuie sa foloseasca formatul compact
+	*/
+	static bool Write(const char* filename, const Skeleton& skeleton, const AnimClip& clip, const SkinMesh& mesh);
+
+	~AnimAsset();
+};
+
+#endif /*ANIMASSET_H_*/
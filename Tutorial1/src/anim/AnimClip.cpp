@@ -0,0 +1,668 @@
+#include <string.h>
+#include <math.h>
+#include "AnimClip.h"
+
+/**
+ * Realoca un tablou pastrand primele count elemente
+ */
+template <class T>
+static void GrowArray(T*& array, int count, int capacity)
+{
+	T* grown = new T[capacity];
+	if (count)
+	{
+		memcpy(grown, array, count * sizeof(T));
+	}
+	delete[] array;
+	array = grown;
+}
+
+AnimClip::AnimClip() :
+	m_timelineCount(0), m_timelineCapacity(0), m_timelineStart(NULL),
+	m_timelineKeys(NULL), m_timelineHash(NULL), m_timelineFirst(NULL),
+	m_timelineLast(NULL), m_times(NULL), m_timeTotal(0), m_timeCapacity(0),
+	m_channelCount(0), m_channelCapacity(0), m_bone(NULL), m_target(NULL),
+	m_kind(NULL), m_timeline(NULL), m_valueStart(NULL), m_nextChannel(NULL),
+	m_constantFirst(-1), m_constantLast(-1), m_constantCount(0),
+	m_linearFirst(-1), m_linearLast(-1), m_linearCount(0), m_values(NULL),
+	m_valueTotal(0), m_valueCapacity(0), m_keyTotal(0), m_duration(0.0f),
+	m_external(false)
+{
+}
+
+/**
+ * Hash FNV-1a peste bitii timpilor
+ */
+static uint32_t HashTimes(const float* times, int count)
+{
+	const uint8_t* bytes = (const uint8_t*)times;
+	uint32_t hash = 2166136261u;
+
+	for (int i = 0; i < count * (int)sizeof(float); i++)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+
+	return hash;
+}
+
+/**
+ * Toleranta relativa la care doua valori ale unui canal sunt considerate egale
+ */
+#define CHANNEL_EPSILON	1e-6f
+
+static bool NearlyEqual(float a, float b)
+{
+	float scale = fabsf(a) > 1.0f ? fabsf(a) : 1.0f;
+	return fabsf(a - b) <= CHANNEL_EPSILON * scale;
+}
+
+/**
+ * Clasifica un canal dupa valori; pentru cel liniar intoarce si panta
+ */
+static AnimChannelKind ClassifyChannel(const float* times, const float* values, int count, float& slope)
+{
+	slope = 0.0f;
+
+	bool constant = true;
+	for (int i = 1; i < count && constant; i++)
+	{
+		constant = NearlyEqual(values[i], values[0]);
+	}
+	if (constant)
+	{
+		return ANIM_CHANNEL_CONSTANT;
+	}
+
+	// Toate cheile trebuie sa fie pe dreapta dintre prima si ultima
+	slope = (values[count - 1] - values[0]) / (times[count - 1] - times[0]);
+	for (int i = 1; i < count - 1; i++)
+	{
+		if (!NearlyEqual(values[i], values[0] + slope * (times[i] - times[0])))
+		{
+			return ANIM_CHANNEL_ANIMATED;
+		}
+	}
+
+	return ANIM_CHANNEL_LINEAR;
+}
+
+/**
+ * Capacitatea dubla fata de capacity, suficienta pentru needed elemente
+ */
+static int GrowCapacity(int capacity, int needed, int minimum)
+{
+	capacity = capacity ? capacity * 2 : minimum;
+	while (capacity < needed)
+	{
+		capacity *= 2;
+	}
+	return capacity;
+}
+
+int AnimClip::AddTimeline(const float* times, int count)
+{
+	uint32_t hash = HashTimes(times, count);
+
+	// Refolosim o linie de timp identica
+	for (int i = 0; i < m_timelineCount; i++)
+	{
+		if (m_timelineHash[i] == hash && m_timelineKeys[i] == count &&
+			memcmp(m_times + m_timelineStart[i], times, count * sizeof(float)) == 0)
+		{
+			return i;
+		}
+	}
+
+	if (m_timelineCount == m_timelineCapacity)
+	{
+		int capacity = GrowCapacity(m_timelineCapacity, m_timelineCount + 1, 4);
+		GrowArray(m_timelineStart, m_timelineCount, capacity);
+		GrowArray(m_timelineKeys, m_timelineCount, capacity);
+		GrowArray(m_timelineHash, m_timelineCount, capacity);
+		GrowArray(m_timelineFirst, m_timelineCount, capacity);
+		GrowArray(m_timelineLast, m_timelineCount, capacity);
+		m_timelineCapacity = capacity;
+	}
+
+	if (m_timeTotal + count > m_timeCapacity)
+	{
+		int capacity = GrowCapacity(m_timeCapacity, m_timeTotal + count, 64);
+		GrowArray(m_times, m_timeTotal, capacity);
+		m_timeCapacity = capacity;
+	}
+
+	int timeline = m_timelineCount++;
+	m_timelineStart[timeline] = m_timeTotal;
+	m_timelineKeys[timeline] = count;
+	m_timelineHash[timeline] = hash;
+	m_timelineFirst[timeline] = -1;
+	m_timelineLast[timeline] = -1;
+
+	memcpy(m_times + m_timeTotal, times, count * sizeof(float));
+	m_timeTotal += count;
+
+	if (times[count - 1] > m_duration)
+	{
+		m_duration = times[count - 1];
+	}
+
+	return timeline;
+}
+
+int AnimClip::AddChannel(int bone, AnimTarget target, const float* times, const float* values, int count)
+{
+	if (bone < 0 || count <= 0 || m_external)
+	{
+		return -1;
+	}
+
+	// Timpii trebuie sa fie strict crescatori pentru cautarea binara
+	for (int i = 1; i < count; i++)
+	{
+		if (times[i] <= times[i - 1])
+		{
+			return -1;
+		}
+	}
+
+	if (m_channelCount == m_channelCapacity)
+	{
+		int capacity = GrowCapacity(m_channelCapacity, m_channelCount + 1, 16);
+		GrowArray(m_bone, m_channelCount, capacity);
+		GrowArray(m_target, m_channelCount, capacity);
+		GrowArray(m_kind, m_channelCount, capacity);
+		GrowArray(m_timeline, m_channelCount, capacity);
+		GrowArray(m_valueStart, m_channelCount, capacity);
+		GrowArray(m_nextChannel, m_channelCount, capacity);
+		m_channelCapacity = capacity;
+	}
+
+	if (m_valueTotal + count > m_valueCapacity)
+	{
+		int capacity = GrowCapacity(m_valueCapacity, m_valueTotal + count, 64);
+		GrowArray(m_values, m_valueTotal, capacity);
+		m_valueCapacity = capacity;
+	}
+
+	float slope;
+	AnimChannelKind kind = ClassifyChannel(times, values, count, slope);
+
+	int timeline = this->AddTimeline(times, count);
+	int channel = m_channelCount++;
+	m_bone[channel] = bone;
+	m_target[channel] = (uint8_t)target;
+	m_kind[channel] = (uint8_t)kind;
+	m_timeline[channel] = timeline;
+	m_valueStart[channel] = m_valueTotal;
+	m_nextChannel[channel] = -1;
+	m_keyTotal += count;
+
+	// Pastram doar valorile de care are nevoie felul canalului
+	switch (kind)
+	{
+	case ANIM_CHANNEL_CONSTANT:
+		m_values[m_valueTotal++] = values[0];
+		this->LinkChannel(m_constantFirst, m_constantLast, channel);
+		m_constantCount++;
+		break;
+
+	case ANIM_CHANNEL_LINEAR:
+		m_values[m_valueTotal++] = values[0];
+		m_values[m_valueTotal++] = slope;
+		this->LinkChannel(m_linearFirst, m_linearLast, channel);
+		m_linearCount++;
+		break;
+
+	default:
+		memcpy(m_values + m_valueTotal, values, count * sizeof(float));
+		m_valueTotal += count;
+		this->LinkChannel(m_timelineFirst[timeline], m_timelineLast[timeline], channel);
+		break;
+	}
+
+	return channel;
+}
+
+void AnimClip::LinkChannel(int& first, int& last, int channel)
+{
+	if (last < 0)
+	{
+		first = channel;
+	}
+	else
+	{
+		m_nextChannel[last] = channel;
+	}
+	last = channel;
+}
+
+bool AnimClip::AddKeyframes(int bone, const Keyframe* keys, int count)
+{
+	if (count <= 0)
+	{
+		return false;
+	}
+
+	float* times = new float[count];
+	float* angles = new float[count];
+	float* lengths = new float[count];
+
+	for (int i = 0; i < count; i++)
+	{
+		times[i] = (float)keys[i].time;
+		angles[i] = keys[i].angle;
+		lengths[i] = keys[i].length;
+	}
+
+	bool ok = this->AddChannel(bone, ANIM_TARGET_ANGLE, times, angles, count) >= 0 &&
+		this->AddChannel(bone, ANIM_TARGET_LENGTH, times, lengths, count) >= 0;
+
+	delete[] times;
+	delete[] angles;
+	delete[] lengths;
+
+	return ok;
+}
+
+void AnimClip::Clear()
+{
+	// Un clip atasat revine la tablourile proprii, goale
+	if (m_external)
+	{
+		m_timelineStart = m_timelineKeys = m_timelineFirst = m_timelineLast = NULL;
+		m_timelineHash = NULL;
+		m_times = m_values = NULL;
+		m_bone = m_timeline = m_valueStart = m_nextChannel = NULL;
+		m_target = m_kind = NULL;
+		m_timelineCapacity = m_timeCapacity = m_channelCapacity = m_valueCapacity = 0;
+		m_external = false;
+	}
+
+	m_timelineCount = 0;
+	m_timeTotal = 0;
+	m_channelCount = 0;
+	m_constantFirst = m_constantLast = -1;
+	m_constantCount = 0;
+	m_linearFirst = m_linearLast = -1;
+	m_linearCount = 0;
+	m_valueTotal = 0;
+	m_keyTotal = 0;
+	m_duration = 0.0f;
+}
+
+int AnimClip::FindChannel(int bone, AnimTarget target) const
+{
+	for (int i = 0; i < m_channelCount; i++)
+	{
+		if (m_bone[i] == bone && m_target[i] == target)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+float AnimClip::SampleChannel(int channel, float time) const
+{
+	const float* times = this->GetKeyTimes(channel);
+	const float* values = this->GetKeyValues(channel);
+	int count = this->GetKeyCount(channel);
+
+	switch (m_kind[channel])
+	{
+	case ANIM_CHANNEL_CONSTANT:
+		return values[0];
+
+	case ANIM_CHANNEL_LINEAR:
+		return AnimEvaluateLinear(times, values, count, time);
+
+	default:
+		return AnimInterpolate(times, values, count, AnimFindKey(times, count, time), time);
+	}
+}
+
+AnimClipData AnimClip::GetData() const
+{
+	AnimClipData data;
+
+	data.timelineCount = m_timelineCount;
+	data.timelineStart = m_timelineStart;
+	data.timelineKeys = m_timelineKeys;
+	data.timelineHash = m_timelineHash;
+	data.timelineFirst = m_timelineFirst;
+	data.timelineLast = m_timelineLast;
+	data.timeTotal = m_timeTotal;
+	data.times = m_times;
+	data.channelCount = m_channelCount;
+	data.bone = m_bone;
+	data.target = m_target;
+	data.kind = m_kind;
+	data.timeline = m_timeline;
+	data.valueStart = m_valueStart;
+	data.nextChannel = m_nextChannel;
+	data.constantFirst = m_constantFirst;
+	data.constantLast = m_constantLast;
+	data.constantCount = m_constantCount;
+	data.linearFirst = m_linearFirst;
+	data.linearLast = m_linearLast;
+	data.linearCount = m_linearCount;
+	data.valueTotal = m_valueTotal;
+	data.values = m_values;
+	data.keyTotal = m_keyTotal;
+	data.duration = m_duration;
+
+	return data;
+}
+
+void AnimClip::Attach(const AnimClipData& data)
+{
+	this->Free();
+
+	// Tablourile atasate sunt doar citite; AddChannel refuza clipurile atasate
+	m_timelineCount = data.timelineCount;
+	m_timelineStart = const_cast<int*>(data.timelineStart);
+	m_timelineKeys = const_cast<int*>(data.timelineKeys);
+	m_timelineHash = const_cast<uint32_t*>(data.timelineHash);
+	m_timelineFirst = const_cast<int*>(data.timelineFirst);
+	m_timelineLast = const_cast<int*>(data.timelineLast);
+	m_timeTotal = data.timeTotal;
+	m_times = const_cast<float*>(data.times);
+	m_channelCount = data.channelCount;
+	m_bone = const_cast<int*>(data.bone);
+	m_target = const_cast<uint8_t*>(data.target);
+	m_kind = const_cast<uint8_t*>(data.kind);
+	m_timeline = const_cast<int*>(data.timeline);
+	m_valueStart = const_cast<int*>(data.valueStart);
+	m_nextChannel = const_cast<int*>(data.nextChannel);
+	m_constantFirst = data.constantFirst;
+	m_constantLast = data.constantLast;
+	m_constantCount = data.constantCount;
+	m_linearFirst = data.linearFirst;
+	m_linearLast = data.linearLast;
+	m_linearCount = data.linearCount;
+	m_valueTotal = data.valueTotal;
+	m_values = const_cast<float*>(data.values);
+	m_keyTotal = data.keyTotal;
+	m_duration = data.duration;
+
+	m_timelineCapacity = m_timelineCount;
+	m_timeCapacity = m_timeTotal;
+	m_channelCapacity = m_channelCount;
+	m_valueCapacity = m_valueTotal;
+	m_external = true;
+}
+
+bool AnimClip::MoveToArena(Arena& arena)
+{
+	AnimClipData data = this->GetData();
+
+	data.timelineStart = arena.CopyArray(data.timelineStart, data.timelineCount);
+	data.timelineKeys = arena.CopyArray(data.timelineKeys, data.timelineCount);
+	data.timelineHash = arena.CopyArray(data.timelineHash, data.timelineCount);
+	data.timelineFirst = arena.CopyArray(data.timelineFirst, data.timelineCount);
+	data.timelineLast = arena.CopyArray(data.timelineLast, data.timelineCount);
+	data.times = arena.CopyArray(data.times, data.timeTotal);
+	data.bone = arena.CopyArray(data.bone, data.channelCount);
+	data.target = arena.CopyArray(data.target, data.channelCount);
+	data.kind = arena.CopyArray(data.kind, data.channelCount);
+	data.timeline = arena.CopyArray(data.timeline, data.channelCount);
+	data.valueStart = arena.CopyArray(data.valueStart, data.channelCount);
+	data.nextChannel = arena.CopyArray(data.nextChannel, data.channelCount);
+	data.values = arena.CopyArray(data.values, data.valueTotal);
+
+	if (!data.timelineStart || !data.timelineKeys || !data.timelineHash || !data.timelineFirst ||
+		!data.timelineLast || !data.times || !data.bone || !data.target || !data.kind ||
+		!data.timeline || !data.valueStart || !data.nextChannel || !data.values)
+	{
+		return false;
+	}
+
+	this->Attach(data);
+	return true;
+}
+
+void AnimClip::Free()
+{
+	if (!m_external)
+	{
+		delete[] m_timelineStart;
+		delete[] m_timelineKeys;
+		delete[] m_timelineHash;
+		delete[] m_timelineFirst;
+		delete[] m_timelineLast;
+		delete[] m_times;
+		delete[] m_bone;
+		delete[] m_target;
+		delete[] m_kind;
+		delete[] m_timeline;
+		delete[] m_valueStart;
+		delete[] m_nextChannel;
+		delete[] m_values;
+	}
+}
+
+AnimClip::~AnimClip()
+{
+	this->Free();
+}
+
+int AnimFindKey(const float* times, int count, float time)
+{
+	// Ultimul index cu times[i] <= time
+	int lo = 0, hi = count;
+
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (times[mid] <= time)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	return lo - 1;
+}
+
+/**
+ * Cate chei poate sari cursorul inainte de a trece la cautarea binara
+ */
+#define CURSOR_MAX_STEPS	4
+
+int AnimFindKeyCursor(const float* times, int count, float time, int& cursor)
+{
+	int key = cursor;
+
+	// Cursorul e valid si timpul nu a mers inapoi: avansam
+	if (key >= -1 && key < count && (key < 0 || times[key] <= time))
+	{
+		for (int step = 0; step < CURSOR_MAX_STEPS; step++)
+		{
+			if (key + 1 >= count || times[key + 1] > time)
+			{
+				cursor = key;
+				return key;
+			}
+			key++;
+		}
+	}
+
+	// Salt inapoi sau prea departe: cautare binara
+	cursor = AnimFindKey(times, count, time);
+	return cursor;
+}
+
+float AnimInterpolate(const float* times, const float* values, int count, int key, float time)
+{
+	// Inainte de prima cheie sau dupa ultima
+	if (key < 0)
+	{
+		return values[0];
+	}
+	if (key >= count - 1)
+	{
+		return values[count - 1];
+	}
+
+	float u = (time - times[key]) / (times[key + 1] - times[key]);
+	return values[key] + (values[key + 1] - values[key]) * u;
+}
+
+float AnimEvaluateLinear(const float* times, const float* values, int count, float time)
+{
+	// Inainte de prima cheie si dupa ultima valoarea ramane constanta
+	if (time <= times[0])
+	{
+		return values[0];
+	}
+	if (time > times[count - 1])
+	{
+		time = times[count - 1];
+	}
+
+	return values[0] + values[1] * (time - times[0]);
+}
+
+AnimCursor::AnimCursor() : m_keys(NULL), m_timelineCount(0)
+{
+}
+
+void AnimCursor::Bind(const AnimClip& clip)
+{
+	if (clip.GetTimelineCount() != m_timelineCount)
+	{
+		delete[] m_keys;
+		m_timelineCount = clip.GetTimelineCount();
+		m_keys = new int[m_timelineCount];
+	}
+
+	this->Reset();
+}
+
+void AnimCursor::Reset()
+{
+	for (int i = 0; i < m_timelineCount; i++)
+	{
+		m_keys[i] = -1;
+	}
+}
+
+AnimCursor::~AnimCursor()
+{
+	delete[] m_keys;
+}
+
+/**
+ * Scrie valoarea unui canal in poza
+ */
+static inline void WriteChannel(const AnimClip& clip, int channel, float value, Pose& out)
+{
+	if (clip.GetChannelTarget(channel) == ANIM_TARGET_ANGLE)
+	{
+		out.angle[clip.GetChannelBone(channel)] = value;
+	}
+	else
+	{
+		out.length[clip.GetChannelBone(channel)] = value;
+	}
+}
+
+/**
+ * Scrie in poza valorile tuturor canalelor unei linii de timp, dupa ce
+ * cheia key a fost gasita o singura data pentru toate
+ */
+static void SampleTimeline(const AnimClip& clip, int timeline, int key, float time, Pose& out)
+{
+	const float* times = clip.GetTimelineTimes(timeline);
+	int count = clip.GetTimelineKeyCount(timeline);
+	int k0, k1;
+	float u = 0.0f;
+
+	// Inainte de prima cheie sau dupa ultima valoarea e constanta
+	if (key < 0)
+	{
+		k0 = k1 = 0;
+	}
+	else if (key >= count - 1)
+	{
+		k0 = k1 = count - 1;
+	}
+	else
+	{
+		k0 = key;
+		k1 = key + 1;
+		u = (time - times[k0]) / (times[k1] - times[k0]);
+	}
+
+	for (int c = clip.GetTimelineFirstChannel(timeline); c >= 0; c = clip.GetNextChannel(c))
+	{
+		const float* values = clip.GetKeyValues(c);
+		WriteChannel(clip, c, values[k0] + (values[k1] - values[k0]) * u, out);
+	}
+}
+
+/**
+ * Canalele liniare nu au nevoie de cautarea cheii
+ */
+static void SampleLinear(const AnimClip& clip, float time, Pose& out)
+{
+	for (int c = clip.GetLinearFirstChannel(); c >= 0; c = clip.GetNextChannel(c))
+	{
+		WriteChannel(clip, c, AnimEvaluateLinear(clip.GetKeyTimes(c), clip.GetKeyValues(c), clip.GetKeyCount(c), time), out);
+	}
+}
+
+void ApplyConstantChannels(const AnimClip& clip, Pose& out)
+{
+	for (int c = clip.GetConstantFirstChannel(); c >= 0; c = clip.GetNextChannel(c))
+	{
+		WriteChannel(clip, c, clip.GetKeyValues(c)[0], out);
+	}
+}
+
+void SamplePose(const AnimClip& clip, float time, Pose& out)
+{
+	for (int t = 0; t < clip.GetTimelineCount(); t++)
+	{
+		// Liniile de timp fara canale animate nu se mai cauta
+		if (clip.GetTimelineFirstChannel(t) < 0)
+		{
+			continue;
+		}
+
+		int key = AnimFindKey(clip.GetTimelineTimes(t), clip.GetTimelineKeyCount(t), time);
+		SampleTimeline(clip, t, key, time, out);
+	}
+
+	SampleLinear(clip, time, out);
+}
+
+void SamplePose(const AnimClip& clip, float time, Pose& out, AnimCursor& cursor)
+{
+	for (int t = 0; t < clip.GetTimelineCount(); t++)
+	{
+		if (clip.GetTimelineFirstChannel(t) < 0)
+		{
+			continue;
+		}
+
+		int key = AnimFindKeyCursor(clip.GetTimelineTimes(t), clip.GetTimelineKeyCount(t), time, cursor.GetKey(t));
+		SampleTimeline(clip, t, key, time, out);
+	}
+
+	SampleLinear(clip, time, out);
+}
+
+void BlendPose(const Pose& a, const Pose& b, float weight, Pose& out)
+{
+	for (int i = 0; i < out.boneCount; i++)
+	{
+		out.angle[i] = a.angle[i] + (b.angle[i] - a.angle[i]) * weight;
+		out.length[i] = a.length[i] + (b.length[i] - a.length[i]) * weight;
+	}
+}
@@ -0,0 +1,353 @@
+#ifndef ANIMCLIP_H_
+#define ANIMCLIP_H_
+
+#include <Types.h>
+#include <Arena.h>
+#include <Skeleton.h>
+
+/**
+ * Cheie de animatie pentru un os, asa cum apare in fisierele text
+ */
+struct Keyframe
+{
+	uint32_t time;
+	float angle, length;
+};
+
+/**
+ * Valoarea animata de un canal
+ */
+enum AnimTarget
+{
+	ANIM_TARGET_ANGLE,
+	ANIM_TARGET_LENGTH
+};
+
+/**
+ * Felul unui canal, stabilit la AddChannel dupa valorile cheilor
+ */
+enum AnimChannelKind
+{
+	// Aceeasi valoare la toate cheile: se aplica o data, nu se esantioneaza
+	ANIM_CHANNEL_CONSTANT,
+	// Valorile sunt pe o dreapta: se evalueaza fara cautarea cheii
+	ANIM_CHANNEL_LINEAR,
+	// Interpolare intre chei
+	ANIM_CHANNEL_ANIMATED
+};
+
+/**
+ * Vedere asupra tuturor tablourilor unui clip, asa cum sunt pastrate in
+ * memorie; folosita pentru scrierea clipului intr-un fisier binar si
+ * pentru folosirea lui direct din fisier (AnimClip::Attach)
+ */
+struct AnimClipData
+{
+	int timelineCount;
+	const int* timelineStart;
+	const int* timelineKeys;
+	const uint32_t* timelineHash;
+	const int* timelineFirst;
+	const int* timelineLast;
+
+	int timeTotal;
+	const float* times;
+
+	int channelCount;
+	const int* bone;
+	const uint8_t* target;
+	const uint8_t* kind;
+	const int* timeline;
+	const int* valueStart;
+	const int* nextChannel;
+
+	int constantFirst, constantLast, constantCount;
+	int linearFirst, linearLast, linearCount;
+
+	int valueTotal;
+	const float* values;
+
+	int keyTotal;
+	float duration;
+};
+
+/**
+ * Clip de animatie: un set de canale, fiecare animand unghiul sau
+ * lungimea unui os prin chei (timp, valoare) ordonate dupa timp.
+ * Poza se poate calcula direct pentru orice moment (SamplePose), fara
+ * stare intre cadre, deci se poate cauta, derula, rula cu orice viteza
+ * sau imparti pe mai multe fire.
+ *
+ * Timpii cheilor sunt pastrati o singura data pe linie de timp; canalele
+ * cu aceiasi timpi (de obicei toate oasele unui clip exportat) refolosesc
+ * aceeasi linie, detectata automat la AddChannel. Un canal are doar un
+ * tablou dens de valori, aliniat cu timpii liniei sale, iar la
+ * esantionare cheia se cauta o singura data pe linie de timp.
+ *
+ * Canalele constante si liniare nu isi pastreaza cheile: un canal constant
+ * retine doar valoarea si e sarit la esantionare (ApplyConstantChannels il
+ * scrie o singura data), iar unul liniar retine valoarea de start si panta
+ */
+class AnimClip
+{
+private:
+	/**
+	* Liniile de timp: intervalul timpilor in m_times, un hash al lor pentru
+	* detectarea duplicatelor si lista canalelor care le folosesc
+	*/
+	int m_timelineCount;
+	int m_timelineCapacity;
+	int* m_timelineStart;
+	int* m_timelineKeys;
+	uint32_t* m_timelineHash;
+	int* m_timelineFirst;
+	int* m_timelineLast;
+
+	/**
+	* Timpii tuturor liniilor de timp
+	*/
+	float* m_times;
+	int m_timeTotal;
+	int m_timeCapacity;
+
+	/**
+	* Canalele: osul, valoarea animata, felul, linia de timp, inceputul
+	* valorilor in m_values si urmatorul canal din aceeasi lista (canalele
+	* animate ale unei linii de timp, cele constante sau cele liniare)
+	*/
+	int m_channelCount;
+	int m_channelCapacity;
+	int* m_bone;
+	uint8_t* m_target;
+	uint8_t* m_kind;
+	int* m_timeline;
+	int* m_valueStart;
+	int* m_nextChannel;
+
+	/**
+	* Listele canalelor constante si liniare
+	*/
+	int m_constantFirst, m_constantLast, m_constantCount;
+	int m_linearFirst, m_linearLast, m_linearCount;
+
+	/**
+	* Valorile tuturor canalelor; pentru cele constante doar valoarea, pentru
+	* cele liniare valoarea la prima cheie si panta
+	*/
+	float* m_values;
+	int m_valueTotal;
+	int m_valueCapacity;
+
+	/**
+	* Cate chei au fost adaugate, inainte de eliminarea celor redundante
+	*/
+	int m_keyTotal;
+
+	/**
+	* Timpul ultimei chei
+	*/
+	float m_duration;
+
+	/**
+	* Tablourile sunt ale altcuiva (Attach) si nu pot fi modificate
+	*/
+	bool m_external;
+
+	/**
+	* Elibereaza tablourile detinute
+	*/
+	void Free();
+
+	/**
+	* Intoarce linia de timp cu exact acesti timpi, adaugand-o daca nu exista
+	*/
+	int AddTimeline(const float* times, int count);
+
+	/**
+	* Adauga channel la sfarsitul unei liste de canale
+	*/
+	void LinkChannel(int& first, int& last, int channel);
+
+	// Nu copiem clipurile
+	AnimClip(const AnimClip&);
+	AnimClip& operator=(const AnimClip&);
+
+public:
+	AnimClip();
+
+	/**
+	* Adauga un canal; timpii trebuie sa fie strict crescatori.
+	* Intoarce indexul canalului sau -1 la eroare
+	*/
+	int AddChannel(int bone, AnimTarget target, const float* times, const float* values, int count);
+
+	/**
+	* Adauga canalele de unghi si lungime pentru cheile unui os
+	*/
+	bool AddKeyframes(int bone, const Keyframe* keys, int count);
+
+	/**
+	* Sterge toate canalele
+	*/
+	void Clear();
+
+	/**
+	* Tablourile clipului, pentru scriere
+	*/
+	AnimClipData GetData() const;
+
+	/**
+	* Foloseste direct tablourile date, fara copiere (de ex. dintr-un fisier
+	* mapat in memorie); ele trebuie sa ramana valide cat timp sunt folosite.
+	* Clipul nu mai poate fi modificat pana la Clear()
+	*/
+	void Attach(const AnimClipData& data);
+
+	bool IsAttached() const { return m_external; }
+
+	/**
+	* Muta tablourile clipului in arena si se ataseaza la copia lor; clipul
+	* nu mai poate fi modificat, iar memoria se elibereaza odata cu arena
+	*/
+	bool MoveToArena(Arena& arena);
+
+	int GetChannelCount() const { return m_channelCount; }
+	int GetChannelBone(int channel) const { return m_bone[channel]; }
+	AnimTarget GetChannelTarget(int channel) const { return (AnimTarget)m_target[channel]; }
+	AnimChannelKind GetChannelKind(int channel) const { return (AnimChannelKind)m_kind[channel]; }
+	int GetChannelTimeline(int channel) const { return m_timeline[channel]; }
+
+	/**
+	* Timpii cheilor unui canal; valorile (GetKeyValues) exista doar pentru
+	* canalele animate, pentru celelalte se foloseste SampleChannel
+	*/
+	int GetKeyCount(int channel) const { return m_timelineKeys[m_timeline[channel]]; }
+	const float* GetKeyTimes(int channel) const { return m_times + m_timelineStart[m_timeline[channel]]; }
+	const float* GetKeyValues(int channel) const { return m_values + m_valueStart[channel]; }
+
+	int GetTimelineCount() const { return m_timelineCount; }
+	int GetTimelineKeyCount(int timeline) const { return m_timelineKeys[timeline]; }
+	const float* GetTimelineTimes(int timeline) const { return m_times + m_timelineStart[timeline]; }
+
+	/**
+	* Primul canal animat de pe o linie de timp, primul canal constant,
+	* primul liniar si urmatorul din aceeasi lista dupa channel; -1 la final
+	*/
+	int GetTimelineFirstChannel(int timeline) const { return m_timelineFirst[timeline]; }
+	int GetConstantFirstChannel() const { return m_constantFirst; }
+	int GetLinearFirstChannel() const { return m_linearFirst; }
+	int GetNextChannel(int channel) const { return m_nextChannel[channel]; }
+
+	int GetConstantCount() const { return m_constantCount; }
+	int GetLinearCount() const { return m_linearCount; }
+
+	/**
+	* Cate valori pastreaza clipul si cate chei i-au fost date
+	*/
+	int GetValueCount() const { return m_valueTotal; }
+	int GetSourceKeyCount() const { return m_keyTotal; }
+
+	/**
+	* Cauta canalul pentru un os si o valoare animata; -1 daca nu exista
+	*/
+	int FindChannel(int bone, AnimTarget target) const;
+
+	float GetDuration() const { return m_duration; }
+
+	/**
+	* Valoarea unui canal la momentul time; inainte de prima cheie si dupa
+	* ultima valoarea ramane constanta
+	*/
+	float SampleChannel(int channel, float time) const;
+
+	~AnimClip();
+};
+
+/**
+ * Cauta binar intervalul de chei care contine time: intoarce i astfel
+ * incat times[i] <= time < times[i + 1]; -1 daca time < times[0]
+ * si count - 1 daca time >= times[count - 1]
+ */
+int AnimFindKey(const float* times, int count, float time);
+
+/**
+ * La fel ca AnimFindKey, dar porneste de la cursor (rezultatul cautarii
+ * anterioare) si il actualizeaza. Cand timpul avanseaza putin, cursorul
+ * inainteaza cu cateva chei, in O(1) amortizat; la salturi inapoi
+ * (cautari, bucle) sau prea departe inainte se foloseste cautarea binara
+ */
+int AnimFindKeyCursor(const float* times, int count, float time, int& cursor);
+
+/**
+ * Interpoleaza liniar valoarea din intervalul de chei [key, key + 1]
+ * gasit de AnimFindKey
+ */
+float AnimInterpolate(const float* times, const float* values, int count, int key, float time);
+
+/**
+ * Valoarea unui canal liniar (values = valoarea la prima cheie si panta),
+ * constanta in afara intervalului cheilor
+ */
+float AnimEvaluateLinear(const float* times, const float* values, int count, float time);
+
+/**
+ * Starea de redare a unei instante care ruleaza un clip: cate un cursor
+ * (ultima cheie gasita) pentru fiecare linie de timp. Fiecare personaj are
+ * propriul cursor, clipul ramane partajat si nemodificat
+ */
+class AnimCursor
+{
+private:
+	int* m_keys;
+	int m_timelineCount;
+
+	// Nu copiem cursoarele
+	AnimCursor(const AnimCursor&);
+	AnimCursor& operator=(const AnimCursor&);
+
+public:
+	AnimCursor();
+
+	/**
+	* Pregateste cursorul pentru un clip si il reseteaza
+	*/
+	void Bind(const AnimClip& clip);
+
+	/**
+	* Reseteaza toate liniile de timp; urmatorul esantion va folosi cautarea binara
+	*/
+	void Reset();
+
+	int GetTimelineCount() const { return m_timelineCount; }
+
+	int& GetKey(int timeline) { return m_keys[timeline]; }
+
+	~AnimCursor();
+};
+
+/**
+ * Scrie in out valorile canalelor constante; se apeleaza o data cand
+ * clipul incepe sa ruleze pe o poza, SamplePose nu le mai scrie
+ */
+void ApplyConstantChannels(const AnimClip& clip, Pose& out);
+
+/**
+ * Calculeaza poza clipului la momentul time si o scrie in out;
+ * oasele fara canale si canalele constante nu sunt modificate
+ */
+void SamplePose(const AnimClip& clip, float time, Pose& out);
+
+/**
+ * La fel, dar foloseste si actualizeaza cursorul instantei; cursorul
+ * trebuie sa fi fost legat de acelasi clip
+ */
+void SamplePose(const AnimClip& clip, float time, Pose& out, AnimCursor& cursor);
+
+/**
+ * Amesteca doua poze ale aceluiasi schelet: out = a + (b - a) * weight,
+ * pentru unghiurile si lungimile oaselor (valorile animate de clipuri);
+ * pozitiile din out nu sunt modificate. out poate fi chiar a sau b
+ */
+void BlendPose(const Pose& a, const Pose& b, float weight, Pose& out);
+
+#endif /*ANIMCLIP_H_*/
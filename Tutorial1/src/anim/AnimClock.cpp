@@ -0,0 +1,37 @@
+#include <math.h>
+#include "AnimClock.h"
+
+AnimClock::AnimClock(double step) : m_step(step), m_timeScale(1.0f), m_accumulator(0.0), m_time(0.0)
+{
+}
+
+int AnimClock::Advance(double seconds)
+{
+	int steps = 0;
+
+	if (seconds > 0.0)
+	{
+		m_accumulator += seconds;
+	}
+
+	while (m_accumulator >= m_step && steps < ANIMCLOCK_MAX_STEPS)
+	{
+		m_accumulator -= m_step;
+		m_time += m_step * m_timeScale;
+		steps++;
+	}
+
+	// Prea mult timp dintr-o data: pastram doar fractiunea de pas
+	if (m_accumulator >= m_step)
+	{
+		m_accumulator = fmod(m_accumulator, m_step);
+	}
+
+	return steps;
+}
+
+void AnimClock::Reset(double time)
+{
+	m_time = time;
+	m_accumulator = 0.0;
+}
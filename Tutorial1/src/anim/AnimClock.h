@@ -0,0 +1,77 @@
+#ifndef ANIMCLOCK_H_
+#define ANIMCLOCK_H_
+
+/**
+ * Cati pasi poate face un ceas la un singur Advance; restul timpului se
+ * pierde, ca dupa o pauza lunga (depanator, fereastra mutata) animatia sa
+ * nu incerce sa recupereze tot
+ */
+#define ANIMCLOCK_MAX_STEPS	8
+
+/**
+ * Ceasul animatiei unei instante, cu pas fix: timpul real primit la
+ * Advance se aduna intr-un acumulator, iar simularea avanseaza doar cu
+ * pasi intregi, deci viteza animatiei nu depinde de cat de des se
+ * deseneaza. Pentru desenare se interpoleaza intre ultimele doua stari
+ * simulate cu GetAlpha(), deci un pas mai mare (o instanta din fundal
+ * simulata mai rar) nu se vede sacadat.
+ *
+ * Scara timpului (SetTimeScale) schimba doar cat timp de animatie
+ * inseamna un pas, nu cat de des se fac pasii
+ */
+class AnimClock
+{
+private:
+	/**
+	* Secundele reale dintre doi pasi
+	*/
+	double m_step;
+
+	/**
+	* Timpul de animatie al unui pas fata de timpul real
+	*/
+	float m_timeScale;
+
+	/**
+	* Timpul real primit si nesimulat inca; mai mic decat un pas dupa Advance
+	*/
+	double m_accumulator;
+
+	/**
+	* Timpul de animatie al ultimului pas, in secunde
+	*/
+	double m_time;
+
+public:
+	explicit AnimClock(double step = 1.0 / 60.0);
+
+	void SetStep(double seconds) { m_step = seconds; }
+	double GetStep() const { return m_step; }
+
+	void SetTimeScale(float scale) { m_timeScale = scale; }
+	float GetTimeScale() const { return m_timeScale; }
+
+	/**
+	* Adauga seconds secunde reale si intoarce cati pasi s-au facut;
+	* timpul de animatie creste cu m_step * m_timeScale la fiecare pas
+	*/
+	int Advance(double seconds);
+
+	/**
+	* Timpul de animatie al ultimului pas
+	*/
+	double GetTime() const { return m_time; }
+
+	/**
+	* Cat din pasul urmator s-a acumulat, in [0, 1): factorul de
+	* interpolare intre ultimele doua stari simulate
+	*/
+	float GetAlpha() const { return (float)(m_accumulator / m_step); }
+
+	/**
+	* Porneste din nou de la timpul de animatie time, fara timp acumulat
+	*/
+	void Reset(double time = 0.0);
+};
+
+#endif /*ANIMCLOCK_H_*/
@@ -0,0 +1,160 @@
+#ifndef FIXEDSKELETON_H_
+#define FIXEDSKELETON_H_
+
+#include <Affine2.h>
+#include <Skeleton.h>
+#include <Skinning.h>
+
+/**
+ * O topologie fixa este o clasa cu numarul de oase (BONE_COUNT) si cu
+ * parintele fiecarui os ca si constanta de compilare:
+ * Topology::Parent<bone>::VALUE (-1 pentru radacina). Se declara cu
+ *
+ *	FIXED_TOPOLOGY(HumanTopology, 3)
+ *	FIXED_BONE(HumanTopology, 0, -1)
+ *	FIXED_BONE(HumanTopology, 1, 0)
+ *	FIXED_BONE(HumanTopology, 2, 0)
+ *
+ * (AssetCompiler le scrie pentru scheletele compilate in program) sau
+ * ca un template, cand parintii urmeaza o formula
+ */
+#define FIXED_TOPOLOGY(Name, count) \
+	struct Name \
+	{ \
+		enum { BONE_COUNT = count }; \
+		template <int Bone> struct Parent; \
+	};
+
+#define FIXED_BONE(Name, bone, parent) \
+	template <> struct Name::Parent<bone> { enum { VALUE = parent }; };
+
+/**
+ * Transformarea unui os cu parintele cunoscut la compilare
+ */
+template <int Bone, int Parent>
+struct FixedJoint
+{
+	// Oasele sunt in ordine parinte-inaintea-copilului, ca in Skeleton
+	typedef char ParentBeforeChild[Parent < Bone ? 1 : -1];
+
+	static inline void Compute(const float* x, const float* y, const float* angle, const float* length,
+		Affine2* world)
+	{
+		Affine2 m = world[Parent];
+		m.Translate(length[Parent] + x[Bone], y[Bone]);
+		m.Rotate(angle[Bone]);
+		world[Bone] = m;
+	}
+};
+
+template <int Bone>
+struct FixedJoint<Bone, -1>
+{
+	static inline void Compute(const float* x, const float* y, const float* angle, const float*,
+		Affine2* world)
+	{
+		world[Bone] = Affine2::RotationTranslation(angle[Bone], x[Bone], y[Bone]);
+	}
+};
+
+/**
+ * Oasele [Bone, Count) ale topologiei, desfasurate la compilare: fara
+ * bucla, fara citirea indexului parintelui si fara ramura pentru radacina
+ */
+template <class Topology, int Bone, int Count>
+struct FixedChain
+{
+	static inline void Compute(const float* x, const float* y, const float* angle, const float* length,
+		Affine2* world)
+	{
+		FixedJoint<Bone, Topology::template Parent<Bone>::VALUE>::Compute(x, y, angle, length, world);
+		FixedChain<Topology, Bone + 1, Count>::Compute(x, y, angle, length, world);
+	}
+
+	static void GetParents(int* parents)
+	{
+		parents[Bone] = Topology::template Parent<Bone>::VALUE;
+		FixedChain<Topology, Bone + 1, Count>::GetParents(parents);
+	}
+};
+
+template <class Topology, int Count>
+struct FixedChain<Topology, Count, Count>
+{
+	static inline void Compute(const float*, const float*, const float*, const float*, Affine2*)
+	{
+	}
+
+	static void GetParents(int*)
+	{
+	}
+};
+
+/**
+ * Forward kinematics si skinning pentru un schelet a carui ierarhie este
+ * cunoscuta la compilare. Face acelasi calcul ca Skeleton::ComputeWorld(),
+ * dar parcurgerea ierarhiei este rezolvata de compilator. Scheletul
+ * folosit trebuie sa aiba exact topologia data (vezi Matches())
+ */
+template <class Topology>
+class FixedSkeleton
+{
+public:
+	enum { BONE_COUNT = Topology::BONE_COUNT };
+
+	/**
+	* Verifica daca ierarhia unui schelet incarcat este chiar topologia
+	*/
+	static bool Matches(const Skeleton& skeleton)
+	{
+		int parents[BONE_COUNT];
+		FixedChain<Topology, 0, BONE_COUNT>::GetParents(parents);
+
+		if (skeleton.GetBoneCount() != BONE_COUNT)
+		{
+			return false;
+		}
+
+		for (int i = 0; i < BONE_COUNT; i++)
+		{
+			if (skeleton.GetParent(i) != parents[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	* Calculeaza paleta din tablourile pozei
+	*/
+	static void ComputeWorld(const float* x, const float* y, const float* angle, const float* length,
+		Affine2* world)
+	{
+		FixedChain<Topology, 0, BONE_COUNT>::Compute(x, y, angle, length, world);
+	}
+
+	/**
+	* Inlocuieste skeleton.ComputeWorld()
+	*/
+	static void ComputeWorld(Skeleton& skeleton)
+	{
+		ComputeWorld(skeleton.GetX(), skeleton.GetY(), skeleton.GetAngles(), skeleton.GetLengths(),
+			skeleton.GetPalette());
+	}
+
+	/**
+	* Calculeaza paleta intr-un tablou de pe stiva si face skinning-ul
+	* mesh-ului cu ea, fara sa atinga paleta scheletului
+	*/
+	static void Skin(const Skeleton& skeleton, const SkinStream& stream, float* outX, float* outY)
+	{
+		Affine2 palette[BONE_COUNT];
+
+		ComputeWorld(skeleton.GetX(), skeleton.GetY(), skeleton.GetAngles(), skeleton.GetLengths(), palette);
+		SkinVertices(palette, stream, outX, outY);
+	}
+};
+
+#endif /*FIXEDSKELETON_H_*/
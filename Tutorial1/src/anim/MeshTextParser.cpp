@@ -0,0 +1,131 @@
+#include <StringView.h>
+#include <TextReader.h>
+#include "MeshTextParser.h"
+
+/**
+ * Cei mai multi vertecsi acceptati; un numar mai mare este un fisier corupt
+ */
+#define MESHTEXT_MAX_VERTICES	(1 << 24)
+
+MeshTextParser::MeshTextParser() : m_error(NULL), m_errorLine(0), m_droppedCount(0)
+{
+}
+
+bool MeshTextParser::Fail(const char* error, int line)
+{
+	m_error = error;
+	m_errorLine = line;
+	return false;
+}
+
+bool MeshTextParser::Parse(const char* text, size_t size, const Skeleton& skeleton, SkinMesh& mesh,
+	int maxInfluences)
+{
+	TextReader reader(text, size);
+	StringView line, token;
+	int vertexCount;
+
+	m_error = NULL;
+	m_errorLine = 0;
+	m_droppedCount = 0;
+
+	// Numarul de vertecsi, pe prima linie care nu e goala
+	do
+	{
+		if (!reader.NextLine(line))
+		{
+			return this->Fail("Missing vertex count", reader.GetLineNumber());
+		}
+	}
+	while (!line.NextToken(token));
+
+	if (!token.ParseInt(vertexCount) || vertexCount < 0 || vertexCount > MESHTEXT_MAX_VERTICES)
+	{
+		return this->Fail("Invalid vertex count", reader.GetLineNumber());
+	}
+
+	mesh.Resize(vertexCount, maxInfluences);
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		StringView x, y;
+		float px, py;
+
+		if (!reader.NextLine(line))
+		{
+			return this->Fail("Missing vertices", reader.GetLineNumber());
+		}
+
+		int number = reader.GetLineNumber();
+		if (!line.NextToken(x) || !x.ParseFloat(px) || !line.NextToken(y) || !y.ParseFloat(py))
+		{
+			return this->Fail("Invalid vertex position", number);
+		}
+		mesh.SetPosition(i, px, py);
+
+		// Perechi nume greutate; acelasi os de doua ori isi aduna greutatile
+		m_bones.clear();
+		m_weights.clear();
+		float total = 0.0f;
+
+		while (line.NextToken(token))
+		{
+			char name[BONE_NAME_LENGTH];
+			StringView weightToken;
+			float weight;
+
+			token.Copy(name, sizeof(name));
+			int bone = skeleton.FindBone(name);
+			if (bone < 0)
+			{
+				return this->Fail("Unknown bone", number);
+			}
+
+			if (!line.NextToken(weightToken) || !weightToken.ParseFloat(weight) ||
+				!(weight >= 0.0f && weight <= 1e30f))
+			{
+				return this->Fail("Invalid bone weight", number);
+			}
+
+			size_t k = 0;
+			while (k < m_bones.size() && m_bones[k] != bone)
+			{
+				k++;
+			}
+			if (k == m_bones.size())
+			{
+				m_bones.push_back(bone);
+				m_weights.push_back(weight);
+			}
+			else
+			{
+				m_weights[k] += weight;
+			}
+
+			total += weight;
+		}
+
+		if (!(total > 0.0f))
+		{
+			return this->Fail("Vertex has no bone weights", number);
+		}
+
+		// SetInfluences pastreaza cele mai mari greutati nenule
+		int used = 0;
+		for (size_t k = 0; k < m_weights.size(); k++)
+		{
+			used += m_weights[k] > 0.0f;
+		}
+		if (used > maxInfluences)
+		{
+			m_droppedCount += used - maxInfluences;
+		}
+
+		if (!mesh.SetInfluences(i, &m_bones[0], &m_weights[0], (int)m_bones.size()))
+		{
+			return this->Fail("Bone doesn't fit the influence format", number);
+		}
+	}
+
+	return true;
+}
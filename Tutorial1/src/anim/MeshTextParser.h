@@ -0,0 +1,64 @@
+#ifndef MESHTEXTPARSER_H_
+#define MESHTEXTPARSER_H_
+
+#include <stddef.h>
+#include <vector>
+#include <Skeleton.h>
+#include <Skinning.h>
+
+/**
+ * Citeste un mesh din formatul text (mesh.txt): pe prima linie numarul
+ * de vertecsi, apoi cate o linie pe vertex, cu pozitia si perechi
+ * nume-os greutate. Numele sunt rezolvate la indecsi in schelet o
+ * singura data, la citire, iar influentele sunt verificate: oasele
+ * necunoscute, greutatile negative sau vertecsii fara nicio greutate
+ * sunt erori, iar acelasi os repetat pe un vertex isi aduna greutatile.
+ * Greutatile sunt normalizate de SkinMesh::SetInfluences()
+ */
+class MeshTextParser
+{
+private:
+	/**
+	* Influentele vertexului curent
+	*/
+	std::vector<int> m_bones;
+	std::vector<float> m_weights;
+
+	const char* m_error;
+	int m_errorLine;
+
+	/**
+	* Influente renuntate, peste numarul maxim pe vertex
+	*/
+	int m_droppedCount;
+
+	bool Fail(const char* error, int line);
+
+	// Nu copiem parserele
+	MeshTextParser(const MeshTextParser&);
+	MeshTextParser& operator=(const MeshTextParser&);
+
+public:
+	MeshTextParser();
+
+	/**
+	* Citeste size octeti de text in mesh, cu cel mult maxInfluences
+	* influente pe vertex (se pastreaza cele mai mari). Intoarce false la
+	* prima linie gresita; vezi GetError()/GetErrorLine()
+	*/
+	bool Parse(const char* text, size_t size, const Skeleton& skeleton, SkinMesh& mesh,
+		int maxInfluences = SKIN_INFLUENCES);
+
+	/**
+	* Descrierea ultimei erori si linia ei (de la 1), sau NULL
+	*/
+	const char* GetError() const { return m_error; }
+	int GetErrorLine() const { return m_errorLine; }
+
+	/**
+	* Cate influente nu au incaput in formatul mesh-ului la ultimul Parse()
+	*/
+	int GetDroppedCount() const { return m_droppedCount; }
+};
+
+#endif /*MESHTEXTPARSER_H_*/
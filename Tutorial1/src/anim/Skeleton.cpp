@@ -0,0 +1,240 @@
+#include <string.h>
+#include "Skeleton.h"
+
+/**
+ * Realoca un tablou pastrand primele count elemente
+ */
+template <class T>
+static void GrowArray(T*& array, int count, int capacity)
+{
+	T* grown = new T[capacity];
+	if (count)
+	{
+		memcpy(grown, array, count * sizeof(T));
+	}
+	delete[] array;
+	array = grown;
+}
+
+Skeleton::Skeleton() :
+	m_boneCount(0), m_capacity(0), m_parent(NULL),
+	m_x(NULL), m_y(NULL), m_angle(NULL), m_length(NULL),
+	m_world(NULL), m_flags(NULL), m_name(NULL), m_firstChild(NULL), m_nextSibling(NULL),
+	m_external(false)
+{
+}
+
+void Skeleton::Reserve(int capacity)
+{
+	if (capacity <= m_capacity)
+	{
+		return;
+	}
+
+	GrowArray(m_parent, m_boneCount, capacity);
+	GrowArray(m_x, m_boneCount, capacity);
+	GrowArray(m_y, m_boneCount, capacity);
+	GrowArray(m_angle, m_boneCount, capacity);
+	GrowArray(m_length, m_boneCount, capacity);
+	GrowArray(m_world, m_boneCount, capacity);
+	GrowArray(m_flags, m_boneCount, capacity);
+	GrowArray(m_firstChild, m_boneCount, capacity);
+	GrowArray(m_nextSibling, m_boneCount, capacity);
+
+	// Tabloul de nume nu merge cu GrowArray
+	char (*name)[BONE_NAME_LENGTH] = new char[capacity][BONE_NAME_LENGTH];
+	if (m_boneCount)
+	{
+		memcpy(name, m_name, m_boneCount * sizeof(*name));
+	}
+	delete[] m_name;
+	m_name = name;
+
+	m_capacity = capacity;
+}
+
+int Skeleton::AddBone(int parent, float x, float y, float angle, float length,
+					  uint8_t flags, const char* name)
+{
+	// Parintele trebuie sa existe deja, altfel nu mai avem ordinea
+	// parinte-inaintea-copilului
+	if (parent < -1 || parent >= m_boneCount || m_external)
+	{
+		return -1;
+	}
+
+	if (m_boneCount == m_capacity)
+	{
+		this->Reserve(m_capacity ? m_capacity * 2 : 16);
+	}
+
+	int bone = m_boneCount++;
+
+	m_parent[bone] = parent;
+	m_x[bone] = x;
+	m_y[bone] = y;
+	m_angle[bone] = angle;
+	m_length[bone] = length;
+	m_world[bone] = Affine2::Identity();
+
+	m_flags[bone] = flags;
+	strncpy(m_name[bone], name ? name : "Bone", BONE_NAME_LENGTH - 1);
+	m_name[bone][BONE_NAME_LENGTH - 1] = '\0';
+
+	// Legam osul la sfarsitul listei de copii a parintelui,
+	// ca sa pastram ordinea din fisier
+	m_firstChild[bone] = -1;
+	m_nextSibling[bone] = -1;
+	if (parent >= 0)
+	{
+		if (m_firstChild[parent] < 0)
+		{
+			m_firstChild[parent] = bone;
+		}
+		else
+		{
+			int sibling = m_firstChild[parent];
+			while (m_nextSibling[sibling] >= 0)
+			{
+				sibling = m_nextSibling[sibling];
+			}
+			m_nextSibling[sibling] = bone;
+		}
+	}
+
+	return bone;
+}
+
+void Skeleton::Free()
+{
+	// Tablourile atasate nu sunt ale noastre
+	if (!m_external)
+	{
+		delete[] m_parent;
+		delete[] m_x;
+		delete[] m_y;
+		delete[] m_angle;
+		delete[] m_length;
+		delete[] m_world;
+		delete[] m_flags;
+		delete[] m_name;
+		delete[] m_firstChild;
+		delete[] m_nextSibling;
+	}
+
+	m_parent = m_firstChild = m_nextSibling = NULL;
+	m_x = m_y = m_angle = m_length = NULL;
+	m_world = NULL;
+	m_flags = NULL;
+	m_name = NULL;
+	m_capacity = 0;
+	m_external = false;
+}
+
+void Skeleton::Clear()
+{
+	// Un schelet atasat revine la tablourile proprii, goale
+	if (m_external)
+	{
+		this->Free();
+	}
+
+	m_boneCount = 0;
+}
+
+void Skeleton::Attach(const SkeletonData& data)
+{
+	this->Free();
+
+	// Legaturile si numele sunt doar citite; AddBone refuza scheletele atasate
+	m_boneCount = data.boneCount;
+	m_parent = const_cast<int*>(data.parent);
+	m_x = data.x;
+	m_y = data.y;
+	m_angle = data.angle;
+	m_length = data.length;
+	m_world = data.world;
+	m_flags = const_cast<uint8_t*>(data.flags);
+	m_name = const_cast<char (*)[BONE_NAME_LENGTH]>(data.name);
+	m_firstChild = const_cast<int*>(data.firstChild);
+	m_nextSibling = const_cast<int*>(data.nextSibling);
+	m_external = true;
+}
+
+bool Skeleton::MoveToArena(Arena& arena)
+{
+	int n = m_boneCount;
+	SkeletonData data;
+
+	data.boneCount = n;
+	data.parent = arena.CopyArray(m_parent, n);
+	data.x = arena.CopyArray(m_x, n);
+	data.y = arena.CopyArray(m_y, n);
+	data.angle = arena.CopyArray(m_angle, n);
+	data.length = arena.CopyArray(m_length, n);
+	data.world = arena.CopyArray(m_world, n);
+	data.flags = arena.CopyArray(m_flags, n);
+	data.name = arena.CopyArray(m_name, n);
+	data.firstChild = arena.CopyArray(m_firstChild, n);
+	data.nextSibling = arena.CopyArray(m_nextSibling, n);
+
+	if (!data.parent || !data.x || !data.y || !data.angle || !data.length || !data.world ||
+		!data.flags || !data.name || !data.firstChild || !data.nextSibling)
+	{
+		return false;
+	}
+
+	this->Attach(data);
+	return true;
+}
+
+int Skeleton::FindBone(const char* name) const
+{
+	for (int i = 0; i < m_boneCount; i++)
+	{
+		if (!strcmp(m_name[i], name))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+Pose Skeleton::GetPose()
+{
+	Pose pose;
+
+	pose.boneCount = m_boneCount;
+	pose.x = m_x;
+	pose.y = m_y;
+	pose.angle = m_angle;
+	pose.length = m_length;
+
+	return pose;
+}
+
+void Skeleton::ComputeWorld()
+{
+	for (int i = 0; i < m_boneCount; i++)
+	{
+		int parent = m_parent[i];
+
+		if (parent < 0)
+		{
+			m_world[i] = Affine2::RotationTranslation(m_angle[i], m_x[i], m_y[i]);
+		}
+		else
+		{
+			// Parintele este deja calculat: pornim de la capatul lui
+			m_world[i] = m_world[parent];
+			m_world[i].Translate(m_length[parent] + m_x[i], m_y[i]);
+			m_world[i].Rotate(m_angle[i]);
+		}
+	}
+}
+
+Skeleton::~Skeleton()
+{
+	this->Free();
+}
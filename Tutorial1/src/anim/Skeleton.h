@@ -0,0 +1,195 @@
+#ifndef SKELETON_H_
+#define SKELETON_H_
+
+#include <Types.h>
+#include <Affine2.h>
+#include <Arena.h>
+
+/**
+ * Lungimea maxima a numelui unui os, cu tot cu terminator
+ */
+#define BONE_NAME_LENGTH	20
+
+/**
+ * Poza unui schelet: tablourile cu transformarile locale, indexate dupa os.
+ * Nu detine memoria; este doar o vedere asupra tablourilor
+ */
+struct Pose
+{
+	int boneCount;
+	float* x;
+	float* y;
+	float* angle;
+	float* length;
+};
+
+/**
+ * Vedere asupra tablourilor unui schelet, pentru folosirea lui direct din
+ * date statice (Skeleton::Attach). Poza si paleta sunt modificate la
+ * animatie, deci tablourile lor nu pot fi constante
+ */
+struct SkeletonData
+{
+	int boneCount;
+	const int* parent;
+
+	float* x;
+	float* y;
+	float* angle;
+	float* length;
+	Affine2* world;
+
+	const uint8_t* flags;
+	const char (*name)[BONE_NAME_LENGTH];
+	const int* firstChild;
+	const int* nextSibling;
+};
+
+/**
+ * Schelet stocat ca structure-of-arrays: fiecare camp al oaselor
+ * este intr-un tablou separat, indexat dupa os. Oasele sunt in ordine
+ * parinte-inaintea-copilului, fiecare cu indexul parintelui sau.
+ *
+ * Datele folosite la fiecare cadru (unghi, lungime, pozitie, paleta)
+ * sunt separate de cele reci (nume, flag-uri, legaturi intre frati),
+ * astfel incat animarea si calculul pozei ating doar cateva linii de cache
+ * pe os. Transformarile globale (paleta) se calculeaza o singura data pe
+ * cadru, intr-o singura trecere (ComputeWorld)
+ */
+class Skeleton
+{
+private:
+	/**
+	* Numarul de oase si capacitatea tablourilor
+	*/
+	int m_boneCount;
+	int m_capacity;
+
+	/**
+	* Indexul parintelui pentru fiecare os; -1 pentru radacina.
+	* Mereu m_parent[i] < i
+	*/
+	int* m_parent;
+
+	/**
+	* Transformarile locale, relative la capatul parintelui
+	*/
+	float* m_x;
+	float* m_y;
+	float* m_angle;
+	float* m_length;
+
+	/**
+	* Paleta: transformarea globala a punctului de start al fiecarui os,
+	* rotita de-a lungul osului
+	*/
+	Affine2* m_world;
+
+	/**
+	* Date reci: flag-uri, nume, primul copil si urmatorul frate (-1 daca nu exista)
+	*/
+	uint8_t* m_flags;
+	char (*m_name)[BONE_NAME_LENGTH];
+	int* m_firstChild;
+	int* m_nextSibling;
+
+	/**
+	* Tablourile sunt ale altcuiva (Attach); oasele nu pot fi adaugate
+	*/
+	bool m_external;
+
+	/**
+	* Mareste tablourile ca sa incapa cel putin capacity oase
+	*/
+	void Reserve(int capacity);
+
+	/**
+	* Elibereaza tablourile detinute
+	*/
+	void Free();
+
+	// Nu copiem scheletele
+	Skeleton(const Skeleton&);
+	Skeleton& operator=(const Skeleton&);
+
+public:
+	Skeleton();
+
+	/**
+	* Adauga un os si intoarce indexul lui; parintele trebuie sa fi fost
+	* adaugat inainte (sau -1 pentru radacina). Intoarce -1 la eroare
+	*/
+	int AddBone(int parent, float x, float y, float angle, float length,
+		uint8_t flags = 0, const char* name = NULL);
+
+	/**
+	* Sterge toate oasele; un schelet atasat revine la tablourile proprii
+	*/
+	void Clear();
+
+	/**
+	* Foloseste direct tablourile existente, fara copiere si fara alocari
+	* (de ex. un schelet compilat in program, vezi AssetCompiler); ele
+	* trebuie sa ramana valide cat timp scheletul este folosit. Scheletul
+	* se animeaza normal, dar nu i se mai pot adauga oase pana la Clear()
+	*/
+	void Attach(const SkeletonData& data);
+
+	bool IsAttached() const { return m_external; }
+
+	/**
+	* Muta tablourile scheletului in arena si se ataseaza la copia lor
+	* (vezi Attach); memoria se elibereaza apoi odata cu arena. Intoarce
+	* false daca arena nu mai are memorie
+	*/
+	bool MoveToArena(Arena& arena);
+
+	/**
+	* Cauta un os dupa nume; intoarce -1 daca nu exista
+	*/
+	int FindBone(const char* name) const;
+
+	int GetBoneCount() const { return m_boneCount; }
+
+	// Accesul la tablourile cu date, indexate dupa os
+	const int* GetParents() const { return m_parent; }
+	float* GetX() { return m_x; }
+	float* GetY() { return m_y; }
+	float* GetAngles() { return m_angle; }
+	float* GetLengths() { return m_length; }
+	const float* GetX() const { return m_x; }
+	const float* GetY() const { return m_y; }
+	const float* GetAngles() const { return m_angle; }
+	const float* GetLengths() const { return m_length; }
+
+	int GetParent(int bone) const { return m_parent[bone]; }
+	uint8_t GetFlags(int bone) const { return m_flags[bone]; }
+	const char* GetName(int bone) const { return m_name[bone]; }
+	int GetFirstChild(int bone) const { return m_firstChild[bone]; }
+	int GetNextSibling(int bone) const { return m_nextSibling[bone]; }
+
+	/**
+	* Poza curenta, ca vedere asupra tablourilor scheletului
+	*/
+	Pose GetPose();
+
+	/**
+	* Transformarea globala calculata la ultimul ComputeWorld()
+	*/
+	const Affine2& GetWorld(int bone) const { return m_world[bone]; }
+
+	/**
+	* Intreaga paleta de transformari globale, indexata dupa os
+	*/
+	const Affine2* GetPalette() const { return m_world; }
+	Affine2* GetPalette() { return m_world; }
+
+	/**
+	* Forward kinematics: calculeaza paleta intr-o singura trecere
+	*/
+	void ComputeWorld();
+
+	~Skeleton();
+};
+
+#endif /*SKELETON_H_*/
@@ -0,0 +1,314 @@
+#include <string.h>
+#include <Log.h>
+#include <StringView.h>
+#include <TextReader.h>
+#include <Thread.h>
+#include "SkeletonTextParser.h"
+
+static inline bool IsSpace(char c)
+{
+	return (unsigned char)c <= ' ';
+}
+
+/**
+ * Citeste urmatorul cuvant al liniei ca numar
+ */
+static bool NextFloat(StringView& line, float& value)
+{
+	StringView token;
+	return line.NextToken(token) && token.ParseFloat(value);
+}
+
+static bool NextInt(StringView& line, int& value)
+{
+	StringView token;
+	return line.NextToken(token) && token.ParseInt(value);
+}
+
+SkeletonTextParser::SkeletonTextParser() : m_error(NULL), m_errorLine(0)
+{
+}
+
+bool SkeletonTextParser::Fail(const char* error, int line)
+{
+	m_error = error;
+	m_errorLine = line;
+	return false;
+}
+
+bool SkeletonTextParser::ReadLines(const char* text, size_t size)
+{
+	TextReader reader(text, size);
+	StringView line, token;
+
+	while (reader.NextLine(line))
+	{
+		// Liniile goale se sar
+		if (!line.NextToken(token))
+		{
+			continue;
+		}
+
+		BoneLine bone;
+		bone.line = reader.GetLineNumber();
+
+		// Adancimea este data de numarul de '#'; radacina are unul
+		size_t i = 0;
+		while (i < token.length && token.data[i] == '#')
+		{
+			i++;
+		}
+		if (i < token.length)
+		{
+			return this->Fail("Wrong bone depth", bone.line);
+		}
+		bone.depth = (int)token.length - 1;
+
+		if (!NextFloat(line, bone.x) || !NextFloat(line, bone.y) || !NextFloat(line, bone.angle) ||
+			!NextFloat(line, bone.length) || !NextInt(line, bone.flags) || !line.NextToken(token))
+		{
+			return this->Fail("Invalid bone", bone.line);
+		}
+		token.Copy(bone.name, sizeof(bone.name));
+
+		// Restul liniei sunt cheile; le impartim in bucati taiate la un spatiu
+		bone.keyStart = 0;
+		bone.keyCount = 0;
+
+		const char* begin = line.data;
+		const char* end = line.data + line.length;
+		while (begin < end)
+		{
+			const char* cut = end - begin > SKELETONTEXT_PIECE_SIZE ? begin + SKELETONTEXT_PIECE_SIZE : end;
+			while (cut < end && !IsSpace(*cut))
+			{
+				cut++;
+			}
+
+			Piece piece;
+			piece.begin = begin;
+			piece.end = cut;
+			piece.bone = (int)m_bones.size();
+			piece.firstToken = 0;
+			piece.tokenCount = 0;
+			piece.failed = false;
+			m_pieces.push_back(piece);
+
+			begin = cut;
+		}
+
+		m_bones.push_back(bone);
+	}
+
+	return true;
+}
+
+size_t SkeletonTextParser::CountTokens(const char* begin, const char* end)
+{
+	// Bucata incepe la un spatiu sau la inceputul cheilor, deci numaram inceputurile de cuvant
+	size_t count = 0;
+	bool space = true;
+
+	for (const char* p = begin; p < end; p++)
+	{
+		bool current = IsSpace(*p);
+		count += space && !current;
+		space = current;
+	}
+
+	return count;
+}
+
+bool SkeletonTextParser::ParsePiece(const Piece& piece)
+{
+	const BoneLine& bone = m_bones[piece.bone];
+	StringView text(piece.begin, piece.end - piece.begin), token;
+
+	// Cuvantul k al liniei este campul k % 3 al cheii k / 3
+	size_t index = piece.firstToken;
+	size_t key = bone.keyStart + index / 3;
+	int field = (int)(index % 3);
+
+	while (text.NextToken(token))
+	{
+		if (field == 0)
+		{
+			int time;
+			if (!token.ParseInt(time) || time < 0)
+			{
+				return false;
+			}
+			m_times[key] = (float)time;
+		}
+		else if (!token.ParseFloat(field == 1 ? m_angles[key] : m_lengths[key]))
+		{
+			return false;
+		}
+
+		if (++field == 3)
+		{
+			field = 0;
+			key++;
+		}
+	}
+
+	return true;
+}
+
+void SkeletonTextParser::Worker(void* job)
+{
+	Job* work = (Job*)job;
+	SkeletonTextParser* self = work->parser;
+
+	for (size_t i = work->first; i < work->last; i++)
+	{
+		Piece& piece = self->m_pieces[i];
+		if (work->parse)
+		{
+			piece.failed = !self->ParsePiece(piece);
+		}
+		else
+		{
+			piece.tokenCount = CountTokens(piece.begin, piece.end);
+		}
+	}
+}
+
+void SkeletonTextParser::RunPass(bool parse, int threadCount)
+{
+	size_t count = m_pieces.size();
+	if (!count)
+	{
+		return;
+	}
+
+	// Fiecare fir primeste un sir continuu de bucati, cu cam acelasi numar de octeti
+	size_t total = (size_t)(m_pieces[count - 1].end - m_pieces[0].begin);
+	if (threadCount < 1 || total < SKELETONTEXT_PARALLEL_SIZE)
+	{
+		threadCount = 1;
+	}
+
+	std::vector<Job> jobs(threadCount);
+	size_t piece = 0;
+	for (int t = 0; t < threadCount; t++)
+	{
+		size_t limit = total / threadCount * (t + 1);
+		jobs[t].parser = this;
+		jobs[t].parse = parse;
+		jobs[t].first = piece;
+		while (piece < count && (t == threadCount - 1 || (size_t)(m_pieces[piece].begin - m_pieces[0].begin) < limit))
+		{
+			piece++;
+		}
+		jobs[t].last = piece;
+	}
+
+	// Firul curent face primul sir de bucati
+	std::vector<Thread*> threads;
+	for (int t = 1; t < threadCount; t++)
+	{
+		Thread* thread = new Thread();
+		if (!thread->Start(Worker, &jobs[t]))
+		{
+			delete thread;
+			thread = NULL;
+			Worker(&jobs[t]);
+		}
+		threads.push_back(thread);
+	}
+
+	Worker(&jobs[0]);
+
+	for (size_t t = 0; t < threads.size(); t++)
+	{
+		delete threads[t];
+	}
+}
+
+bool SkeletonTextParser::Parse(const char* text, size_t size, Skeleton& skeleton, AnimClip& clip, int threadCount)
+{
+	m_bones.clear();
+	m_pieces.clear();
+	m_error = NULL;
+	m_errorLine = 0;
+
+	skeleton.Clear();
+	clip.Clear();
+
+	if (!this->ReadLines(text, size))
+	{
+		return false;
+	}
+
+	// Numaram cuvintele, ca fiecare bucata sa stie a cata cheie incepe in ea
+	this->RunPass(false, threadCount);
+
+	size_t keyTotal = 0;
+	for (size_t i = 0; i < m_pieces.size(); )
+	{
+		int b = m_pieces[i].bone;
+		BoneLine& bone = m_bones[b];
+		size_t tokens = 0;
+
+		for (; i < m_pieces.size() && m_pieces[i].bone == b; i++)
+		{
+			m_pieces[i].firstToken = tokens;
+			tokens += m_pieces[i].tokenCount;
+		}
+
+		if (tokens % 3)
+		{
+			return this->Fail("Invalid keyframe", bone.line);
+		}
+
+		bone.keyStart = keyTotal;
+		bone.keyCount = tokens / 3;
+		keyTotal += bone.keyCount;
+	}
+
+	m_times.resize(keyTotal);
+	m_angles.resize(keyTotal);
+	m_lengths.resize(keyTotal);
+
+	this->RunPass(true, threadCount);
+
+	for (size_t i = 0; i < m_pieces.size(); i++)
+	{
+		if (m_pieces[i].failed)
+		{
+			return this->Fail("Invalid keyframe", m_bones[m_pieces[i].bone].line);
+		}
+	}
+
+	// Ierarhia: stiva cu ultimul os de pe fiecare nivel; un os prea adanc devine copilul ultimului os
+	std::vector<int> parents;
+
+	for (size_t b = 0; b < m_bones.size(); b++)
+	{
+		const BoneLine& bone = m_bones[b];
+
+		while ((int)parents.size() > bone.depth)
+		{
+			parents.pop_back();
+		}
+
+		int index = skeleton.AddBone(parents.empty() ? -1 : parents.back(), bone.x, bone.y,
+			bone.angle, bone.length, (uint8_t)bone.flags, bone.name);
+		parents.push_back(index);
+
+		if (bone.keyCount)
+		{
+			const float* times = &m_times[bone.keyStart];
+			int count = (int)bone.keyCount;
+
+			if (clip.AddChannel(index, ANIM_TARGET_ANGLE, times, &m_angles[bone.keyStart], count) < 0 ||
+				clip.AddChannel(index, ANIM_TARGET_LENGTH, times, &m_lengths[bone.keyStart], count) < 0)
+			{
+				LogWarning("Keyframes of bone %s are not in time order, ignoring them\n", bone.name);
+			}
+		}
+	}
+
+	return true;
+}
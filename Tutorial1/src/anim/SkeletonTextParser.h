@@ -0,0 +1,141 @@
+#ifndef SKELETONTEXTPARSER_H_
+#define SKELETONTEXTPARSER_H_
+
+#include <stddef.h>
+#include <vector>
+#include <Skeleton.h>
+#include <AnimClip.h>
+
+/**
+ * Cati octeti de chei are o bucata; liniile mai scurte formeaza o
+ * singura bucata, cele mai lungi sunt taiate in mai multe
+ */
+#define SKELETONTEXT_PIECE_SIZE		(64 * 1024)
+
+/**
+ * Sub atatia octeti de chei nu merita pornite fire
+ */
+#define SKELETONTEXT_PARALLEL_SIZE	(256 * 1024)
+
+/**
+ * Citeste un schelet si animatia lui din formatul text (human.txt):
+ * fiecare linie este un os, cu adancimea data de numarul de '#', datele
+ * osului, numele si apoi cheile ca triplete timp unghi lungime.
+ *
+ * Fisierele mari au putine linii, dar foarte lungi, deci citirea se
+ * face in trei treceri: antetele liniilor (serial, fara copiere), apoi
+ * cheile, impartite in bucati aliniate la cuvinte si citite pe mai multe
+ * fire direct in tablourile finale, si la sfarsit ierarhia, refacuta
+ * serial din adancimi. Obiectul pastreaza memoria intre citiri
+ */
+class SkeletonTextParser
+{
+private:
+	/**
+	* O linie: datele osului si unde sunt cheile lui
+	*/
+	struct BoneLine
+	{
+		int depth;
+		float x, y, angle, length;
+		int flags;
+		char name[BONE_NAME_LENGTH];
+		int line;
+
+		// Prima cheie in tablourile comune si numarul de chei
+		size_t keyStart;
+		size_t keyCount;
+	};
+
+	/**
+	* O bucata din sirul de chei al unei linii; incepe la un spatiu sau
+	* la inceputul sirului, deci nu taie cuvinte
+	*/
+	struct Piece
+	{
+		const char* begin;
+		const char* end;
+		int bone;
+
+		// Indexul primului cuvant in linie si numarul de cuvinte
+		size_t firstToken;
+		size_t tokenCount;
+
+		bool failed;
+	};
+
+	/**
+	* Ce face un fir: o trecere peste bucatile [first, last)
+	*/
+	struct Job
+	{
+		SkeletonTextParser* parser;
+		bool parse;
+		size_t first;
+		size_t last;
+	};
+
+	std::vector<BoneLine> m_bones;
+	std::vector<Piece> m_pieces;
+
+	/**
+	* Cheile tuturor oaselor, ca structure-of-arrays
+	*/
+	std::vector<float> m_times;
+	std::vector<float> m_angles;
+	std::vector<float> m_lengths;
+
+	const char* m_error;
+	int m_errorLine;
+
+	/**
+	* Prima trecere: citeste antetele si imparte cheile in bucati
+	*/
+	bool ReadLines(const char* text, size_t size);
+
+	/**
+	* Ruleaza o trecere peste toate bucatile, pe threadCount fire
+	*/
+	void RunPass(bool parse, int threadCount);
+
+	static void Worker(void* job);
+
+	/**
+	* Numara cuvintele unei bucati
+	*/
+	static size_t CountTokens(const char* begin, const char* end);
+
+	/**
+	* Citeste cheile unei bucati in tablourile comune
+	*/
+	bool ParsePiece(const Piece& piece);
+
+	bool Fail(const char* error, int line);
+
+	// Nu copiem parserele
+	SkeletonTextParser(const SkeletonTextParser&);
+	SkeletonTextParser& operator=(const SkeletonTextParser&);
+
+public:
+	SkeletonTextParser();
+
+	/**
+	* Citeste size octeti de text in skeleton si clip (golite inainte),
+	* folosind threadCount fire (1 citeste totul pe firul curent). Intoarce
+	* false la prima linie gresita; vezi GetError()/GetErrorLine()
+	*/
+	bool Parse(const char* text, size_t size, Skeleton& skeleton, AnimClip& clip, int threadCount = 1);
+
+	/**
+	* Descrierea ultimei erori si linia ei (de la 1), sau NULL
+	*/
+	const char* GetError() const { return m_error; }
+	int GetErrorLine() const { return m_errorLine; }
+
+	/**
+	* Numarul de chei citite de ultimul Parse()
+	*/
+	size_t GetKeyCount() const { return m_times.size(); }
+};
+
+#endif /*SKELETONTEXTPARSER_H_*/
@@ -0,0 +1,591 @@
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <CpuInfo.h>
+#include "Skinning.h"
+
+#if defined(CPU_X86)
+#include <emmintrin.h>
+#endif
+#if defined(CPU_COMPILER_AVX2)
+#include <immintrin.h>
+#endif
+
+/**
+ * Cu GCC/Clang functiile cu instructiuni SSE2/AVX2 trebuie marcate,
+ * ca sa nu compilam tot fisierul cu -mavx2
+ */
+#if defined(__GNUC__)
+#define SKIN_TARGET_SSE2 __attribute__((target("sse2")))
+#define SKIN_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SKIN_TARGET_SSE2
+#define SKIN_TARGET_AVX2
+#endif
+
+/**
+ * Kernelurile SIMD citesc paleta ca pe un tablou de float-uri,
+ * cate 6 pe matrice (a, b, c, d, tx, ty)
+ */
+typedef char AssertAffine2Size[sizeof(Affine2) == 6 * sizeof(float) ? 1 : -1];
+
+typedef void (*SkinFunction)(const Affine2*, const SkinStream&, float*, float*);
+
+/**
+ * Factorul de conversie a greutatilor cuantizate in float
+ */
+static const float s_weightScale = 1.0f / SKIN_WEIGHT_ONE;
+
+static SkinPath s_path = SKIN_PATH_SCALAR;
+static SkinFunction s_skin = NULL;
+
+/**
+ * Skinning pentru vertecsii [first, last), cate unul
+ */
+static void SkinRange(const Affine2* palette, const SkinStream& stream,
+					  float* outX, float* outY, int first, int last)
+{
+	const int n = stream.vertexCount;
+
+	for (int i = first; i < last; i++)
+	{
+		float a = 0.0f, b = 0.0f, c = 0.0f, d = 0.0f, tx = 0.0f, ty = 0.0f;
+
+		// Amestecam matricile oaselor, ponderate
+		for (int k = 0; k < SKIN_INFLUENCES; k++)
+		{
+			const Affine2& m = palette[stream.bone[k * n + i]];
+			float w = stream.weight[k * n + i] * s_weightScale;
+
+			a += w * m.a;
+			b += w * m.b;
+			c += w * m.c;
+			d += w * m.d;
+			tx += w * m.tx;
+			ty += w * m.ty;
+		}
+
+		float x = stream.x[i], y = stream.y[i];
+		outX[i] = a * x + c * y + tx;
+		outY[i] = b * x + d * y + ty;
+	}
+}
+
+void SkinVerticesScalar(const Affine2* palette, const SkinStream& stream, float* outX, float* outY)
+{
+	SkinRange(palette, stream, outX, outY, 0, stream.vertexCount);
+}
+
+#if defined(CPU_X86)
+
+SKIN_TARGET_SSE2
+void SkinVerticesSSE2(const Affine2* palette, const SkinStream& stream, float* outX, float* outY)
+{
+	const int n = stream.vertexCount;
+	const float* pal = (const float*)palette;
+	const __m128 scale = _mm_set1_ps(s_weightScale);
+	const __m128i zero = _mm_setzero_si128();
+	int i;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m128 a = _mm_setzero_ps(), b = _mm_setzero_ps(), c = _mm_setzero_ps();
+		__m128 d = _mm_setzero_ps(), tx = _mm_setzero_ps(), ty = _mm_setzero_ps();
+
+		for (int k = 0; k < SKIN_INFLUENCES; k++)
+		{
+			const uint8_t* bone = stream.bone + k * n + i;
+
+			// 4 greutati pe 16 biti -> float
+			__m128i w16 = _mm_loadl_epi64((const __m128i*)(stream.weight + k * n + i));
+			__m128 w = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(w16, zero)), scale);
+
+			const float* m0 = pal + 6 * bone[0];
+			const float* m1 = pal + 6 * bone[1];
+			const float* m2 = pal + 6 * bone[2];
+			const float* m3 = pal + 6 * bone[3];
+
+			// Transpunem a, b, c, d ale celor 4 matrici
+			__m128 r0 = _mm_loadu_ps(m0), r1 = _mm_loadu_ps(m1);
+			__m128 r2 = _mm_loadu_ps(m2), r3 = _mm_loadu_ps(m3);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			// Translatiile: [tx0 ty0 tx1 ty1] si [tx2 ty2 tx3 ty3]
+			__m128 t01 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(m0 + 4)), (const __m64*)(m1 + 4));
+			__m128 t23 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(m2 + 4)), (const __m64*)(m3 + 4));
+
+			a = _mm_add_ps(a, _mm_mul_ps(w, r0));
+			b = _mm_add_ps(b, _mm_mul_ps(w, r1));
+			c = _mm_add_ps(c, _mm_mul_ps(w, r2));
+			d = _mm_add_ps(d, _mm_mul_ps(w, r3));
+			tx = _mm_add_ps(tx, _mm_mul_ps(w, _mm_shuffle_ps(t01, t23, _MM_SHUFFLE(2, 0, 2, 0))));
+			ty = _mm_add_ps(ty, _mm_mul_ps(w, _mm_shuffle_ps(t01, t23, _MM_SHUFFLE(3, 1, 3, 1))));
+		}
+
+		__m128 x = _mm_loadu_ps(stream.x + i), y = _mm_loadu_ps(stream.y + i);
+		_mm_storeu_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x), _mm_mul_ps(c, y)), tx));
+		_mm_storeu_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(b, x), _mm_mul_ps(d, y)), ty));
+	}
+
+	// Vertecsii ramasi
+	SkinRange(palette, stream, outX, outY, i, n);
+}
+
+#else
+
+void SkinVerticesSSE2(const Affine2* palette, const SkinStream& stream, float* outX, float* outY)
+{
+	SkinVerticesScalar(palette, stream, outX, outY);
+}
+
+#endif
+
+#if defined(CPU_COMPILER_AVX2)
+
+SKIN_TARGET_AVX2
+void SkinVerticesAVX2(const Affine2* palette, const SkinStream& stream, float* outX, float* outY)
+{
+	const int n = stream.vertexCount;
+	const float* pal = (const float*)palette;
+	const __m256i six = _mm256_set1_epi32(6);
+	const __m256 scale = _mm256_set1_ps(s_weightScale);
+	int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256 a = _mm256_setzero_ps(), b = _mm256_setzero_ps(), c = _mm256_setzero_ps();
+		__m256 d = _mm256_setzero_ps(), tx = _mm256_setzero_ps(), ty = _mm256_setzero_ps();
+
+		for (int k = 0; k < SKIN_INFLUENCES; k++)
+		{
+			// Offset-ul fiecarei matrici in paleta, in float-uri
+			__m256i bone = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(stream.bone + k * n + i)));
+			__m256i offset = _mm256_mullo_epi32(bone, six);
+
+			// 8 greutati pe 16 biti -> float
+			__m256i w16 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(stream.weight + k * n + i)));
+			__m256 w = _mm256_mul_ps(_mm256_cvtepi32_ps(w16), scale);
+
+			a = _mm256_add_ps(a, _mm256_mul_ps(w, _mm256_i32gather_ps(pal + 0, offset, 4)));
+			b = _mm256_add_ps(b, _mm256_mul_ps(w, _mm256_i32gather_ps(pal + 1, offset, 4)));
+			c = _mm256_add_ps(c, _mm256_mul_ps(w, _mm256_i32gather_ps(pal + 2, offset, 4)));
+			d = _mm256_add_ps(d, _mm256_mul_ps(w, _mm256_i32gather_ps(pal + 3, offset, 4)));
+			tx = _mm256_add_ps(tx, _mm256_mul_ps(w, _mm256_i32gather_ps(pal + 4, offset, 4)));
+			ty = _mm256_add_ps(ty, _mm256_mul_ps(w, _mm256_i32gather_ps(pal + 5, offset, 4)));
+		}
+
+		__m256 x = _mm256_loadu_ps(stream.x + i), y = _mm256_loadu_ps(stream.y + i);
+		_mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, x), _mm256_mul_ps(c, y)), tx));
+		_mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(b, x), _mm256_mul_ps(d, y)), ty));
+	}
+
+	// Compilatorul nu curata registrele AVX inainte de apelul final, iar
+	// codul SSE de dupa (SkinRange, sin/cos din FK) ar plati tranzitia
+	_mm256_zeroupper();
+
+	// Vertecsii ramasi
+	SkinRange(palette, stream, outX, outY, i, n);
+}
+
+#else
+
+void SkinVerticesAVX2(const Affine2* palette, const SkinStream& stream, float* outX, float* outY)
+{
+	SkinVerticesSSE2(palette, stream, outX, outY);
+}
+
+#endif
+
+void SkinVerticesVariable(const Affine2* palette, const SkinStreamVariable& stream, float* outX, float* outY)
+{
+	for (int i = 0; i < stream.vertexCount; i++)
+	{
+		float a = 0.0f, b = 0.0f, c = 0.0f, d = 0.0f, tx = 0.0f, ty = 0.0f;
+
+		for (uint32_t k = stream.first[i]; k < stream.first[i + 1]; k++)
+		{
+			const Affine2& m = palette[stream.bone[k]];
+			float w = stream.weight[k] * s_weightScale;
+
+			a += w * m.a;
+			b += w * m.b;
+			c += w * m.c;
+			d += w * m.d;
+			tx += w * m.tx;
+			ty += w * m.ty;
+		}
+
+		float x = stream.x[i], y = stream.y[i];
+		outX[i] = a * x + c * y + tx;
+		outY[i] = b * x + d * y + ty;
+	}
+}
+
+bool SkinSetPath(SkinPath path)
+{
+	switch (path)
+	{
+	case SKIN_PATH_SCALAR:
+		s_skin = SkinVerticesScalar;
+		break;
+
+#if defined(CPU_X86)
+	case SKIN_PATH_SSE2:
+		if (!CpuInfo::HasSSE2())
+		{
+			return false;
+		}
+		s_skin = SkinVerticesSSE2;
+		break;
+#endif
+
+#if defined(CPU_COMPILER_AVX2)
+	case SKIN_PATH_AVX2:
+		if (!CpuInfo::HasAVX2())
+		{
+			return false;
+		}
+		s_skin = SkinVerticesAVX2;
+		break;
+#endif
+
+	default:
+		return false;
+	}
+
+	s_path = path;
+	return true;
+}
+
+/**
+ * Alege cea mai buna implementare
+ */
+static bool SkinSelectPath()
+{
+	return SkinSetPath(SKIN_PATH_AVX2) || SkinSetPath(SKIN_PATH_SSE2) || SkinSetPath(SKIN_PATH_SCALAR);
+}
+
+/**
+ * Implementarea se alege la initializarea programului, inainte de pornirea
+ * oricarui fir, nu la primul SkinVertices: acesta ruleaza pe mai multe
+ * fire deodata
+ */
+static const bool s_pathSelected = SkinSelectPath();
+
+SkinPath SkinGetPath()
+{
+	return s_path;
+}
+
+void SkinVertices(const Affine2* palette, const SkinStream& stream, float* outX, float* outY)
+{
+	s_skin(palette, stream, outX, outY);
+}
+
+/**
+ * Compara influentele descrescator dupa greutate
+ */
+struct InfluenceGreater
+{
+	const float* weights;
+
+	InfluenceGreater(const float* weights) : weights(weights) {}
+
+	bool operator()(int a, int b) const
+	{
+		return weights[a] > weights[b];
+	}
+};
+
+SkinMesh::SkinMesh() :
+	m_vertexCount(0), m_maxInfluences(SKIN_INFLUENCES), m_x(NULL), m_y(NULL),
+	m_bone(NULL), m_weight(NULL), m_first(NULL), m_varBone(NULL), m_varWeight(NULL),
+	m_varCount(0), m_varCapacity(0), m_varVertices(0), m_external(false),
+	m_externalOutput(false), m_skinnedX(NULL), m_skinnedY(NULL)
+{
+}
+
+void SkinMesh::Free()
+{
+	// Fluxul atasat nu este al nostru
+	if (!m_external)
+	{
+		delete[] m_x;
+		delete[] m_y;
+		delete[] m_bone;
+		delete[] m_weight;
+	}
+	delete[] m_first;
+	delete[] m_varBone;
+	delete[] m_varWeight;
+	if (!m_externalOutput)
+	{
+		delete[] m_skinnedX;
+		delete[] m_skinnedY;
+	}
+
+	m_x = m_y = m_skinnedX = m_skinnedY = NULL;
+	m_bone = NULL;
+	m_weight = m_varBone = m_varWeight = NULL;
+	m_first = NULL;
+	m_external = false;
+	m_externalOutput = false;
+}
+
+void SkinMesh::Resize(int vertexCount, int maxInfluences)
+{
+	this->Free();
+
+	m_vertexCount = vertexCount;
+	m_maxInfluences = maxInfluences;
+	m_x = new float[vertexCount];
+	m_y = new float[vertexCount];
+	m_skinnedX = new float[vertexCount];
+	m_skinnedY = new float[vertexCount];
+
+	memset(m_x, 0, vertexCount * sizeof(float));
+	memset(m_y, 0, vertexCount * sizeof(float));
+
+	if (this->IsVariable())
+	{
+		m_first = new uint32_t[vertexCount + 1];
+		memset(m_first, 0, (vertexCount + 1) * sizeof(uint32_t));
+		m_varCount = 0;
+		m_varCapacity = 0;
+		m_varVertices = 0;
+	}
+	else
+	{
+		m_bone = new uint8_t[vertexCount * SKIN_INFLUENCES];
+		m_weight = new uint16_t[vertexCount * SKIN_INFLUENCES];
+		memset(m_bone, 0, vertexCount * SKIN_INFLUENCES * sizeof(uint8_t));
+		memset(m_weight, 0, vertexCount * SKIN_INFLUENCES * sizeof(uint16_t));
+	}
+}
+
+void SkinMesh::Attach(const SkinStream& stream, float* skinnedX, float* skinnedY)
+{
+	this->Free();
+
+	m_vertexCount = stream.vertexCount;
+	m_maxInfluences = SKIN_INFLUENCES;
+	m_x = const_cast<float*>(stream.x);
+	m_y = const_cast<float*>(stream.y);
+	m_bone = const_cast<uint8_t*>(stream.bone);
+	m_weight = const_cast<uint16_t*>(stream.weight);
+	m_externalOutput = skinnedX && skinnedY;
+	m_skinnedX = m_externalOutput ? skinnedX : new float[m_vertexCount];
+	m_skinnedY = m_externalOutput ? skinnedY : new float[m_vertexCount];
+	m_external = true;
+}
+
+bool SkinMesh::MoveToArena(Arena& arena)
+{
+	if (this->IsVariable())
+	{
+		return false;
+	}
+
+	SkinStream stream = this->GetStream();
+	int n = stream.vertexCount;
+
+	stream.x = arena.CopyArray(stream.x, n);
+	stream.y = arena.CopyArray(stream.y, n);
+	stream.bone = arena.CopyArray(stream.bone, n * SKIN_INFLUENCES);
+	stream.weight = arena.CopyArray(stream.weight, n * SKIN_INFLUENCES);
+	float* skinnedX = arena.CopyArray(m_skinnedX, n);
+	float* skinnedY = arena.CopyArray(m_skinnedY, n);
+
+	if (!stream.x || !stream.y || !stream.bone || !stream.weight || !skinnedX || !skinnedY)
+	{
+		return false;
+	}
+
+	this->Attach(stream, skinnedX, skinnedY);
+	return true;
+}
+
+void SkinMesh::SetPosition(int vertex, float x, float y)
+{
+	if (m_external)
+	{
+		return;
+	}
+
+	m_x[vertex] = x;
+	m_y[vertex] = y;
+}
+
+bool SkinMesh::SetInfluences(int vertex, const int* bones, const float* weights, int count)
+{
+	int maxBones = this->IsVariable() ? 65536 : SKIN_MAX_BONES;
+
+	if (m_external)
+	{
+		return false;
+	}
+
+	// In formatul variabil vertecsii se adauga in ordine
+	if (this->IsVariable() && vertex != m_varVertices)
+	{
+		return false;
+	}
+
+	// Ordonam influentele valide descrescator dupa greutate
+	std::vector<int> order;
+	for (int i = 0; i < count; i++)
+	{
+		if (bones[i] < 0 || weights[i] <= 0.0f)
+		{
+			continue;
+		}
+		if (bones[i] >= maxBones)
+		{
+			return false;
+		}
+		order.push_back(i);
+	}
+	std::sort(order.begin(), order.end(), InfluenceGreater(weights));
+
+	// Pastram doar cele mai mari
+	int n = (int)order.size();
+	if (n > m_maxInfluences)
+	{
+		n = m_maxInfluences;
+	}
+
+	// Renormalizam si cuantizam; diferenta de rotunjire
+	// o punem pe cea mai mare greutate, ca suma sa fie exact SKIN_WEIGHT_ONE
+	float sum = 0.0f;
+	for (int i = 0; i < n; i++)
+	{
+		sum += weights[order[i]];
+	}
+
+	uint16_t quantized[SKIN_INFLUENCES];
+	std::vector<uint16_t> quantizedVar;
+	uint16_t* q = quantized;
+	if (this->IsVariable())
+	{
+		quantizedVar.resize(n > 0 ? n : 1);
+		q = &quantizedVar[0];
+	}
+
+	int total = 0;
+	for (int i = 0; i < n; i++)
+	{
+		q[i] = (uint16_t)(weights[order[i]] / sum * SKIN_WEIGHT_ONE + 0.5f);
+		total += q[i];
+	}
+	if (n)
+	{
+		q[0] = (uint16_t)(q[0] + SKIN_WEIGHT_ONE - total);
+	}
+
+	if (this->IsVariable())
+	{
+		// Marim tablourile daca e nevoie
+		if (m_varCount + n > m_varCapacity)
+		{
+			int capacity = m_varCapacity ? m_varCapacity * 2 : 4 * m_vertexCount + 16;
+			while (capacity < m_varCount + n)
+			{
+				capacity *= 2;
+			}
+
+			uint16_t* bone = new uint16_t[capacity];
+			uint16_t* weight = new uint16_t[capacity];
+			if (m_varCount)
+			{
+				memcpy(bone, m_varBone, m_varCount * sizeof(uint16_t));
+				memcpy(weight, m_varWeight, m_varCount * sizeof(uint16_t));
+			}
+			delete[] m_varBone;
+			delete[] m_varWeight;
+			m_varBone = bone;
+			m_varWeight = weight;
+			m_varCapacity = capacity;
+		}
+
+		m_first[vertex] = m_varCount;
+		for (int i = 0; i < n; i++)
+		{
+			m_varBone[m_varCount] = (uint16_t)bones[order[i]];
+			m_varWeight[m_varCount] = q[i];
+			m_varCount++;
+		}
+		m_first[vertex + 1] = m_varCount;
+		m_varVertices++;
+	}
+	else
+	{
+		for (int k = 0; k < SKIN_INFLUENCES; k++)
+		{
+			m_bone[k * m_vertexCount + vertex] = (uint8_t)(k < n ? bones[order[k]] : 0);
+			m_weight[k * m_vertexCount + vertex] = k < n ? q[k] : 0;
+		}
+	}
+
+	return true;
+}
+
+SkinStream SkinMesh::GetStream() const
+{
+	SkinStream stream;
+
+	stream.vertexCount = m_vertexCount;
+	stream.x = m_x;
+	stream.y = m_y;
+	stream.bone = m_bone;
+	stream.weight = m_weight;
+
+	return stream;
+}
+
+SkinStreamVariable SkinMesh::GetStreamVariable() const
+{
+	SkinStreamVariable stream;
+
+	stream.vertexCount = m_vertexCount;
+	stream.x = m_x;
+	stream.y = m_y;
+	stream.first = m_first;
+	stream.bone = m_varBone;
+	stream.weight = m_varWeight;
+
+	return stream;
+}
+
+int SkinMesh::GetStreamSize() const
+{
+	int size = m_vertexCount * 2 * sizeof(float);
+
+	if (this->IsVariable())
+	{
+		size += (m_vertexCount + 1) * sizeof(uint32_t);
+		size += m_varCount * (sizeof(uint16_t) + sizeof(uint16_t));
+	}
+	else
+	{
+		size += m_vertexCount * SKIN_INFLUENCES * (sizeof(uint8_t) + sizeof(uint16_t));
+	}
+
+	return size;
+}
+
+void SkinMesh::Skin(const Affine2* palette)
+{
+	if (this->IsVariable())
+	{
+		SkinVerticesVariable(palette, this->GetStreamVariable(), m_skinnedX, m_skinnedY);
+	}
+	else
+	{
+		SkinVertices(palette, this->GetStream(), m_skinnedX, m_skinnedY);
+	}
+}
+
+SkinMesh::~SkinMesh()
+{
+	this->Free();
+}
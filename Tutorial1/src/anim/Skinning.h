@@ -0,0 +1,224 @@
+#ifndef SKINNING_H_
+#define SKINNING_H_
+
+#include <Types.h>
+#include <Affine2.h>
+#include <Arena.h>
+
+/**
+ * Numarul fix de influente (oase) pe vertex in formatul compact
+ */
+#define SKIN_INFLUENCES		4
+
+/**
+ * Numarul maxim de oase adresabile in formatul compact (index pe 8 biti)
+ */
+#define SKIN_MAX_BONES		256
+
+/**
+ * Greutatile sunt cuantizate pe 16 biti; suma greutatilor unui vertex
+ * este mereu SKIN_WEIGHT_ONE
+ */
+#define SKIN_WEIGHT_ONE		65535
+
+/**
+ * Fluxul de intrare pentru skinning, in formatul compact: pozitiile in
+ * spatiul de legare si exact SKIN_INFLUENCES influente pe vertex, cu index
+ * de os pe 8 biti si greutate pe 16 biti (20 de octeti pe vertex).
+ * Campurile sunt pe planuri separate (structure-of-arrays), ca sa poata fi
+ * incarcate cate 4/8 vertecsi deodata. Influenta k a vertexului i
+ * se afla la indexul k * vertexCount + i; influentele nefolosite au greutatea 0
+ */
+struct SkinStream
+{
+	int vertexCount;
+	const float* x;
+	const float* y;
+	const uint8_t* bone;	// Indexul osului in paleta
+	const uint16_t* weight;	// Greutatea, in unitati de 1 / SKIN_WEIGHT_ONE
+};
+
+/**
+ * Varianta cu numar variabil de influente pe vertex, pentru mesh-urile
+ * care au nevoie de mai mult de SKIN_INFLUENCES oase sau de mai mult de
+ * SKIN_MAX_BONES oase. Influentele vertexului i sunt in intervalul
+ * [first[i], first[i + 1]) al tablourilor bone si weight
+ */
+struct SkinStreamVariable
+{
+	int vertexCount;
+	const float* x;
+	const float* y;
+	const uint32_t* first;	// vertexCount + 1 elemente
+	const uint16_t* bone;
+	const uint16_t* weight;
+};
+
+/**
+ * Implementarile disponibile pentru kernelul de skinning
+ */
+enum SkinPath
+{
+	SKIN_PATH_SCALAR,
+	SKIN_PATH_SSE2,
+	SKIN_PATH_AVX2
+};
+
+/**
+ * Linear blend skinning cu paleta de matrici: pentru fiecare vertex,
+ * out = (suma w[k] * palette[bone[k]]) * pozitie. outX/outY trebuie
+ * sa aiba loc pentru stream.vertexCount valori.
+ * Foloseste cea mai buna implementare suportata de procesor
+ */
+void SkinVertices(const Affine2* palette, const SkinStream& stream, float* outX, float* outY);
+
+/**
+ * Implementarile, apelabile direct (de ex. pentru teste de performanta);
+ * SSE2 proceseaza 4 vertecsi pe iteratie, AVX2 8 vertecsi
+ */
+void SkinVerticesScalar(const Affine2* palette, const SkinStream& stream, float* outX, float* outY);
+void SkinVerticesSSE2(const Affine2* palette, const SkinStream& stream, float* outX, float* outY);
+void SkinVerticesAVX2(const Affine2* palette, const SkinStream& stream, float* outX, float* outY);
+
+/**
+ * Skinning pentru fluxul cu numar variabil de influente (doar scalar)
+ */
+void SkinVerticesVariable(const Affine2* palette, const SkinStreamVariable& stream, float* outX, float* outY);
+
+/**
+ * Implementarea folosita de SkinVertices(); la inceput este cea mai buna
+ * suportata de procesor
+ */
+SkinPath SkinGetPath();
+
+/**
+ * Forteaza o implementare (pentru depanare); intoarce false daca
+ * procesorul sau compilatorul nu o suporta
+ */
+bool SkinSetPath(SkinPath path);
+
+/**
+ * Mesh pregatit pentru skinning: detine tablourile fluxului de intrare
+ * (compact sau cu numar variabil de influente) si pozitiile rezultate
+ */
+class SkinMesh
+{
+private:
+	int m_vertexCount;
+
+	/**
+	* Numarul maxim de influente pe vertex; peste SKIN_INFLUENCES
+	* folosim formatul variabil
+	*/
+	int m_maxInfluences;
+
+	float* m_x;
+	float* m_y;
+
+	/**
+	* Formatul compact
+	*/
+	uint8_t* m_bone;
+	uint16_t* m_weight;
+
+	/**
+	* Formatul variabil; influentele se adauga in ordinea vertecsilor
+	*/
+	uint32_t* m_first;
+	uint16_t* m_varBone;
+	uint16_t* m_varWeight;
+	int m_varCount;
+	int m_varCapacity;
+	int m_varVertices;	// Vertecsii setati pana acum
+
+	/**
+	* Fluxul de intrare este al altcuiva (Attach) si nu poate fi modificat
+	*/
+	bool m_external;
+
+	/**
+	* Pozitiile rezultate sunt ale altcuiva (Attach)
+	*/
+	bool m_externalOutput;
+
+	/**
+	* Elibereaza toate tablourile
+	*/
+	void Free();
+
+	/**
+	* Pozitiile calculate la ultimul Skin()
+	*/
+	float* m_skinnedX;
+	float* m_skinnedY;
+
+	// Nu copiem mesh-urile
+	SkinMesh(const SkinMesh&);
+	SkinMesh& operator=(const SkinMesh&);
+
+public:
+	SkinMesh();
+
+	/**
+	* Aloca loc pentru vertexCount vertecsi; toate influentele devin 0.
+	* Cu maxInfluences > SKIN_INFLUENCES se foloseste formatul variabil
+	*/
+	void Resize(int vertexCount, int maxInfluences = SKIN_INFLUENCES);
+
+	/**
+	* Foloseste direct un flux compact existent, fara copiere (de ex. dintr-un
+	* fisier mapat in memorie); tablourile lui trebuie sa ramana valide cat
+	* timp sunt folosite. Pozitiile rezultate se scriu in skinnedX/skinnedY
+	* (cate vertexCount elemente) sau, daca lipsesc, se aloca. Mesh-ul nu
+	* mai poate fi modificat pana la urmatorul Resize()
+	*/
+	void Attach(const SkinStream& stream, float* skinnedX = NULL, float* skinnedY = NULL);
+
+	bool IsAttached() const { return m_external; }
+
+	/**
+	* Muta fluxul compact si pozitiile rezultate in arena si se ataseaza la
+	* copia lor; formatul variabil nu poate fi mutat (intoarce false)
+	*/
+	bool MoveToArena(Arena& arena);
+
+	int GetVertexCount() const { return m_vertexCount; }
+
+	/**
+	* Formatul folosit: compact sau variabil
+	*/
+	bool IsVariable() const { return m_maxInfluences > SKIN_INFLUENCES; }
+
+	void SetPosition(int vertex, float x, float y);
+
+	/**
+	* Seteaza influentele unui vertex: pastreaza cele mai mari
+	* maxInfluences greutati, le renormalizeaza si le cuantizeaza.
+	* In formatul variabil vertecsii trebuie setati in ordine.
+	* Intoarce false daca un os nu poate fi adresat in formatul curent
+	*/
+	bool SetInfluences(int vertex, const int* bones, const float* weights, int count);
+
+	/**
+	* Fluxul de intrare, pentru apelul direct al kernelului
+	*/
+	SkinStream GetStream() const;
+	SkinStreamVariable GetStreamVariable() const;
+
+	/**
+	* Memoria folosita de fluxul de intrare, in octeti
+	*/
+	int GetStreamSize() const;
+
+	/**
+	* Calculeaza pozitiile finale cu paleta data
+	*/
+	void Skin(const Affine2* palette);
+
+	const float* GetSkinnedX() const { return m_skinnedX; }
+	const float* GetSkinnedY() const { return m_skinnedY; }
+
+	~SkinMesh();
+};
+
+#endif /*SKINNING_H_*/
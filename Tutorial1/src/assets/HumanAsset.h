@@ -0,0 +1,250 @@
+/* Generated by AssetCompiler from human.txt and mesh.txt, do not edit.
+* Include it in one source file and call HumanAsset_Attach(); FixedSkeleton<HumanAsset_Topology>
+* computes its poses
+*/
+
+#ifndef HUMANASSET_H_
+#define HUMANASSET_H_
+
+#include <Skeleton.h>
+#include <AnimClip.h>
+#include <Skinning.h>
+#include <FixedSkeleton.h>
+
+FIXED_TOPOLOGY(HumanAsset_Topology, 11)
+FIXED_BONE(HumanAsset_Topology, 0, -1)
+FIXED_BONE(HumanAsset_Topology, 1, 0)
+FIXED_BONE(HumanAsset_Topology, 2, 0)
+FIXED_BONE(HumanAsset_Topology, 3, 2)
+FIXED_BONE(HumanAsset_Topology, 4, 3)
+FIXED_BONE(HumanAsset_Topology, 5, 2)
+FIXED_BONE(HumanAsset_Topology, 6, 5)
+FIXED_BONE(HumanAsset_Topology, 7, 0)
+FIXED_BONE(HumanAsset_Topology, 8, 7)
+FIXED_BONE(HumanAsset_Topology, 9, 0)
+FIXED_BONE(HumanAsset_Topology, 10, 9)
+
+static const int HumanAsset_parent[11] =
+{
+	-1, 0, 0, 2, 3, 2, 5, 0, 7, 0, 9
+};
+
+static float HumanAsset_x[11] =
+{
+	0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 0.0f, 0.0f
+};
+
+static float HumanAsset_y[11] =
+{
+	0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 0.0f, 0.0f
+};
+
+static float HumanAsset_angle[11] =
+{
+	0.0f, 1.57079995f, -1.57079995f, -0.385399997f, -0.300000012f, 0.385399997f,
+	0.0f, 3.74160004f, 0.949999988f, -0.699999988f, 1.5f
+};
+
+static float HumanAsset_length[11] =
+{
+	0.0f, 30.0f, 50.0f, 50.0f, 50.0f, 50.0f,
+	50.0f, 40.0f, 34.0f, 40.0f, 34.0f
+};
+
+static Affine2 HumanAsset_world[11];
+
+static const uint8_t HumanAsset_flags[11] =
+{
+	4, 0, 2, 1, 0, 1, 0, 1, 0, 1, 0
+};
+
+static const char HumanAsset_name[11][BONE_NAME_LENGTH] =
+{
+	"Root",
+	"Head",
+	"Back",
+	"LLeg",
+	"LLeg2",
+	"RLeg",
+	"RLeg2",
+	"LArm",
+	"LArm2",
+	"RArm",
+	"RArm2"
+};
+
+static const int HumanAsset_firstChild[11] =
+{
+	1, -1, 3, 4, -1, 6, -1, 8, -1, 10, -1
+};
+
+static const int HumanAsset_nextSibling[11] =
+{
+	-1, 2, 7, 5, -1, -1, -1, 9, -1, -1, -1
+};
+
+static const int HumanAsset_timelineStart[1] =
+{
+	0
+};
+
+static const int HumanAsset_timelineKeys[1] =
+{
+	9
+};
+
+static const uint32_t HumanAsset_timelineHash[1] =
+{
+	0xC21B9398u
+};
+
+static const int HumanAsset_timelineFirst[1] =
+{
+	0
+};
+
+static const int HumanAsset_timelineLast[1] =
+{
+	14
+};
+
+static const float HumanAsset_times[9] =
+{
+	0.0f, 20.0f, 40.0f, 60.0f, 80.0f, 100.0f,
+	120.0f, 140.0f, 160.0f
+};
+
+static const int HumanAsset_bone[16] =
+{
+	3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8,
+	9, 9, 10, 10
+};
+
+static const uint8_t HumanAsset_target[16] =
+{
+	0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1
+};
+
+static const uint8_t HumanAsset_kind[16] =
+{
+	2, 0, 2, 2, 2, 0, 2, 2, 2, 0, 2, 0, 2, 0, 2, 0
+};
+
+static const int HumanAsset_timeline[16] =
+{
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0
+};
+
+static const int HumanAsset_valueStart[16] =
+{
+	0, 9, 10, 19, 28, 37, 38, 47, 56, 65, 66, 75,
+	76, 85, 86, 95
+};
+
+static const int HumanAsset_nextChannel[16] =
+{
+	2, 5, 3, 4, 6, 9, 7, 8, 10, 11, 12, 13,
+	14, 15, -1, -1
+};
+
+static const float HumanAsset_values[96] =
+{
+	-0.385399997f, -0.285400003f, 0.185399994f, 0.585399985f, 0.385399997f, 0.285400003f,
+	0.0f, -0.285400003f, -0.385399997f, 50.0f, -0.300000012f, -0.800000012f,
+	-1.79999995f, -1.29999995f, 0.0f, -0.285400003f, -0.385399997f, 0.0f,
+	-0.300000012f, 50.0f, 45.0f, 45.0f, 50.0f, 50.0f,
+	50.0f, 50.0f, 50.0f, 50.0f, 0.385399997f, 0.285400003f,
+	0.0f, -0.185399994f, -0.385399997f, -0.185399994f, 0.285400003f, 0.585399985f,
+	0.385399997f, 50.0f, 0.0f, -0.385399997f, -0.285400003f, 0.0f,
+	-0.300000012f, -0.800000012f, -1.79999995f, -1.29999995f, 0.0f, 50.0f,
+	50.0f, 50.0f, 50.0f, 50.0f, 45.0f, 45.0f,
+	50.0f, 50.0f, 3.74160004f, 3.44160008f, 4.44159985f, 4.84159994f,
+	5.48309994f, 5.78310013f, 4.84159994f, 4.14160013f, 3.74160004f, 40.0f,
+	0.949999988f, 0.889999986f, 0.0f, 1.60000002f, 1.5f, 1.29999995f,
+	0.0f, 0.649999976f, 0.949999988f, 34.0f, -0.699999988f, -0.600000024f,
+	-1.60000002f, -2.20000005f, -2.54150009f, -2.84150004f, -2.0f, -1.29999995f,
+	-0.699999988f, 40.0f, 1.5f, 1.10000002f, 0.400000006f, 0.800000012f,
+	1.04999995f, 0.899999976f, 0.400000006f, 1.0f, 1.5f, 34.0f
+};
+
+static const float HumanAsset_meshX[2] =
+{
+	11.0f, 44.0f
+};
+
+static const float HumanAsset_meshY[2] =
+{
+	22.0f, 55.0f
+};
+
+static const uint8_t HumanAsset_meshBone[8] =
+{
+	0, 0, 2, 2, 0, 1, 0, 0
+};
+
+static const uint16_t HumanAsset_meshWeight[8] =
+{
+	43690, 26214, 21845, 26214, 0, 13107, 0, 0
+};
+
+static float HumanAsset_skinnedX[2];
+static float HumanAsset_skinnedY[2];
+
+static void HumanAsset_Attach(Skeleton& skeleton, AnimClip& clip, SkinMesh& mesh)
+{
+	SkeletonData bones;
+	AnimClipData data;
+	SkinStream stream;
+
+	bones.boneCount = 11;
+	bones.parent = HumanAsset_parent;
+	bones.x = HumanAsset_x;
+	bones.y = HumanAsset_y;
+	bones.angle = HumanAsset_angle;
+	bones.length = HumanAsset_length;
+	bones.world = HumanAsset_world;
+	bones.flags = HumanAsset_flags;
+	bones.name = HumanAsset_name;
+	bones.firstChild = HumanAsset_firstChild;
+	bones.nextSibling = HumanAsset_nextSibling;
+	skeleton.Attach(bones);
+
+	data.timelineCount = 1;
+	data.timelineStart = HumanAsset_timelineStart;
+	data.timelineKeys = HumanAsset_timelineKeys;
+	data.timelineHash = HumanAsset_timelineHash;
+	data.timelineFirst = HumanAsset_timelineFirst;
+	data.timelineLast = HumanAsset_timelineLast;
+	data.timeTotal = 9;
+	data.times = HumanAsset_times;
+	data.channelCount = 16;
+	data.bone = HumanAsset_bone;
+	data.target = HumanAsset_target;
+	data.kind = HumanAsset_kind;
+	data.timeline = HumanAsset_timeline;
+	data.valueStart = HumanAsset_valueStart;
+	data.nextChannel = HumanAsset_nextChannel;
+	data.constantFirst = 1;
+	data.constantLast = 15;
+	data.constantCount = 6;
+	data.linearFirst = -1;
+	data.linearLast = -1;
+	data.linearCount = 0;
+	data.valueTotal = 96;
+	data.values = HumanAsset_values;
+	data.keyTotal = 144;
+	data.duration = 160.0f;
+	clip.Attach(data);
+
+	stream.vertexCount = 2;
+	stream.x = HumanAsset_meshX;
+	stream.y = HumanAsset_meshY;
+	stream.bone = HumanAsset_meshBone;
+	stream.weight = HumanAsset_meshWeight;
+	mesh.Attach(stream, HumanAsset_skinnedX, HumanAsset_skinnedY);
+}
+
+#endif /*HUMANASSET_H_*/
@@ -0,0 +1,109 @@
+#include <stdlib.h>
+#include <string.h>
+#include "Arena.h"
+
+/**
+ * Datele unei bucati incep aliniat dupa antet
+ */
+#define ARENA_HEADER_SIZE	((sizeof(Chunk) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+Arena::Arena(size_t chunkSize) : m_chunks(NULL), m_chunkSize(chunkSize), m_used(0), m_capacity(0)
+{
+}
+
+bool Arena::AddChunk(size_t size)
+{
+	// Cererile mari primesc o bucata doar a lor
+	if (size < m_chunkSize)
+	{
+		size = m_chunkSize;
+	}
+
+	Chunk* chunk = (Chunk*)malloc(ARENA_HEADER_SIZE + size);
+	if (!chunk)
+	{
+		return false;
+	}
+
+	chunk->next = m_chunks;
+	chunk->size = size;
+	chunk->used = 0;
+	m_chunks = chunk;
+	m_capacity += size;
+
+	return true;
+}
+
+bool Arena::Reserve(size_t size)
+{
+	// Lasam loc si pentru alinierea primei alocari
+	size += ARENA_ALIGN;
+	if (m_chunks && m_chunks->size - m_chunks->used >= size)
+	{
+		return true;
+	}
+
+	return this->AddChunk(size);
+}
+
+/**
+ * Pozitia, fata de inceputul datelor bucatii, a primului octet liber aliniat
+ */
+static size_t AlignedOffset(const char* data, size_t used, size_t align)
+{
+	size_t address = (size_t)(data + used);
+	return ((address + align - 1) & ~(align - 1)) - (size_t)data;
+}
+
+void* Arena::Allocate(size_t size, size_t align)
+{
+	size_t offset = 0;
+
+	if (m_chunks)
+	{
+		offset = AlignedOffset((char*)m_chunks + ARENA_HEADER_SIZE, m_chunks->used, align);
+	}
+
+	// Bucata noua are loc si pentru alinierea de la inceput
+	if (!m_chunks || offset + size > m_chunks->size)
+	{
+		if (!this->AddChunk(size + align - 1))
+		{
+			return NULL;
+		}
+		offset = AlignedOffset((char*)m_chunks + ARENA_HEADER_SIZE, 0, align);
+	}
+
+	m_chunks->used = offset + size;
+	m_used += size;
+
+	return (char*)m_chunks + ARENA_HEADER_SIZE + offset;
+}
+
+void* Arena::Copy(const void* source, size_t size)
+{
+	void* data = this->Allocate(size);
+	if (data && size)
+	{
+		memcpy(data, source, size);
+	}
+	return data;
+}
+
+void Arena::Release()
+{
+	while (m_chunks)
+	{
+		Chunk* next = m_chunks->next;
+		free(m_chunks);
+		m_chunks = next;
+	}
+
+	m_used = 0;
+	m_capacity = 0;
+}
+
+Arena::~Arena()
+{
+	this->Release();
+}
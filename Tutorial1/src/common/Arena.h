@@ -0,0 +1,111 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stddef.h>
+
+/**
+ * Dimensiunea implicita a unei bucati de memorie a arenei
+ */
+#define ARENA_CHUNK_SIZE	(64 * 1024)
+
+/**
+ * Alinierea implicita; suficienta pentru kernelurile SIMD
+ */
+#define ARENA_ALIGN			16
+
+/**
+ * Alocator liniar: memoria se ia, in ordine, din cateva bucati mari si
+ * nu se elibereaza pe rand, ci toata odata (Release). Un personaj
+ * (scheletul, clipurile si mesh-ul lui) poate sta intr-o singura arena,
+ * deci datele lui sunt continue in memorie, iar descarcarea lui costa
+ * cateva apeluri free, indiferent de numarul de oase.
+ *
+ * Arena nu apeleaza constructori sau destructori: este pentru tablouri
+ * de tipuri simple. Obiectele care folosesc memoria ei trebuie golite
+ * inainte de Release().
+ *
+ * Scheletul, clipul si mesh-ul se muta in arena cu MoveToArena: intai isi
+ * copiaza tablourile in arena si abia apoi se ataseaza la copii (Attach),
+ * pentru ca Attach elibereaza tablourile proprii, deci si sursa copierii
+ */
+class Arena
+{
+private:
+	/**
+	* Antetul unei bucati; datele urmeaza imediat dupa el
+	*/
+	struct Chunk
+	{
+		Chunk* next;
+		size_t size;
+		size_t used;
+	};
+
+	/**
+	* Bucata curenta este prima din lista
+	*/
+	Chunk* m_chunks;
+	size_t m_chunkSize;
+
+	/**
+	* Octetii ceruti de utilizatori si cei alocati de la sistem
+	*/
+	size_t m_used;
+	size_t m_capacity;
+
+	/**
+	* Adauga o bucata cu cel putin size octeti liberi
+	*/
+	bool AddChunk(size_t size);
+
+	// Nu copiem arenele
+	Arena(const Arena&);
+	Arena& operator=(const Arena&);
+
+public:
+	explicit Arena(size_t chunkSize = ARENA_CHUNK_SIZE);
+
+	/**
+	* Pregateste loc pentru inca size octeti intr-o singura bucata, cand
+	* dimensiunea datelor se stie dinainte (de ex. din antetul unui fisier)
+	*/
+	bool Reserve(size_t size);
+
+	/**
+	* Intoarce size octeti aliniati la align (o putere a lui 2), sau NULL
+	* daca sistemul nu mai are memorie
+	*/
+	void* Allocate(size_t size, size_t align = ARENA_ALIGN);
+
+	/**
+	* Un tablou de count elemente, neinitializat
+	*/
+	template <class T>
+	T* AllocateArray(size_t count)
+	{
+		return (T*)this->Allocate(count * sizeof(T));
+	}
+
+	/**
+	* O copie a count elemente de la source
+	*/
+	void* Copy(const void* source, size_t size);
+
+	template <class T>
+	T* CopyArray(const T* source, size_t count)
+	{
+		return (T*)this->Copy(source, count * sizeof(T));
+	}
+
+	/**
+	* Elibereaza toata memoria; pointerii intorsi pana acum nu mai sunt valizi
+	*/
+	void Release();
+
+	size_t GetUsed() const { return m_used; }
+	size_t GetCapacity() const { return m_capacity; }
+
+	~Arena();
+};
+
+#endif /*ARENA_H_*/
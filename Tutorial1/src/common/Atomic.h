@@ -0,0 +1,82 @@
+#ifndef ATOMIC_H_
+#define ATOMIC_H_
+
+/**
+ * Operatii atomice peste intrinsecele compilatorului: Interlocked* pe
+ * Visual Studio si __sync/__atomic pe GCC/Clang. Nu includ windows.h
+ */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_InterlockedExchangeAdd, _InterlockedExchange, _InterlockedCompareExchange, _ReadWriteBarrier)
+#endif
+
+/**
+ * Intreg partajat intre fire. Toate operatiile sunt bariere complete de
+ * memorie: ce a scris un fir inainte de o operatie atomica este vazut de
+ * alt fir dupa ce acesta vede rezultatul ei
+ */
+class AtomicInt
+{
+private:
+	volatile long m_value;
+
+	// Nu copiem valorile atomice
+	AtomicInt(const AtomicInt&);
+	AtomicInt& operator=(const AtomicInt&);
+
+public:
+	explicit AtomicInt(long value = 0) : m_value(value) {}
+
+	/**
+	* Exchange intoarce valoarea veche; CompareExchange scrie value doar daca
+	* valoarea curenta este expected si intoarce valoarea gasita, deci a
+	* reusit daca aceasta este expected. Add, Increment si Decrement intorc
+	* noua valoare
+	*/
+#if defined(_MSC_VER)
+	long Load() const
+	{
+		// Citirile volatile au semantica acquire pe Visual Studio
+		long value = m_value;
+		_ReadWriteBarrier();
+		return value;
+	}
+
+	long Add(long value) { return _InterlockedExchangeAdd(&m_value, value) + value; }
+
+	long Exchange(long value) { return _InterlockedExchange(&m_value, value); }
+
+	long CompareExchange(long expected, long value) { return _InterlockedCompareExchange(&m_value, value, expected); }
+#else
+	long Load() const
+	{
+#if defined(__ATOMIC_SEQ_CST)
+		return __atomic_load_n(&m_value, __ATOMIC_SEQ_CST);
+#else
+		return __sync_fetch_and_add(const_cast<volatile long*>(&m_value), 0);
+#endif
+	}
+
+	long Add(long value) { return __sync_add_and_fetch(&m_value, value); }
+
+	long Exchange(long value)
+	{
+#if defined(__ATOMIC_SEQ_CST)
+		return __atomic_exchange_n(&m_value, value, __ATOMIC_SEQ_CST);
+#else
+		// __sync_lock_test_and_set este doar acquire
+		__sync_synchronize();
+		return __sync_lock_test_and_set(&m_value, value);
+#endif
+	}
+
+	long CompareExchange(long expected, long value) { return __sync_val_compare_and_swap(&m_value, expected, value); }
+#endif
+
+	void Store(long value) { this->Exchange(value); }
+
+	long Increment() { return this->Add(1); }
+	long Decrement() { return this->Add(-1); }
+};
+
+#endif /*ATOMIC_H_*/
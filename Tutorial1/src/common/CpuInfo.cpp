@@ -0,0 +1,95 @@
+#include "CpuInfo.h"
+
+#if defined(CPU_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+/**
+ * Rezultatul cpuid pentru o frunza/subfrunza: eax, ebx, ecx, edx
+ */
+static void Cpuid(int leaf, int subleaf, unsigned int regs[4])
+{
+	regs[0] = regs[1] = regs[2] = regs[3] = 0;
+
+#if defined(CPU_X86)
+#if defined(_MSC_VER)
+	int r[4];
+	__cpuidex(r, leaf, subleaf);
+	regs[0] = r[0];
+	regs[1] = r[1];
+	regs[2] = r[2];
+	regs[3] = r[3];
+#else
+	// Verificam intai ca frunza exista
+	if ((unsigned int)leaf > __get_cpuid_max(0, 0))
+	{
+		return;
+	}
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+#else
+	(void)leaf;
+	(void)subleaf;
+#endif
+}
+
+/**
+ * Registrul XCR0: ce stari salveaza sistemul de operare la schimbarea de context
+ */
+static unsigned int ReadXCR0()
+{
+#if defined(CPU_COMPILER_AVX2)
+#if defined(_MSC_VER)
+	return (unsigned int)_xgetbv(0);
+#else
+	unsigned int eax, edx;
+	__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return eax;
+#endif
+#else
+	return 0;
+#endif
+}
+
+bool CpuInfo::HasSSE2()
+{
+	static int hasSSE2 = -1;
+
+	if (hasSSE2 < 0)
+	{
+		unsigned int regs[4];
+		Cpuid(1, 0, regs);
+		hasSSE2 = (regs[3] >> 26) & 1;
+	}
+
+	return hasSSE2 != 0;
+}
+
+bool CpuInfo::HasAVX2()
+{
+	static int hasAVX2 = -1;
+
+	if (hasAVX2 < 0)
+	{
+		unsigned int regs[4];
+		hasAVX2 = 0;
+
+		// Avem nevoie de OSXSAVE si AVX (ecx, bitii 27 si 28)
+		Cpuid(1, 0, regs);
+		if ((regs[2] & (1 << 27)) && (regs[2] & (1 << 28)))
+		{
+			// Sistemul de operare trebuie sa salveze starea SSE si AVX
+			if ((ReadXCR0() & 6) == 6)
+			{
+				Cpuid(7, 0, regs);
+				hasAVX2 = (regs[1] >> 5) & 1;
+			}
+		}
+	}
+
+	return hasAVX2 != 0;
+}
@@ -0,0 +1,38 @@
+#ifndef CPUINFO_H_
+#define CPUINFO_H_
+
+/**
+ * Compilam cod SIMD doar pe x86/x64
+ */
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define CPU_X86 1
+#endif
+
+/**
+ * Instructiunile AVX2 sunt suportate de compilator incepand cu
+ * Visual Studio 2012 si GCC 4.9/Clang (prin __attribute__((target)))
+ */
+#if defined(CPU_X86) && ((defined(_MSC_VER) && _MSC_VER >= 1700) || defined(__GNUC__))
+#define CPU_COMPILER_AVX2 1
+#endif
+
+/**
+ * Detectia, la rulare, a seturilor de instructiuni ale procesorului;
+ * rezultatul este calculat o singura data si apoi tinut minte
+ */
+class CpuInfo
+{
+public:
+	/**
+	* Procesorul suporta SSE2
+	*/
+	static bool HasSSE2();
+
+	/**
+	* Procesorul si sistemul de operare suporta AVX2
+	* (sistemul trebuie sa salveze registrii YMM)
+	*/
+	static bool HasAVX2();
+};
+
+#endif /*CPUINFO_H_*/
@@ -0,0 +1,83 @@
+#include "FrameScheduler.h"
+#include "Thread.h"
+#include "Timer.h"
+
+FrameScheduler::FrameScheduler(double rate) : m_pending(1), m_active(0)
+{
+	this->SetTargetRate(rate);
+
+	m_next = m_lastTime = Timer::GetSeconds();
+	m_lastProcessTime = Timer::GetProcessSeconds();
+	for (int i = 0; i < 2; i++)
+	{
+		m_time[i] = 0.0;
+		m_processTime[i] = 0.0;
+		m_frames[i] = 0;
+	}
+}
+
+void FrameScheduler::SetTargetRate(double rate)
+{
+	m_period = 1.0 / (rate > 0.0 ? rate : 1.0);
+}
+
+void FrameScheduler::RequestRedraw()
+{
+	m_pending.Store(1);
+}
+
+bool FrameScheduler::WaitForFrame()
+{
+	double now = Timer::GetSeconds();
+
+	this->Measure();
+
+	// Nimic nou: dormim, dar nu mai mult de o perioada, ca intrarea sa
+	// fie tratata repede
+	if (!m_pending.Load())
+	{
+		Thread::Sleep(m_period);
+		return false;
+	}
+
+	if (now < m_next)
+	{
+		Thread::Sleep(m_next - now);
+		now = Timer::GetSeconds();
+	}
+
+	// Un cadru intarziat nu le grabeste pe urmatoarele
+	m_next = m_next + m_period > now ? m_next + m_period : now + m_period;
+	m_pending.Store(0);
+	m_frames[m_active]++;
+
+	return true;
+}
+
+void FrameScheduler::Measure()
+{
+	double now = Timer::GetSeconds(), processNow = Timer::GetProcessSeconds();
+
+	m_time[m_active] += now - m_lastTime;
+	m_processTime[m_active] += processNow - m_lastProcessTime;
+	m_lastTime = now;
+	m_lastProcessTime = processNow;
+}
+
+void FrameScheduler::SetActive(bool active)
+{
+	if ((m_active != 0) == active)
+	{
+		return;
+	}
+
+	this->Measure();
+	m_active = active ? 1 : 0;
+}
+
+double FrameScheduler::GetProcessorUsage(bool active) const
+{
+	int i = active ? 1 : 0;
+
+	return m_time[i] > 0.0 ? m_processTime[i] / m_time[i] : 0.0;
+}
@@ -0,0 +1,83 @@
+#ifndef FRAMESCHEDULER_H_
+#define FRAMESCHEDULER_H_
+
+#include <Atomic.h>
+
+/**
+ * Planifica desenarea: un cadru se deseneaza doar dupa ce ceva s-a
+ * schimbat (RequestRedraw, din orice fir: intrare, animatie, resurse
+ * reincarcate) si cel mult de GetTargetRate() ori pe secunda. Cat timp nu
+ * e nimic de desenat, firul de desenare doarme in loc sa redeseneze
+ * aceeasi imagine.
+ *
+ * Masoara si procesorul folosit de tot procesul, separat pentru starea
+ * activa (de ex. cu animatia pornita) si pentru cea inactiva
+ */
+class FrameScheduler
+{
+private:
+	/**
+	* S-a cerut un cadru care nu a fost inca desenat
+	*/
+	AtomicInt m_pending;
+
+	/**
+	* Secundele dintre doua cadre si cel mai devreme moment al urmatorului
+	*/
+	double m_period;
+	double m_next;
+
+	/**
+	* Starea curenta si, pentru fiecare stare, timpul real, timpul de
+	* procesor si cadrele adunate pana la ultima masurare
+	*/
+	int m_active;
+	double m_lastTime, m_lastProcessTime;
+	double m_time[2], m_processTime[2];
+	int m_frames[2];
+
+	/**
+	* Adauga timpul de la ultima masurare la starea curenta
+	*/
+	void Measure();
+
+	// Nu copiem planificatorul
+	FrameScheduler(const FrameScheduler&);
+	FrameScheduler& operator=(const FrameScheduler&);
+
+public:
+	explicit FrameScheduler(double rate = 60.0);
+
+	void SetTargetRate(double rate);
+	double GetTargetRate() const { return 1.0 / m_period; }
+
+	/**
+	* Cere desenarea unui cadru; se poate apela din orice fir
+	*/
+	void RequestRedraw();
+
+	/**
+	* Apelata in bucla firului de desenare: daca s-a cerut un cadru,
+	* asteapta momentul lui si intoarce true, iar cererea e consumata;
+	* altfel doarme cel mult o perioada si intoarce false
+	*/
+	bool WaitForFrame();
+
+	/**
+	* Starea in care se masoara de acum procesorul folosit
+	*/
+	void SetActive(bool active);
+
+	/**
+	* Procesorul folosit in starea data, ca fractiune dintr-un procesor
+	*/
+	double GetProcessorUsage(bool active) const;
+
+	/**
+	* Secundele petrecute si cadrele desenate in starea data
+	*/
+	double GetTime(bool active) const { return m_time[active ? 1 : 0]; }
+	int GetFrameCount(bool active) const { return m_frames[active ? 1 : 0]; }
+};
+
+#endif /*FRAMESCHEDULER_H_*/
@@ -0,0 +1,424 @@
+#include "JobSystem.h"
+
+/**
+ * De cate ori cauta de lucru un fir liber inainte de a adormi; joburile
+ * unui cadru vin in rafale, iar trezirea unui fir adormit e scumpa
+ */
+#define JOB_SPIN_COUNT		64
+
+#define JOB_QUEUE_MASK		(JOB_QUEUE_SIZE - 1)
+
+#if defined(_MSC_VER)
+#define JOB_THREAD_LOCAL	__declspec(thread)
+#else
+#define JOB_THREAD_LOCAL	__thread
+#endif
+
+struct Job
+{
+	JobFunction function;
+	void* data;
+	int begin, end;
+	Job* parent;
+
+	/**
+	* Functia jobului si copiii neterminati
+	*/
+	AtomicInt unfinished;
+
+	/**
+	* Dependentele neterminate, plus una pana la Run
+	*/
+	AtomicInt pending;
+
+	/**
+	* Joburile care depind de acesta, ca index in pool + 1 (0 = loc inca
+	* nescris); numarul lor devine -1 cand jobul s-a terminat
+	*/
+	AtomicInt successorCount;
+	AtomicInt successors[JOB_MAX_SUCCESSORS];
+};
+
+struct JobSystem::Worker
+{
+	JobSystem* system;
+	int index;
+	Thread thread;
+
+	/**
+	* Coada circulara: proprietarul adauga si scoate la tail, ceilalti
+	* fura de la head. Se modifica doar sub lock; atomice pentru ca
+	* GetJob le compara fara lock, ca sa sara cozile goale
+	*/
+	Mutex lock;
+	Job* queue[JOB_QUEUE_SIZE];
+	AtomicInt head, tail;
+
+	/**
+	* Joburile create de acest fir, pentru alegerea locului din pool
+	*/
+	AtomicInt allocated;
+
+	Worker() : system(NULL), index(0) {}
+
+	bool IsEmpty() const { return head.Load() == tail.Load(); }
+};
+
+/**
+ * Sistemul si firul lui pe care ruleaza firul curent
+ */
+static JOB_THREAD_LOCAL const JobSystem* currentSystem = NULL;
+static JOB_THREAD_LOCAL int currentWorker = 0;
+
+JobSystem::JobSystem() : m_workers(NULL), m_workerCount(0), m_jobs(NULL)
+{
+}
+
+bool JobSystem::Start(int threadCount)
+{
+	this->Stop();
+
+	if (threadCount < 0)
+	{
+		threadCount = Thread::GetProcessorCount() - 1;
+	}
+	if (threadCount > JOB_MAX_WORKERS - 1)
+	{
+		threadCount = JOB_MAX_WORKERS - 1;
+	}
+
+	m_workerCount = threadCount + 1;
+	m_workers = new Worker[m_workerCount];
+	m_jobs = new Job[m_workerCount * JOB_POOL_SIZE];
+	m_queued.Store(0);
+	m_running.Store(1);
+
+	for (int i = 0; i < m_workerCount; i++)
+	{
+		m_workers[i].system = this;
+		m_workers[i].index = i;
+	}
+
+	for (int i = 1; i < m_workerCount; i++)
+	{
+		if (!m_workers[i].thread.Start(WorkerMain, &m_workers[i]))
+		{
+			this->Stop();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void JobSystem::Stop()
+{
+	if (!m_workers)
+	{
+		return;
+	}
+
+	m_running.Store(0);
+	{
+		ScopedLock lock(m_sleepLock);
+		m_wake.Broadcast();
+	}
+
+	for (int i = 1; i < m_workerCount; i++)
+	{
+		m_workers[i].thread.Join();
+	}
+
+	delete[] m_workers;
+	delete[] m_jobs;
+	m_workers = NULL;
+	m_jobs = NULL;
+	m_workerCount = 0;
+}
+
+int JobSystem::GetCurrentWorker() const
+{
+	return currentSystem == this ? currentWorker : 0;
+}
+
+void JobSystem::WorkerMain(void* argument)
+{
+	Worker* worker = (Worker*)argument;
+	JobSystem* system = worker->system;
+	int idle = 0;
+
+	currentSystem = system;
+	currentWorker = worker->index;
+
+	while (system->m_running.Load())
+	{
+		Job* job = system->GetJob(worker->index);
+		if (job)
+		{
+			system->Execute(job);
+			idle = 0;
+			continue;
+		}
+
+		if (++idle < JOB_SPIN_COUNT)
+		{
+			Thread::YieldTime();
+			continue;
+		}
+		idle = 0;
+
+		// Push verifica m_sleeping dupa ce a marit m_queued, deci un job
+		// adaugat intre timp ori este vazut aici, ori ne trezeste
+		ScopedLock lock(system->m_sleepLock);
+		system->m_sleeping.Increment();
+		while (system->m_queued.Load() <= 0 && system->m_running.Load())
+		{
+			system->m_wake.Wait(system->m_sleepLock);
+		}
+		system->m_sleeping.Decrement();
+	}
+}
+
+Job* JobSystem::GetJob(int worker)
+{
+	Worker& own = m_workers[worker];
+	Job* job = NULL;
+
+	// Cozile goale se sar fara blocare; rezultatul se verifica sub mutex
+	if (!own.IsEmpty())
+	{
+		ScopedLock lock(own.lock);
+		if (!own.IsEmpty())
+		{
+			// Serial, joburile ruleaza in ordinea in care au fost adaugate
+			if (m_workerCount == 1)
+			{
+				job = own.queue[(own.head.Increment() - 1) & JOB_QUEUE_MASK];
+			}
+			else
+			{
+				job = own.queue[own.tail.Decrement() & JOB_QUEUE_MASK];
+			}
+		}
+	}
+
+	for (int i = 1; !job && i < m_workerCount; i++)
+	{
+		Worker& victim = m_workers[(worker + i) % m_workerCount];
+		if (victim.IsEmpty())
+		{
+			continue;
+		}
+
+		ScopedLock lock(victim.lock);
+		if (!victim.IsEmpty())
+		{
+			job = victim.queue[(victim.head.Increment() - 1) & JOB_QUEUE_MASK];
+		}
+	}
+
+	if (job)
+	{
+		m_queued.Decrement();
+	}
+
+	return job;
+}
+
+void JobSystem::Push(int worker, Job* job)
+{
+	Worker& own = m_workers[worker];
+	bool queued = false;
+
+	{
+		ScopedLock lock(own.lock);
+		long tail = own.tail.Load();
+		if (tail - own.head.Load() < JOB_QUEUE_SIZE)
+		{
+			own.queue[tail & JOB_QUEUE_MASK] = job;
+			own.tail.Store(tail + 1);
+			queued = true;
+		}
+	}
+
+	// Coada plina: il rulam pe loc
+	if (!queued)
+	{
+		this->Execute(job);
+		return;
+	}
+
+	m_queued.Increment();
+	if (m_sleeping.Load() > 0)
+	{
+		ScopedLock lock(m_sleepLock);
+		m_wake.Signal();
+	}
+}
+
+void JobSystem::Execute(Job* job)
+{
+	if (job->function)
+	{
+		job->function(job->data, job->begin, job->end);
+	}
+
+	this->Finish(job);
+}
+
+void JobSystem::Release(Job* job)
+{
+	if (job->pending.Decrement() == 0)
+	{
+		this->Push(this->GetCurrentWorker(), job);
+	}
+}
+
+void JobSystem::Finish(Job* job)
+{
+	Job* parent = job->parent;
+
+	if (job->unfinished.Decrement() > 0)
+	{
+		return;
+	}
+
+	// Dupa -1, AddDependency nu mai adauga dependente la acest job
+	long count = job->successorCount.Exchange(-1);
+	for (long i = 0; i < count; i++)
+	{
+		// Locul a fost rezervat, dar poate nu a fost scris inca
+		long successor;
+		while ((successor = job->successors[i].Exchange(0)) == 0)
+		{
+			Thread::YieldTime();
+		}
+		this->Release(&m_jobs[successor - 1]);
+	}
+
+	if (parent)
+	{
+		this->Finish(parent);
+	}
+}
+
+Job* JobSystem::Create(JobFunction function, void* data, int begin, int end, Job* parent)
+{
+	int worker = this->GetCurrentWorker();
+	long slot = m_workers[worker].allocated.Increment() & (JOB_POOL_SIZE - 1);
+	Job* job = &m_jobs[worker * JOB_POOL_SIZE + slot];
+
+	job->function = function;
+	job->data = data;
+	job->begin = begin;
+	job->end = end;
+	job->parent = parent;
+	job->unfinished.Store(1);
+	job->pending.Store(1);
+	job->successorCount.Store(0);
+
+	if (parent)
+	{
+		parent->unfinished.Increment();
+	}
+
+	return job;
+}
+
+bool JobSystem::AddDependency(Job* job, Job* before)
+{
+	// Pana la Run, pending nu poate ajunge la 0
+	job->pending.Increment();
+
+	for (;;)
+	{
+		long count = before->successorCount.Load();
+
+		// Terminat deja: nu avem ce astepta
+		if (count < 0)
+		{
+			job->pending.Decrement();
+			return true;
+		}
+
+		if (count >= JOB_MAX_SUCCESSORS)
+		{
+			job->pending.Decrement();
+			return false;
+		}
+
+		if (before->successorCount.CompareExchange(count, count + 1) == count)
+		{
+			before->successors[count].Store((long)(job - m_jobs) + 1);
+			return true;
+		}
+	}
+}
+
+void JobSystem::Run(Job* job)
+{
+	this->Release(job);
+}
+
+bool JobSystem::IsFinished(const Job* job) const
+{
+	return job->unfinished.Load() == 0;
+}
+
+void JobSystem::Wait(const Job* job)
+{
+	int worker = this->GetCurrentWorker();
+
+	while (!this->IsFinished(job))
+	{
+		Job* next = this->GetJob(worker);
+		if (next)
+		{
+			this->Execute(next);
+		}
+		else if (this->IsSerial())
+		{
+			// Nu mai are cine sa-l ruleze: jobul (sau o dependenta) nu a fost trimis
+			return;
+		}
+		else
+		{
+			Thread::YieldTime();
+		}
+	}
+}
+
+void JobSystem::ParallelFor(JobFunction function, void* data, int count, int grain)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	// Cateva bucati pe fir, ca firele care termina repede sa aiba ce fura
+	if (grain <= 0)
+	{
+		grain = count / (m_workerCount * 4);
+	}
+	// Si nu mai multe decat incap in pool
+	int minGrain = (count + JOB_POOL_SIZE / 4 - 1) / (JOB_POOL_SIZE / 4);
+	if (grain < minGrain)
+	{
+		grain = minGrain;
+	}
+
+	Job* root = this->Create(NULL, NULL);
+	for (int begin = 0; begin < count; begin += grain)
+	{
+		int end = count - begin > grain ? begin + grain : count;
+		this->Run(this->Create(function, data, begin, end, root));
+	}
+
+	this->Run(root);
+	this->Wait(root);
+}
+
+JobSystem::~JobSystem()
+{
+	this->Stop();
+}
@@ -0,0 +1,165 @@
+#ifndef JOBSYSTEM_H_
+#define JOBSYSTEM_H_
+
+#include <stddef.h>
+#include <Atomic.h>
+#include <Thread.h>
+
+/**
+ * Cate joburi poate crea un fir inainte ca primele sa fie refolosite;
+ * joburile unui cadru trebuie sa se fi terminat pana atunci
+ */
+#define JOB_POOL_SIZE		4096
+
+/**
+ * Cate joburi pot astepta in coada unui fir; cand coada e plina jobul
+ * se ruleaza pe loc
+ */
+#define JOB_QUEUE_SIZE		1024
+
+/**
+ * Cate joburi pot depinde de acelasi job
+ */
+#define JOB_MAX_SUCCESSORS	8
+
+#define JOB_MAX_WORKERS		64
+
+/**
+ * Functia unui job; primeste datele date la Create si intervalul
+ * [begin, end) de prelucrat (de ex. personajele unei bucati din ParallelFor)
+ */
+typedef void (*JobFunction)(void* data, int begin, int end);
+
+/**
+ * Un job; este opac, definit in JobSystem.cpp
+ */
+struct Job;
+
+/**
+ * Planificator de joburi cu furt de lucru (work stealing): fiecare fir are
+ * coada lui, din care isi ia joburile de la capatul la care le-a adaugat
+ * (cele mai recente, inca in cache), iar un fir fara lucru fura de la
+ * celalalt capat al cozii altui fir. Firul care asteapta un job (Wait)
+ * ruleaza si el joburi intre timp, deci joburile pot crea si astepta alte
+ * joburi.
+ *
+ * Un job se termina cand functia lui si toti copiii lui (creati cu el ca
+ * parinte) s-au terminat. Un job poate depinde de altele (AddDependency):
+ * intra in coada abia cand toate s-au terminat.
+ *
+ * Cu zero fire (Start(0)) joburile ruleaza pe firul care asteapta, in
+ * ordinea in care au fost adaugate: varianta seriala, pentru depanare
+ */
+class JobSystem
+{
+private:
+	/**
+	* Firele si cozile lor; firul 0 este cel care a pornit sistemul si
+	* orice alt fir care nu e al sistemului
+	*/
+	struct Worker;
+	Worker* m_workers;
+	int m_workerCount;
+
+	/**
+	* Joburile, cate JOB_POOL_SIZE pentru fiecare fir
+	*/
+	Job* m_jobs;
+
+	/**
+	* Firele dorm pe m_wake cand nu exista joburi in cozi
+	*/
+	AtomicInt m_queued;
+	AtomicInt m_sleeping;
+	AtomicInt m_running;
+	Mutex m_sleepLock;
+	Condition m_wake;
+
+	/**
+	* Firul sistemului pe care ruleaza apelantul; 0 pentru alte fire
+	*/
+	int GetCurrentWorker() const;
+
+	/**
+	* Ia un job din coada firului sau il fura de la alt fir
+	*/
+	Job* GetJob(int worker);
+
+	void Push(int worker, Job* job);
+
+	void Execute(Job* job);
+
+	/**
+	* Scade numarul de dependente ale unui job si il pune in coada cand
+	* nu mai are niciuna
+	*/
+	void Release(Job* job);
+
+	/**
+	* Marcheaza terminarea unei parti a jobului (functia lui sau un copil)
+	*/
+	void Finish(Job* job);
+
+	static void WorkerMain(void* argument);
+
+	// Nu copiem planificatorul
+	JobSystem(const JobSystem&);
+	JobSystem& operator=(const JobSystem&);
+
+public:
+	JobSystem();
+
+	/**
+	* Porneste threadCount fire pe langa cel curent; cu -1, cate unul
+	* pentru fiecare procesor in afara de cel curent, iar cu 0 joburile
+	* ruleaza serial, pe firul care le asteapta
+	*/
+	bool Start(int threadCount = -1);
+
+	/**
+	* Opreste firele; joburile neterminate sunt abandonate
+	*/
+	void Stop();
+
+	/**
+	* Numarul firelor care ruleaza joburi, inclusiv cel curent
+	*/
+	int GetWorkerCount() const { return m_workerCount; }
+
+	bool IsSerial() const { return m_workerCount == 1; }
+
+	/**
+	* Creeaza un job care va apela function(data, begin, end); nu ruleaza
+	* pana la Run. Parintele nu se termina inaintea lui. function poate fi
+	* NULL, pentru joburi care doar grupeaza alte joburi
+	*/
+	Job* Create(JobFunction function, void* data, int begin = 0, int end = 1, Job* parent = NULL);
+
+	/**
+	* job ruleaza doar dupa terminarea lui before; se apeleaza inainte de
+	* Run(job). Intoarce false daca before are deja prea multe dependente
+	*/
+	bool AddDependency(Job* job, Job* before);
+
+	/**
+	* Trimite jobul spre rulare, imediat sau dupa dependentele lui
+	*/
+	void Run(Job* job);
+
+	/**
+	* Asteapta terminarea jobului, ruland alte joburi intre timp
+	*/
+	void Wait(const Job* job);
+
+	bool IsFinished(const Job* job) const;
+
+	/**
+	* Imparte [0, count) in bucati de cate grain elemente (sau automat,
+	* pentru grain <= 0), le ruleaza in paralel si le asteapta
+	*/
+	void ParallelFor(JobFunction function, void* data, int count, int grain = 0);
+
+	~JobSystem();
+};
+
+#endif /*JOBSYSTEM_H_*/
@@ -0,0 +1,235 @@
+#include <string.h>
+#include <Types.h>
+#include "StringView.h"
+
+/**
+ * Puterile lui 10 reprezentabile exact ca double
+ */
+static const double POWERS_OF_TEN[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * Cifre pastrate in mantisa; 19 cifre incap mereu intr-un uint64_t
+ */
+#define MAX_MANTISSA_DIGITS		19
+
+/**
+ * Spatiile si caracterele de control separa cuvintele
+ */
+static inline bool IsSpace(char c)
+{
+	return (unsigned char)c <= ' ';
+}
+
+static inline bool IsDigit(char c)
+{
+	return (unsigned char)(c - '0') < 10;
+}
+
+/**
+ * 10 la puterea exponent, exponent >= 0
+ */
+static double PowerOfTen(int exponent)
+{
+	double result = 1.0;
+
+	for (; exponent > 22; exponent -= 22)
+	{
+		result *= 1e22;
+	}
+
+	return result * POWERS_OF_TEN[exponent];
+}
+
+StringView::StringView(const char* text) : data(text), length(text ? strlen(text) : 0)
+{
+}
+
+bool StringView::Equals(const char* text) const
+{
+	return strlen(text) == length && !memcmp(data, text, length);
+}
+
+size_t StringView::Copy(char* buffer, size_t size) const
+{
+	if (!size)
+	{
+		return 0;
+	}
+
+	size_t count = length < size - 1 ? length : size - 1;
+	memcpy(buffer, data, count);
+	buffer[count] = '\0';
+
+	return count;
+}
+
+StringView StringView::Trim() const
+{
+	const char* begin = data;
+	const char* end = data + length;
+
+	while (begin < end && IsSpace(*begin))
+	{
+		begin++;
+	}
+	while (end > begin && IsSpace(end[-1]))
+	{
+		end--;
+	}
+
+	return StringView(begin, end - begin);
+}
+
+bool StringView::NextToken(StringView& token)
+{
+	const char* p = data;
+	const char* end = data + length;
+
+	while (p < end && IsSpace(*p))
+	{
+		p++;
+	}
+
+	const char* start = p;
+	while (p < end && !IsSpace(*p))
+	{
+		p++;
+	}
+
+	token = StringView(start, p - start);
+	length = end - p;
+	data = p;
+
+	return token.length > 0;
+}
+
+bool StringView::ParseInt(int& value) const
+{
+	const char* p = data;
+	const char* end = data + length;
+	bool negative = false;
+
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p++ == '-';
+	}
+
+	if (p == end)
+	{
+		return false;
+	}
+
+	// Acumulam in 64 de biti, ca sa vedem depasirea
+	int64_t result = 0;
+	for (; p < end; p++)
+	{
+		if (!IsDigit(*p))
+		{
+			return false;
+		}
+
+		result = result * 10 + (*p - '0');
+		if (result > (int64_t)2147483647 + negative)
+		{
+			return false;
+		}
+	}
+
+	value = (int)(negative ? -result : result);
+	return true;
+}
+
+bool StringView::ParseFloat(float& value) const
+{
+	const char* p = data;
+	const char* end = data + length;
+	bool negative = false;
+
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p++ == '-';
+	}
+
+	// Cifrele semnificative intr-un intreg, apoi o singura inmultire cu o putere a lui 10
+	uint64_t mantissa = 0;
+	int digits = 0, exponent = 0;
+	bool any = false;
+
+	for (; p < end && IsDigit(*p); p++)
+	{
+		any = true;
+		if (digits < MAX_MANTISSA_DIGITS)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			digits += mantissa != 0;
+		}
+		else
+		{
+			exponent++;
+		}
+	}
+
+	if (p < end && *p == '.')
+	{
+		for (p++; p < end && IsDigit(*p); p++)
+		{
+			any = true;
+			if (digits < MAX_MANTISSA_DIGITS)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				digits += mantissa != 0;
+				exponent--;
+			}
+		}
+	}
+
+	if (!any)
+	{
+		return false;
+	}
+
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		bool negativeExponent = false;
+		int power = 0;
+
+		p++;
+		if (p < end && (*p == '-' || *p == '+'))
+		{
+			negativeExponent = *p++ == '-';
+		}
+		if (p == end || !IsDigit(*p))
+		{
+			return false;
+		}
+
+		for (; p < end && IsDigit(*p); p++)
+		{
+			// Dincolo de limitele unui float oricum iese 0 sau infinit
+			if (power < 10000)
+			{
+				power = power * 10 + (*p - '0');
+			}
+		}
+
+		exponent += negativeExponent ? -power : power;
+	}
+
+	if (p != end)
+	{
+		return false;
+	}
+
+	double result = (double)mantissa;
+	if (mantissa)
+	{
+		result = exponent < 0 ? result / PowerOfTen(-exponent) : result * PowerOfTen(exponent);
+	}
+
+	value = (float)(negative ? -result : result);
+	return true;
+}
@@ -0,0 +1,67 @@
+#ifndef STRINGVIEW_H_
+#define STRINGVIEW_H_
+
+#include <stddef.h>
+
+/**
+ * O bucata dintr-un text, fara copiere si fara terminatorul 0; memoria
+ * nu este a obiectului. Impartirea in cuvinte si citirea numerelor nu
+ * folosesc stare globala (ca strtok) si nici locale-ul (ca sscanf/atof),
+ * deci se pot folosi din mai multe fire
+ */
+struct StringView
+{
+	const char* data;
+	size_t length;
+
+	StringView() : data(NULL), length(0)
+	{
+	}
+
+	StringView(const char* data, size_t length) : data(data), length(length)
+	{
+	}
+
+	/**
+	* Un sir terminat cu 0
+	*/
+	explicit StringView(const char* text);
+
+	bool IsEmpty() const { return length == 0; }
+
+	/**
+	* Compara cu un sir terminat cu 0
+	*/
+	bool Equals(const char* text) const;
+
+	/**
+	* Copiaza textul in buffer si adauga terminatorul, trunchiat la
+	* size - 1 caractere; intoarce cate caractere au fost copiate
+	*/
+	size_t Copy(char* buffer, size_t size) const;
+
+	/**
+	* Textul fara spatiile de la inceput si sfarsit
+	*/
+	StringView Trim() const;
+
+	/**
+	* Scoate primul cuvant (separat prin spatii, tab-uri sau alte caractere
+	* de control) de la inceputul textului; intoarce false daca nu mai sunt cuvinte
+	*/
+	bool NextToken(StringView& token);
+
+	/**
+	* Citeste tot textul ca numar intreg in baza 10; intoarce false daca
+	* nu este un numar sau nu incape intr-un int
+	*/
+	bool ParseInt(int& value) const;
+
+	/**
+	* Citeste tot textul ca numar real (de ex. -1.5, 3, .25, 1e-3);
+	* intoarce false daca nu este un numar
+	*/
+	bool ParseFloat(float& value) const;
+};
+
+#endif /*STRINGVIEW_H_*/
@@ -0,0 +1,197 @@
+#include "TaskGraph.h"
+#include "Timer.h"
+#include "Types.h"
+
+TaskGraph::TaskGraph(JobSystem& jobs) : m_jobs(jobs), m_stageCount(0), m_frameCount(0), m_frameTime(0.0)
+{
+	for (int f = 0; f < 2; f++)
+	{
+		m_frames[f].graph = this;
+		m_frames[f].root = NULL;
+		for (int s = 0; s < TASKGRAPH_MAX_STAGES; s++)
+		{
+			m_frames[f].tasks[s].frame = &m_frames[f];
+			m_frames[f].tasks[s].stage = s;
+		}
+	}
+}
+
+int TaskGraph::AddStage(const char* name, TaskFunction function, void* data)
+{
+	if (m_stageCount == TASKGRAPH_MAX_STAGES)
+	{
+		return -1;
+	}
+
+	Stage& stage = m_stages[m_stageCount];
+	stage.name = name;
+	stage.function = function;
+	stage.data = data;
+	stage.dependencyCount = 0;
+	stage.time = 0.0;
+
+	return m_stageCount++;
+}
+
+bool TaskGraph::AddDependency(int stage, int before, bool previousFrame)
+{
+	if (stage < 0 || stage >= m_stageCount || before < 0 || before >= m_stageCount ||
+		(stage == before && !previousFrame))
+	{
+		return false;
+	}
+
+	Stage& s = m_stages[stage];
+	if (s.dependencyCount == TASKGRAPH_MAX_DEPENDENCIES)
+	{
+		return false;
+	}
+
+	// Fiecare job al lui before trebuie sa-si poata tine toate joburile
+	// care depind de el
+	int dependants = 0;
+	for (int i = 0; i < m_stageCount; i++)
+	{
+		for (int d = 0; d < m_stages[i].dependencyCount; d++)
+		{
+			dependants += m_stages[i].dependency[d] == before;
+		}
+	}
+	if (dependants == JOB_MAX_SUCCESSORS)
+	{
+		return false;
+	}
+
+	s.dependency[s.dependencyCount] = before;
+	s.previousFrame[s.dependencyCount] = previousFrame;
+	s.dependencyCount++;
+
+	return true;
+}
+
+void TaskGraph::RunTask(void* data, int begin, int end)
+{
+	Task* task = (Task*)data;
+	Frame* frame = task->frame;
+	const Stage& stage = frame->graph->m_stages[task->stage];
+	double start = Timer::GetSeconds();
+
+	stage.function(stage.data, frame->data, begin, end);
+
+	frame->busy[task->stage].Add((long)((Timer::GetSeconds() - start) * 1e7));
+}
+
+int TaskGraph::Launch(int itemCount, const void* data)
+{
+	int id = m_frameCount++;
+	Frame& frame = m_frames[id % 2];
+	Frame& previous = m_frames[(id + 1) % 2];
+
+	// Locul e ocupat de cadrul dinaintea celui anterior
+	if (frame.root)
+	{
+		this->Wait(frame.id);
+	}
+
+	// Cateva bucati pe fir, ca firele care termina repede sa aiba ce fura
+	int chunkCount = m_jobs.GetWorkerCount() * 4;
+	if (chunkCount > TASKGRAPH_MAX_CHUNKS)
+	{
+		chunkCount = TASKGRAPH_MAX_CHUNKS;
+	}
+	if (chunkCount > itemCount)
+	{
+		chunkCount = itemCount;
+	}
+
+	// Dependentele de cadrul anterior leaga aceleasi bucati
+	if (previous.root && previous.chunkCount != chunkCount)
+	{
+		this->Wait(previous.id);
+	}
+
+	frame.data = data;
+	frame.id = id;
+	frame.launchTime = Timer::GetSeconds();
+	frame.chunkCount = chunkCount;
+	for (int c = 0; chunkCount && c <= chunkCount; c++)
+	{
+		frame.chunkBegin[c] = (int)((int64_t)itemCount * c / chunkCount);
+	}
+
+	frame.root = m_jobs.Create(NULL, NULL);
+	for (int s = 0; s < m_stageCount; s++)
+	{
+		frame.busy[s].Store(0);
+		for (int c = 0; c < chunkCount; c++)
+		{
+			frame.jobs[s][c] = m_jobs.Create(RunTask, &frame.tasks[s], frame.chunkBegin[c], frame.chunkBegin[c + 1], frame.root);
+		}
+	}
+
+	for (int s = 0; s < m_stageCount; s++)
+	{
+		const Stage& stage = m_stages[s];
+		for (int d = 0; d < stage.dependencyCount; d++)
+		{
+			// Un cadru anterior deja terminat nu mai trebuie asteptat
+			if (stage.previousFrame[d] && !previous.root)
+			{
+				continue;
+			}
+
+			Frame& before = stage.previousFrame[d] ? previous : frame;
+			for (int c = 0; c < chunkCount; c++)
+			{
+				m_jobs.AddDependency(frame.jobs[s][c], before.jobs[stage.dependency[d]][c]);
+			}
+		}
+	}
+
+	for (int s = 0; s < m_stageCount; s++)
+	{
+		for (int c = 0; c < chunkCount; c++)
+		{
+			m_jobs.Run(frame.jobs[s][c]);
+		}
+	}
+	m_jobs.Run(frame.root);
+
+	return id;
+}
+
+bool TaskGraph::IsRunning(int id) const
+{
+	if (id < 0)
+	{
+		return false;
+	}
+
+	const Frame& frame = m_frames[id % 2];
+	return frame.root && frame.id == id;
+}
+
+void TaskGraph::Wait(int id)
+{
+	if (!this->IsRunning(id))
+	{
+		return;
+	}
+
+	Frame& frame = m_frames[id % 2];
+	m_jobs.Wait(frame.root);
+
+	for (int s = 0; s < m_stageCount; s++)
+	{
+		m_stages[s].time = frame.busy[s].Load() * 1e-7;
+	}
+	m_frameTime = Timer::GetSeconds() - frame.launchTime;
+	frame.root = NULL;
+}
+
+void TaskGraph::WaitAll()
+{
+	// In ordinea lansarii, ca timpii sa fie ai ultimului cadru
+	this->Wait(m_frameCount - 2);
+	this->Wait(m_frameCount - 1);
+}
@@ -0,0 +1,147 @@
+#ifndef TASKGRAPH_H_
+#define TASKGRAPH_H_
+
+#include <JobSystem.h>
+
+#define TASKGRAPH_MAX_STAGES		8
+#define TASKGRAPH_MAX_DEPENDENCIES	4
+
+/**
+ * In cate bucati se imparte cel mult un cadru; toate etapele folosesc
+ * aceleasi bucati
+ */
+#define TASKGRAPH_MAX_CHUNKS		64
+
+/**
+ * Functia unei etape: prelucreaza elementele [begin, end) ale cadrului
+ * frame (datele date la Launch)
+ */
+typedef void (*TaskFunction)(void* data, const void* frame, int begin, int end);
+
+/**
+ * Graf de etape declarat o singura data si rulat la fiecare cadru pe
+ * JobSystem. Elementele cadrului (de ex. personajele) sunt impartite in
+ * bucati, iar dependentele sunt pe bucati: bucata i a unei etape asteapta
+ * doar bucata i a etapelor de care depinde, deci elementele independente
+ * trec prin etape fara sa se astepte unele pe altele.
+ *
+ * O dependenta poate fi si fata de cadrul anterior (previousFrame), ceea
+ * ce permite ca un cadru sa inceapa inainte ca cel anterior sa se termine:
+ * doar etapele care ar suprascrie date inca folosite il asteapta. Cel mult
+ * doua cadre sunt in lucru deodata.
+ *
+ * Pentru fiecare etapa se masoara timpul de lucru al ultimului cadru
+ * terminat, adunat de pe toate firele
+ */
+class TaskGraph
+{
+private:
+	struct Stage
+	{
+		const char* name;
+		TaskFunction function;
+		void* data;
+		int dependencyCount;
+		int dependency[TASKGRAPH_MAX_DEPENDENCIES];
+		bool previousFrame[TASKGRAPH_MAX_DEPENDENCIES];
+
+		/**
+		* Secundele de lucru in ultimul cadru terminat
+		*/
+		double time;
+	};
+
+	struct Frame;
+
+	/**
+	* Datele jobului unei etape dintr-un cadru
+	*/
+	struct Task
+	{
+		Frame* frame;
+		int stage;
+	};
+
+	/**
+	* Un cadru lansat: bucatile, joburile lor si timpul de lucru al
+	* fiecarei etape, in unitati de 100 ns
+	*/
+	struct Frame
+	{
+		TaskGraph* graph;
+		const void* data;
+		int id;
+		Job* root;
+		double launchTime;
+		int chunkCount;
+		int chunkBegin[TASKGRAPH_MAX_CHUNKS + 1];
+		Job* jobs[TASKGRAPH_MAX_STAGES][TASKGRAPH_MAX_CHUNKS];
+		Task tasks[TASKGRAPH_MAX_STAGES];
+		AtomicInt busy[TASKGRAPH_MAX_STAGES];
+	};
+
+	JobSystem& m_jobs;
+
+	Stage m_stages[TASKGRAPH_MAX_STAGES];
+	int m_stageCount;
+
+	/**
+	* Cadrul cu numarul id foloseste m_frames[id % 2]; root este NULL
+	* cand locul e liber
+	*/
+	Frame m_frames[2];
+	int m_frameCount;
+
+	/**
+	* Secundele dintre lansarea si terminarea ultimului cadru asteptat
+	*/
+	double m_frameTime;
+
+	static void RunTask(void* data, int begin, int end);
+
+	// Nu copiem grafurile
+	TaskGraph(const TaskGraph&);
+	TaskGraph& operator=(const TaskGraph&);
+
+public:
+	explicit TaskGraph(JobSystem& jobs);
+
+	/**
+	* Adauga o etapa si intoarce indexul ei, sau -1 daca sunt prea multe
+	*/
+	int AddStage(const char* name, TaskFunction function, void* data);
+
+	/**
+	* Bucatile etapei stage incep dupa aceleasi bucati ale etapei before,
+	* din acelasi cadru sau din cel anterior; dependentele din acelasi
+	* cadru nu pot forma cicluri. Intoarce false daca stage are prea multe
+	* dependente sau before prea multe etape care depind de el
+	*/
+	bool AddDependency(int stage, int before, bool previousFrame = false);
+
+	/**
+	* Lanseaza un cadru cu itemCount elemente si intoarce numarul lui;
+	* frame trebuie sa ramana valid pana la terminarea cadrului. Daca
+	* doua cadre sunt deja in lucru, il asteapta pe cel mai vechi
+	*/
+	int Launch(int itemCount, const void* frame);
+
+	/**
+	* Asteapta terminarea unui cadru si ii pastreaza timpii
+	*/
+	void Wait(int frame);
+
+	/**
+	* Asteapta toate cadrele lansate
+	*/
+	void WaitAll();
+
+	bool IsRunning(int frame) const;
+
+	int GetStageCount() const { return m_stageCount; }
+	const char* GetStageName(int stage) const { return m_stages[stage].name; }
+	double GetStageTime(int stage) const { return m_stages[stage].time; }
+	double GetFrameTime() const { return m_frameTime; }
+};
+
+#endif /*TASKGRAPH_H_*/
@@ -0,0 +1,243 @@
+#include "Thread.h"
+
+#ifdef _WIN32
+// Variabilele de conditie au aparut in Windows Vista
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <process.h>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+Mutex::Mutex()
+{
+	CRITICAL_SECTION* section = new CRITICAL_SECTION;
+	InitializeCriticalSection(section);
+	m_handle = section;
+}
+
+void Mutex::Lock()
+{
+	EnterCriticalSection((CRITICAL_SECTION*)m_handle);
+}
+
+void Mutex::Unlock()
+{
+	LeaveCriticalSection((CRITICAL_SECTION*)m_handle);
+}
+
+Mutex::~Mutex()
+{
+	DeleteCriticalSection((CRITICAL_SECTION*)m_handle);
+	delete (CRITICAL_SECTION*)m_handle;
+}
+
+Condition::Condition()
+{
+	CONDITION_VARIABLE* condition = new CONDITION_VARIABLE;
+	InitializeConditionVariable(condition);
+	m_handle = condition;
+}
+
+void Condition::Wait(Mutex& mutex)
+{
+	SleepConditionVariableCS((CONDITION_VARIABLE*)m_handle, (CRITICAL_SECTION*)mutex.m_handle, INFINITE);
+}
+
+void Condition::Signal()
+{
+	WakeConditionVariable((CONDITION_VARIABLE*)m_handle);
+}
+
+void Condition::Broadcast()
+{
+	WakeAllConditionVariable((CONDITION_VARIABLE*)m_handle);
+}
+
+Condition::~Condition()
+{
+	// Variabilele de conditie Win32 nu se distrug
+	delete (CONDITION_VARIABLE*)m_handle;
+}
+
+unsigned __stdcall Thread::Run(void* thread)
+{
+	Thread* self = (Thread*)thread;
+	self->m_function(self->m_argument);
+	return 0;
+}
+
+bool Thread::Start(ThreadFunction function, void* argument)
+{
+	this->Join();
+
+	m_function = function;
+	m_argument = argument;
+	m_handle = (void*)_beginthreadex(NULL, 0, Run, this, 0, NULL);
+
+	return m_handle != 0;
+}
+
+void Thread::Join()
+{
+	if (m_handle)
+	{
+		WaitForSingleObject((HANDLE)m_handle, INFINITE);
+		CloseHandle((HANDLE)m_handle);
+		m_handle = 0;
+	}
+}
+
+int Thread::GetProcessorCount()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+void Thread::YieldTime()
+{
+	SwitchToThread();
+}
+
+void Thread::Sleep(double seconds)
+{
+	::Sleep(seconds > 0.0 ? (DWORD)(seconds * 1e3 + 0.5) : 0);
+}
+
+#else
+
+Mutex::Mutex()
+{
+	pthread_mutex_t* mutex = new pthread_mutex_t;
+	pthread_mutex_init(mutex, NULL);
+	m_handle = mutex;
+}
+
+void Mutex::Lock()
+{
+	pthread_mutex_lock((pthread_mutex_t*)m_handle);
+}
+
+void Mutex::Unlock()
+{
+	pthread_mutex_unlock((pthread_mutex_t*)m_handle);
+}
+
+Mutex::~Mutex()
+{
+	pthread_mutex_destroy((pthread_mutex_t*)m_handle);
+	delete (pthread_mutex_t*)m_handle;
+}
+
+Condition::Condition()
+{
+	pthread_cond_t* condition = new pthread_cond_t;
+	pthread_cond_init(condition, NULL);
+	m_handle = condition;
+}
+
+void Condition::Wait(Mutex& mutex)
+{
+	pthread_cond_wait((pthread_cond_t*)m_handle, (pthread_mutex_t*)mutex.m_handle);
+}
+
+void Condition::Signal()
+{
+	pthread_cond_signal((pthread_cond_t*)m_handle);
+}
+
+void Condition::Broadcast()
+{
+	pthread_cond_broadcast((pthread_cond_t*)m_handle);
+}
+
+Condition::~Condition()
+{
+	pthread_cond_destroy((pthread_cond_t*)m_handle);
+	delete (pthread_cond_t*)m_handle;
+}
+
+void* Thread::Run(void* thread)
+{
+	Thread* self = (Thread*)thread;
+	self->m_function(self->m_argument);
+	return NULL;
+}
+
+bool Thread::Start(ThreadFunction function, void* argument)
+{
+	this->Join();
+
+	m_function = function;
+	m_argument = argument;
+
+	pthread_t* thread = new pthread_t;
+	if (pthread_create(thread, NULL, Run, this) != 0)
+	{
+		delete thread;
+		return false;
+	}
+
+	m_handle = thread;
+	return true;
+}
+
+void Thread::Join()
+{
+	if (m_handle)
+	{
+		pthread_join(*(pthread_t*)m_handle, NULL);
+		delete (pthread_t*)m_handle;
+		m_handle = 0;
+	}
+}
+
+int Thread::GetProcessorCount()
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int)count : 1;
+}
+
+void Thread::YieldTime()
+{
+	sched_yield();
+}
+
+void Thread::Sleep(double seconds)
+{
+	struct timespec time;
+
+	if (seconds <= 0.0)
+	{
+		return;
+	}
+
+	time.tv_sec = (time_t)seconds;
+	time.tv_nsec = (long)((seconds - time.tv_sec) * 1e9);
+
+	// Semnalele intrerup asteptarea; time primeste cat a mai ramas
+	while (nanosleep(&time, &time) != 0 && errno == EINTR)
+	{
+	}
+}
+
+#endif
+
+Thread::Thread() : m_handle(0), m_function(0), m_argument(0)
+{
+}
+
+Thread::~Thread()
+{
+	this->Join();
+}
@@ -0,0 +1,148 @@
+#ifndef THREAD_H_
+#define THREAD_H_
+
+/**
+ * Primitive de sincronizare si fire de executie, peste Win32
+ * (Windows Vista sau mai nou, pentru variabilele de conditie) si pthread.
+ * Obiectele sistemului sunt alocate in .cpp, ca headerul sa nu
+ * includa windows.h/pthread.h
+ */
+
+/**
+ * Excludere mutuala; nu este recursiv
+ */
+class Mutex
+{
+private:
+	void* m_handle;
+
+	friend class Condition;
+
+	// Nu copiem obiectele sistemului
+	Mutex(const Mutex&);
+	Mutex& operator=(const Mutex&);
+
+public:
+	Mutex();
+
+	void Lock();
+
+	void Unlock();
+
+	~Mutex();
+};
+
+/**
+ * Blocheaza un Mutex pe durata unui bloc de cod
+ */
+class ScopedLock
+{
+private:
+	Mutex& m_mutex;
+
+	// Nu copiem blocarile
+	ScopedLock(const ScopedLock&);
+	ScopedLock& operator=(const ScopedLock&);
+
+public:
+	explicit ScopedLock(Mutex& mutex) : m_mutex(mutex) { m_mutex.Lock(); }
+
+	~ScopedLock() { m_mutex.Unlock(); }
+};
+
+/**
+ * Variabila de conditie; Wait() se apeleaza cu mutexul blocat si se
+ * poate intoarce si fara Signal(), deci conditia se verifica intr-o bucla
+ */
+class Condition
+{
+private:
+	void* m_handle;
+
+	// Nu copiem obiectele sistemului
+	Condition(const Condition&);
+	Condition& operator=(const Condition&);
+
+public:
+	Condition();
+
+	/**
+	* Elibereaza mutexul, asteapta un semnal si il blocheaza din nou
+	*/
+	void Wait(Mutex& mutex);
+
+	/**
+	* Trezeste un fir care asteapta
+	*/
+	void Signal();
+
+	/**
+	* Trezeste toate firele care asteapta
+	*/
+	void Broadcast();
+
+	~Condition();
+};
+
+/**
+ * Functia rulata de un fir de executie
+ */
+typedef void (*ThreadFunction)(void* argument);
+
+/**
+ * Un fir de executie; trebuie asteptat cu Join() inainte de distrugere
+ * (destructorul il asteapta daca nu s-a facut deja)
+ */
+class Thread
+{
+private:
+	void* m_handle;
+	ThreadFunction m_function;
+	void* m_argument;
+
+	// Punctul de intrare al firului, in conventia sistemului
+#ifdef _WIN32
+	static unsigned __stdcall Run(void* thread);
+#else
+	static void* Run(void* thread);
+#endif
+
+	// Nu copiem firele
+	Thread(const Thread&);
+	Thread& operator=(const Thread&);
+
+public:
+	Thread();
+
+	/**
+	* Porneste firul, care apeleaza function(argument)
+	*/
+	bool Start(ThreadFunction function, void* argument);
+
+	/**
+	* Asteapta terminarea firului
+	*/
+	void Join();
+
+	bool IsRunning() const { return m_handle != 0; }
+
+	/**
+	* Numarul de procesoare logice
+	*/
+	static int GetProcessorCount();
+
+	/**
+	* Cedeaza procesorul altui fir gata de rulare, daca exista
+	*/
+	static void YieldTime();
+
+	/**
+	* Adoarme firul curent cel putin seconds secunde; pe Windows durata
+	* este rotunjita la milisecunde
+	*/
+	static void Sleep(double seconds);
+
+	~Thread();
+};
+
+#endif /*THREAD_H_*/
@@ -0,0 +1,69 @@
+#include "Timer.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+Timer::Timer()
+{
+	this->Reset();
+}
+
+void Timer::Reset()
+{
+	m_start = GetSeconds();
+}
+
+double Timer::GetElapsed() const
+{
+	return GetSeconds() - m_start;
+}
+
+double Timer::GetSeconds()
+{
+#if defined(_WIN32)
+	static double frequency = 0.0;
+	LARGE_INTEGER counter;
+
+	if (frequency == 0.0)
+	{
+		LARGE_INTEGER f;
+		QueryPerformanceFrequency(&f);
+		frequency = (double)f.QuadPart;
+	}
+
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart / frequency;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+double Timer::GetProcessSeconds()
+{
+#if defined(_WIN32)
+	FILETIME creation, exit, kernel, user;
+	ULARGE_INTEGER k, u;
+
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+	{
+		return 0.0;
+	}
+
+	k.LowPart = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+
+	// In unitati de 100 ns
+	return (k.QuadPart + u.QuadPart) * 1e-7;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
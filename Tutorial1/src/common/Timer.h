@@ -0,0 +1,43 @@
+#ifndef TIMER_H_
+#define TIMER_H_
+
+/**
+ * Ceas de inalta rezolutie, monoton; folosit pentru masuratori
+ * de performanta si pentru ceasul animatiei
+ */
+class Timer
+{
+private:
+	/**
+	* Momentul pornirii, in secunde
+	*/
+	double m_start;
+
+public:
+	/**
+	* Porneste cronometrul
+	*/
+	Timer();
+
+	/**
+	* Reporneste cronometrul
+	*/
+	void Reset();
+
+	/**
+	* Secundele trecute de la pornire
+	*/
+	double GetElapsed() const;
+
+	/**
+	* Timpul curent, in secunde, fata de un moment de referinta oarecare
+	*/
+	static double GetSeconds();
+
+	/**
+	* Secundele de procesor folosite de proces pana acum, pe toate firele
+	*/
+	static double GetProcessSeconds();
+};
+
+#endif /*TIMER_H_*/
@@ -0,0 +1,31 @@
+#include "TripleBuffer.h"
+
+#define TRIPLEBUFFER_NEW	4
+#define TRIPLEBUFFER_INDEX	3
+
+TripleBuffer::TripleBuffer() : m_write(0), m_read(1), m_middle(2)
+{
+}
+
+void TripleBuffer::Publish()
+{
+	// Exchange e bariera completa: datele scrise sunt vazute inaintea locului
+	m_write = m_middle.Exchange(m_write | TRIPLEBUFFER_NEW) & TRIPLEBUFFER_INDEX;
+}
+
+bool TripleBuffer::Acquire()
+{
+	// Doar consumatorul sterge TRIPLEBUFFER_NEW, deci nu il poate pierde
+	if (!this->HasNew())
+	{
+		return false;
+	}
+
+	m_read = m_middle.Exchange(m_read) & TRIPLEBUFFER_INDEX;
+	return true;
+}
+
+bool TripleBuffer::HasNew() const
+{
+	return (m_middle.Load() & TRIPLEBUFFER_NEW) != 0;
+}
@@ -0,0 +1,67 @@
+#ifndef TRIPLEBUFFER_H_
+#define TRIPLEBUFFER_H_
+
+#include <Atomic.h>
+
+/**
+ * Schimb fara blocare al unei valori intre un fir care o produce si unul
+ * care o foloseste, peste trei locuri (de ex. trei copii ale unei poze):
+ * producatorul scrie in locul lui si il publica, consumatorul ia cel mai
+ * nou loc publicat. Niciunul nu il asteapta pe celalalt, iar consumatorul
+ * nu vede niciodata un loc pe jumatate scris.
+ *
+ * Clasa tine doar indecsii locurilor (0, 1 sau 2); datele sunt ale
+ * apelantului. Fiecare parte are un singur fir
+ */
+class TripleBuffer
+{
+private:
+	/**
+	* Locul producatorului si cel al consumatorului; fiecare e folosit
+	* doar de firul lui
+	*/
+	int m_write;
+	int m_read;
+
+	/**
+	* Al treilea loc, cu TRIPLEBUFFER_NEW daca a fost publicat dupa ce
+	* consumatorul si-a luat locul
+	*/
+	AtomicInt m_middle;
+
+	// Nu copiem schimbul
+	TripleBuffer(const TripleBuffer&);
+	TripleBuffer& operator=(const TripleBuffer&);
+
+public:
+	TripleBuffer();
+
+	/**
+	* Locul in care scrie producatorul
+	*/
+	int GetWriteIndex() const { return m_write; }
+
+	/**
+	* Publica locul scris si ii da producatorului altul; o valoare
+	* publicata si neluata inca este inlocuita
+	*/
+	void Publish();
+
+	/**
+	* Ia cel mai nou loc publicat, daca exista unul mai nou decat cel
+	* curent, si intoarce true daca s-a schimbat
+	*/
+	bool Acquire();
+
+	/**
+	* Locul pe care il citeste consumatorul
+	*/
+	int GetReadIndex() const { return m_read; }
+
+	/**
+	* Exista un loc publicat pe care consumatorul nu l-a luat inca
+	*/
+	bool HasNew() const;
+};
+
+#endif /*TRIPLEBUFFER_H_*/
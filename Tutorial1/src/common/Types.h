@@ -0,0 +1,21 @@
+#ifndef TYPES_H_
+#define TYPES_H_
+
+/**
+* Tipuri intregi cu dimensiune fixa;
+* Visual Studio 2008 nu are stdint.h, asa ca le definim aici
+*/
+#if defined(_MSC_VER) && (_MSC_VER < 1600)
+typedef signed char			int8_t;
+typedef unsigned char		uint8_t;
+typedef short				int16_t;
+typedef unsigned short		uint16_t;
+typedef int					int32_t;
+typedef unsigned int		uint32_t;
+typedef __int64				int64_t;
+typedef unsigned __int64	uint64_t;
+#else
+#include <stdint.h>
+#endif
+
+#endif /*TYPES_H_*/
@@ -0,0 +1,19 @@
+#include <AsyncIO.h>
+#include "ThreadPoolIO.h"
+#include "UringIO.h"
+
+AsyncIO* CreateAsyncIO(int queueDepth)
+{
+	if (UringIO::IsSupported())
+	{
+		UringIO* uring = new UringIO(queueDepth);
+		if (uring->IsOpen())
+		{
+			return uring;
+		}
+		delete uring;
+	}
+
+	// Grupul de fire nu are rost sa fie mai mare decat coada
+	return new ThreadPoolIO(queueDepth);
+}
@@ -0,0 +1,349 @@
+#include <string.h>
+#include <Log.h>
+#include "CompressedFile.h"
+
+CompressedFile::CompressedFile() :
+	m_data(NULL), m_size(0), m_originalSize(0), m_restarts(NULL), m_restartCount(0),
+	m_streamReady(false), m_window(NULL), m_windowStart(0), m_windowLength(0),
+	m_position(0), m_open(false)
+{
+	memset(&m_stream, 0, sizeof(m_stream));
+}
+
+CompressedFile::CompressedFile(const void* data, size_t size, size_t originalSize,
+	const CompressedRestart* restarts, int restartCount) :
+	m_data(NULL), m_size(0), m_originalSize(0), m_restarts(NULL), m_restartCount(0),
+	m_streamReady(false), m_window(NULL), m_windowStart(0), m_windowLength(0),
+	m_position(0), m_open(false)
+{
+	memset(&m_stream, 0, sizeof(m_stream));
+	this->SetData(data, size, originalSize, restarts, restartCount);
+}
+
+bool CompressedFile::SetData(const void* data, size_t size, size_t originalSize,
+	const CompressedRestart* restarts, int restartCount)
+{
+	this->Close();
+
+	// Flux deflate simplu (fara antet zlib), ca sa putem porni din orice punct de reluare
+	memset(&m_stream, 0, sizeof(m_stream));
+	if (inflateInit2(&m_stream, -MAX_WBITS) != Z_OK)
+	{
+		LogError("Failed to initialize zlib: %s", m_stream.msg ? m_stream.msg : "");
+		return false;
+	}
+
+	m_streamReady = true;
+	m_data = (const unsigned char*)data;
+	m_size = size;
+	m_originalSize = originalSize;
+	m_restarts = restarts;
+	m_restartCount = restarts ? restartCount : 0;
+	m_window = new unsigned char[COMPRESSED_WINDOW_SIZE];
+	m_position = 0;
+	m_open = true;
+
+	return this->Restart(0);
+}
+
+bool CompressedFile::Open(const char* /*filename*/, const char* /*mode*/)
+{
+	return false;
+}
+
+bool CompressedFile::IsOpen()
+{
+	return m_open;
+}
+
+bool CompressedFile::Restart(size_t position)
+{
+	// Ultimul punct de reluare cu position <= pozitia ceruta
+	int lo = 0, hi = m_restartCount;
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (m_restarts[mid].position <= position)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	size_t start = lo > 0 ? m_restarts[lo - 1].position : 0;
+	size_t offset = lo > 0 ? m_restarts[lo - 1].offset : 0;
+
+	if (inflateReset(&m_stream) != Z_OK)
+	{
+		return false;
+	}
+
+	m_stream.next_in = (Bytef*)(m_data + offset);
+	m_stream.avail_in = (uInt)(m_size - offset);
+	m_windowStart = start;
+	m_windowLength = 0;
+
+	return true;
+}
+
+bool CompressedFile::Fill()
+{
+	m_windowStart += m_windowLength;
+	m_windowLength = 0;
+
+	if (m_windowStart >= m_originalSize)
+	{
+		return false;
+	}
+
+	m_stream.next_out = m_window;
+	m_stream.avail_out = COMPRESSED_WINDOW_SIZE;
+
+	while (m_stream.avail_out > 0)
+	{
+		int result = inflate(&m_stream, Z_NO_FLUSH);
+		if (result == Z_STREAM_END)
+		{
+			break;
+		}
+		if (result != Z_OK)
+		{
+			// Flux corupt sau trunchiat
+			LogError("Failed to inflate compressed file: %s", m_stream.msg ? m_stream.msg : "");
+			break;
+		}
+	}
+
+	m_windowLength = COMPRESSED_WINDOW_SIZE - m_stream.avail_out;
+
+	return m_windowLength > 0;
+}
+
+bool CompressedFile::Reach(size_t position)
+{
+	size_t windowEnd = m_windowStart + m_windowLength;
+
+	// Inapoi: reluam de la un punct anterior
+	if (position < m_windowStart)
+	{
+		return this->Restart(position) && this->Reach(position);
+	}
+
+	// Mult inainte: sarim direct la un punct de reluare, daca exista unul dupa fereastra
+	if (position >= windowEnd && m_restartCount > 0)
+	{
+		int lo = 0, hi = m_restartCount;
+		while (lo < hi)
+		{
+			int mid = (lo + hi) / 2;
+			if (m_restarts[mid].position <= position)
+			{
+				lo = mid + 1;
+			}
+			else
+			{
+				hi = mid;
+			}
+		}
+
+		if (lo > 0 && m_restarts[lo - 1].position > windowEnd && !this->Restart(position))
+		{
+			return false;
+		}
+	}
+
+	while (position >= m_windowStart + m_windowLength)
+	{
+		if (!this->Fill())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+size_t CompressedFile::Read(void* data, size_t size, size_t count)
+{
+	if (!m_open || !size || m_position >= m_originalSize)
+	{
+		return 0;
+	}
+
+	// Ca fread, citim doar elemente intregi
+	size_t available = (m_originalSize - m_position) / size;
+	if (count > available)
+	{
+		count = available;
+	}
+
+	unsigned char* out = (unsigned char*)data;
+	size_t left = size * count;
+	size_t copied = 0;
+
+	while (left > 0 && this->Reach(m_position))
+	{
+		size_t offset = m_position - m_windowStart;
+		size_t chunk = m_windowLength - offset;
+		if (chunk > left)
+		{
+			chunk = left;
+		}
+
+		memcpy(out + copied, m_window + offset, chunk);
+		copied += chunk;
+		left -= chunk;
+		m_position += chunk;
+	}
+
+	return copied / size;
+}
+
+size_t CompressedFile::Write(const void* /*data*/, size_t /*size*/, size_t /*count*/)
+{
+	return 0;
+}
+
+int CompressedFile::Seek(long offset, int origin)
+{
+	long base;
+
+	switch (origin)
+	{
+	case SEEK_SET:
+		base = 0;
+		break;
+	case SEEK_CUR:
+		base = (long)m_position;
+		break;
+	case SEEK_END:
+		base = (long)m_originalSize;
+		break;
+	default:
+		return -1;
+	}
+
+	if (base + offset < 0 || base + offset > (long)m_originalSize)
+	{
+		return -1;
+	}
+
+	// Decomprimarea se face abia la citire
+	m_position = (size_t)(base + offset);
+	return 0;
+}
+
+long CompressedFile::Tell()
+{
+	return (long)m_position;
+}
+
+long CompressedFile::GetSize()
+{
+	return (long)m_originalSize;
+}
+
+void CompressedFile::Close()
+{
+	if (m_streamReady)
+	{
+		inflateEnd(&m_stream);
+		m_streamReady = false;
+	}
+
+	delete[] m_window;
+	m_window = NULL;
+
+	m_data = NULL;
+	m_size = 0;
+	m_originalSize = 0;
+	m_restarts = NULL;
+	m_restartCount = 0;
+	m_windowStart = 0;
+	m_windowLength = 0;
+	m_position = 0;
+	m_open = false;
+}
+
+bool CompressedFile::IsStream()
+{
+	return true;
+}
+
+void* CompressedFile::GetInternalData()
+{
+	return &m_stream;
+}
+
+bool CompressedFile::Compress(const void* data, size_t size, size_t interval,
+	unsigned char*& compressed, size_t& compressedSize,
+	CompressedRestart*& restarts, int& restartCount)
+{
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+
+	if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		return false;
+	}
+
+	// Un bloc de interval octeti intre doua puncte de reluare
+	size_t chunks = interval ? (size + interval - 1) / interval : 1;
+	if (chunks == 0)
+	{
+		chunks = 1;
+	}
+
+	// Fiecare Z_FULL_FLUSH adauga cativa octeti peste marginea calculata de zlib
+	size_t capacity = deflateBound(&stream, (uLong)size) + chunks * 16 + 64;
+	compressed = new unsigned char[capacity];
+	restarts = new CompressedRestart[chunks];
+	restartCount = 0;
+
+	stream.next_out = compressed;
+	stream.avail_out = (uInt)capacity;
+
+	bool ok = true;
+	for (size_t i = 0; i < chunks && ok; i++)
+	{
+		size_t start = interval ? i * interval : 0;
+		size_t length = interval && size - start > interval ? interval : size - start;
+		bool last = i + 1 == chunks;
+
+		stream.next_in = (Bytef*)data + start;
+		stream.avail_in = (uInt)length;
+
+		int result = deflate(&stream, last ? Z_FINISH : Z_FULL_FLUSH);
+		ok = last ? result == Z_STREAM_END : (result == Z_OK && stream.avail_in == 0);
+
+		// Dupa golire, urmatorul bloc se poate decomprima independent
+		if (ok && !last)
+		{
+			restarts[restartCount].position = (uint32_t)(start + length);
+			restarts[restartCount].offset = (uint32_t)stream.total_out;
+			restartCount++;
+		}
+	}
+
+	compressedSize = stream.total_out;
+	deflateEnd(&stream);
+
+	if (!ok)
+	{
+		delete[] compressed;
+		delete[] restarts;
+		compressed = NULL;
+		restarts = NULL;
+		restartCount = 0;
+	}
+
+	return ok;
+}
+
+CompressedFile::~CompressedFile()
+{
+	this->Close();
+}
@@ -0,0 +1,145 @@
+#ifndef COMPRESSEDFILE_H_
+#define COMPRESSEDFILE_H_
+
+#include <stddef.h>
+#include <zlib.h>
+#include <Types.h>
+#include <File.h>
+
+/**
+ * Cati octeti decomprimati tine fereastra unui CompressedFile
+ */
+#define COMPRESSED_WINDOW_SIZE		(64 * 1024)
+
+/**
+ * Punct de reluare in fluxul comprimat: la offset (in datele comprimate)
+ * incepe un bloc deflate independent (scris dupa un Z_FULL_FLUSH), care
+ * decomprima octetii de la position incolo
+ */
+struct CompressedRestart
+{
+	uint32_t position;
+	uint32_t offset;
+};
+
+/**
+ * Clasa ce implementeaza interfata File,
+ * modeleaza un fisier doar pentru citire comprimat cu deflate (fara antet
+ * zlib) aflat in memorie, de ex. o intrare dintr-o arhiva mapata.
+ * Datele se decomprima incremental intr-o fereastra de dimensiune fixa,
+ * pe masura ce sunt citite. Salturile inapoi pornesc decomprimarea de la
+ * cel mai apropiat punct de reluare, in loc de inceputul fluxului.
+ * Memoria comprimata si punctele de reluare nu sunt ale obiectului
+ */
+class CompressedFile : public File
+{
+private:
+	/**
+	* Fluxul comprimat si dimensiunea datelor decomprimate
+	*/
+	const unsigned char* m_data;
+	size_t m_size;
+	size_t m_originalSize;
+
+	const CompressedRestart* m_restarts;
+	int m_restartCount;
+
+	/**
+	* Starea zlib; fereastra contine octetii [m_windowStart, m_windowStart + m_windowLength)
+	*/
+	z_stream m_stream;
+	bool m_streamReady;
+	unsigned char* m_window;
+	size_t m_windowStart;
+	size_t m_windowLength;
+
+	size_t m_position;
+	bool m_open;
+
+	/**
+	* Reporneste decomprimarea de la ultimul punct de reluare dinaintea lui position
+	*/
+	bool Restart(size_t position);
+
+	/**
+	* Decomprima urmatoarea fereastra
+	*/
+	bool Fill();
+
+	/**
+	* Aduce in fereastra octetul de la position
+	*/
+	bool Reach(size_t position);
+
+	// Nu copiem fisierele
+	CompressedFile(const CompressedFile&);
+	CompressedFile& operator=(const CompressedFile&);
+
+public:
+	/**
+	* Constructorul implicit; fisierul se deschide cu SetData()
+	*/
+	CompressedFile();
+
+	/**
+	* Creeaza un fisier peste un flux comprimat; vezi SetData()
+	*/
+	CompressedFile(const void* data, size_t size, size_t originalSize,
+		const CompressedRestart* restarts = NULL, int restartCount = 0);
+
+	/**
+	* Deschide fisierul peste size octeti comprimati, care se decomprima in
+	* originalSize octeti. Punctele de reluare sunt optionale si ordonate
+	*/
+	bool SetData(const void* data, size_t size, size_t originalSize,
+		const CompressedRestart* restarts = NULL, int restartCount = 0);
+
+	/**
+	* Fisierele comprimate nu se deschid dupa nume; intoarce mereu false
+	*/
+	bool Open(const char* filename, const char* mode = "rb");
+
+	// Mostenite din File
+	size_t Read(void* data, size_t size, size_t count);
+
+	int Seek(long offset, int origin = SEEK_SET);
+
+	long Tell();
+
+	/**
+	* Dimensiunea datelor decomprimate
+	*/
+	long GetSize();
+
+	/**
+	* Fisierul este doar pentru citire; intoarce mereu 0
+	*/
+	size_t Write(const void* data, size_t size, size_t count);
+
+	bool IsOpen();
+
+	void Close();
+
+	/**
+	* Fisierul contine un stream zlib
+	*/
+	bool IsStream();
+
+	/**
+	* Intoarce z_stream-ul folosit la decomprimare
+	*/
+	void* GetInternalData();
+
+	/**
+	* Comprima size octeti pentru un CompressedFile: un flux deflate cu un
+	* punct de reluare la fiecare interval octeti decomprimati. Intoarce
+	* false daca zlib esueaza
+	*/
+	static bool Compress(const void* data, size_t size, size_t interval,
+		unsigned char*& compressed, size_t& compressedSize,
+		CompressedRestart*& restarts, int& restartCount);
+
+	virtual ~CompressedFile();
+};
+
+#endif /*COMPRESSEDFILE_H_*/
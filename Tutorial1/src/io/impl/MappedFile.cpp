@@ -0,0 +1,132 @@
+#include <string.h>
+#include <Log.h>
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : m_file(NULL), m_mapping(NULL)
+{
+}
+
+MappedFile::MappedFile(const char* filename, const char* mode) :
+	m_file(NULL), m_mapping(NULL)
+{
+	this->Open(filename, mode);
+}
+
+bool MappedFile::Open(const char* filename, const char* mode)
+{
+	this->Close();
+
+	// Maparea e doar pentru citire
+	if (strpbrk(mode, "wa+"))
+	{
+		LogError("Mapped file %s can only be opened for reading", filename);
+		return false;
+	}
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		LogError("Failed to open mapped file %s", filename);
+		return false;
+	}
+
+	// Fisierele goale nu se pot mapa; raman deschise, cu lungimea 0
+	DWORD size = GetFileSize(file, NULL);
+	HANDLE mapping = NULL;
+	const void* data = NULL;
+	if (size)
+	{
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+		if (!data)
+		{
+			LogError("Failed to map file %s", filename);
+			if (mapping)
+			{
+				CloseHandle(mapping);
+			}
+			CloseHandle(file);
+			return false;
+		}
+	}
+
+	m_file = file;
+	m_mapping = mapping;
+#else
+	int file = open(filename, O_RDONLY);
+	if (file < 0)
+	{
+		LogError("Failed to open mapped file %s", filename);
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0)
+	{
+		close(file);
+		return false;
+	}
+
+	// Maparea ramane valida si dupa inchiderea descriptorului
+	size_t size = (size_t)info.st_size;
+	void* data = NULL;
+	if (size)
+	{
+		data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data == MAP_FAILED)
+		{
+			LogError("Failed to map file %s", filename);
+			close(file);
+			return false;
+		}
+	}
+	close(file);
+#endif
+
+	this->SetData(data, size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping)
+	{
+		CloseHandle((HANDLE)m_mapping);
+	}
+	if (m_file)
+	{
+		CloseHandle((HANDLE)m_file);
+	}
+#else
+	if (m_data)
+	{
+		munmap((void*)m_data, m_size);
+	}
+#endif
+
+	m_file = NULL;
+	m_mapping = NULL;
+	MemoryFile::Close();
+}
+
+MappedFile::~MappedFile()
+{
+	this->Close();
+}
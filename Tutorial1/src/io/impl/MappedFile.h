@@ -0,0 +1,50 @@
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <MemoryFile.h>
+
+/**
+ * Clasa ce implementeaza interfata File,
+ * modeleaza un fisier local mapat in memorie doar pentru citire.
+ * Continutul se poate folosi direct, fara copiere (GetData/GetLength),
+ * iar Read/Seek/Tell functioneaza ca pentru LocalFile, pentru codul
+ * care citeste in stilul fread
+ */
+class MappedFile : public MemoryFile
+{
+private:
+	/**
+	* Handle-urile sistemului pentru fisier si mapare (doar pe Windows)
+	*/
+	void* m_file;
+	void* m_mapping;
+
+	// Nu copiem maparile
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+public:
+	/**
+	* Constructorul implicit, va trebui apelat Open() dupa crearea obiectului
+	*/
+	MappedFile();
+
+	/**
+	* Creeaza obiectul si mapeaza un fisier
+	*/
+	MappedFile(const char* filename, const char* mode = "rb");
+
+	/**
+	* Mapeaza fisierul; sunt acceptate doar modurile de citire ("r", "rb")
+	*/
+	bool Open(const char* filename, const char* mode = "rb");
+
+	/**
+	* Elibereaza maparea
+	*/
+	void Close();
+
+	virtual ~MappedFile();
+};
+
+#endif /*MAPPEDFILE_H_*/
@@ -0,0 +1,127 @@
+#include <string.h>
+#include "MemoryFile.h"
+
+MemoryFile::MemoryFile() :
+	m_data(NULL), m_size(0), m_position(0), m_open(false), m_owned(false)
+{
+}
+
+MemoryFile::MemoryFile(const void* data, size_t size) :
+	m_data(NULL), m_size(0), m_position(0), m_open(false), m_owned(false)
+{
+	this->SetData(data, size);
+}
+
+void MemoryFile::SetData(const void* data, size_t size, bool owned)
+{
+	MemoryFile::Close();
+
+	m_owned = owned;
+	m_data = (const unsigned char*)data;
+	m_size = size;
+	m_position = 0;
+	m_open = true;
+}
+
+bool MemoryFile::Open(const char* /*filename*/, const char* /*mode*/)
+{
+	return false;
+}
+
+bool MemoryFile::IsOpen()
+{
+	return m_open;
+}
+
+size_t MemoryFile::Read(void* data, size_t size, size_t count)
+{
+	if (!size || m_position >= m_size)
+	{
+		return 0;
+	}
+
+	// Ca fread, citim doar elemente intregi
+	size_t available = (m_size - m_position) / size;
+	if (count > available)
+	{
+		count = available;
+	}
+
+	memcpy(data, m_data + m_position, size * count);
+	m_position += size * count;
+
+	return count;
+}
+
+size_t MemoryFile::Write(const void* /*data*/, size_t /*size*/, size_t /*count*/)
+{
+	return 0;
+}
+
+int MemoryFile::Seek(long offset, int origin)
+{
+	long base;
+
+	switch (origin)
+	{
+	case SEEK_SET:
+		base = 0;
+		break;
+	case SEEK_CUR:
+		base = (long)m_position;
+		break;
+	case SEEK_END:
+		base = (long)m_size;
+		break;
+	default:
+		return -1;
+	}
+
+	// Nu putem iesi din bloc
+	if (base + offset < 0 || base + offset > (long)m_size)
+	{
+		return -1;
+	}
+
+	m_position = (size_t)(base + offset);
+	return 0;
+}
+
+long MemoryFile::Tell()
+{
+	return (long)m_position;
+}
+
+long MemoryFile::GetSize()
+{
+	return (long)m_size;
+}
+
+void MemoryFile::Close()
+{
+	if (m_owned)
+	{
+		delete[] m_data;
+		m_owned = false;
+	}
+
+	m_data = NULL;
+	m_size = 0;
+	m_position = 0;
+	m_open = false;
+}
+
+bool MemoryFile::IsStream()
+{
+	return false;
+}
+
+void* MemoryFile::GetInternalData()
+{
+	return (void*)m_data;
+}
+
+MemoryFile::~MemoryFile()
+{
+	MemoryFile::Close();
+}
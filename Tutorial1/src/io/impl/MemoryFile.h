@@ -0,0 +1,93 @@
+#ifndef MEMORYFILE_H_
+#define MEMORYFILE_H_
+
+#include <stddef.h>
+#include <File.h>
+
+/**
+ * Clasa ce implementeaza interfata File,
+ * modeleaza un fisier doar pentru citire aflat deja in memorie (de ex. o
+ * intrare dintr-o arhiva mapata). De obicei memoria nu este a obiectului
+ * si trebuie sa ramana valida cat timp este folosita. Continutul se poate folosi
+ * direct, fara copiere (GetData/GetLength), iar Read/Seek/Tell
+ * functioneaza in stilul fread/fseek
+ */
+class MemoryFile : public File
+{
+protected:
+	/**
+	* Continutul fisierului si pozitia curenta de citire
+	*/
+	const unsigned char* m_data;
+	size_t m_size;
+	size_t m_position;
+
+	bool m_open;
+
+	/**
+	* Memoria a fost alocata cu new[] si este eliberata la Close()
+	*/
+	bool m_owned;
+
+private:
+	// Nu copiem fisierele
+	MemoryFile(const MemoryFile&);
+	MemoryFile& operator=(const MemoryFile&);
+
+public:
+	/**
+	* Constructorul implicit; fisierul se deschide cu SetData()
+	*/
+	MemoryFile();
+
+	/**
+	* Creeaza un fisier peste size octeti de la data
+	*/
+	MemoryFile(const void* data, size_t size);
+
+	/**
+	* Deschide fisierul peste un bloc de memorie; cu owned, blocul a fost
+	* alocat cu new[] si devine al obiectului
+	*/
+	void SetData(const void* data, size_t size, bool owned = false);
+
+	/**
+	* Fisierele din memorie nu au nume; intoarce mereu false
+	*/
+	virtual bool Open(const char* filename, const char* mode = "rb");
+
+	// Mostenite din File
+	size_t Read(void* data, size_t size, size_t count);
+
+	int Seek(long offset, int origin = SEEK_SET);
+
+	long Tell();
+
+	long GetSize();
+
+	/**
+	* Fisierul este doar pentru citire; intoarce mereu 0
+	*/
+	size_t Write(const void* data, size_t size, size_t count);
+
+	bool IsOpen();
+
+	virtual void Close();
+
+	bool IsStream();
+
+	/**
+	* Intoarce inceputul continutului
+	*/
+	void* GetInternalData();
+
+	/**
+	* Continutul fisierului, valid pana la Close(); nu este terminat cu 0
+	*/
+	const unsigned char* GetData() const { return m_data; }
+	size_t GetLength() const { return m_size; }
+
+	virtual ~MemoryFile();
+};
+
+#endif /*MEMORYFILE_H_*/
@@ -0,0 +1,392 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <Log.h>
+#include "PackArchive.h"
+
+PackArchive::PackArchive() :
+	m_header(NULL), m_entries(NULL), m_names(NULL), m_restarts(NULL)
+{
+}
+
+bool PackArchive::Open(const char* filename)
+{
+	this->Close();
+
+	if (!m_file.Open(filename))
+	{
+		return false;
+	}
+
+	const unsigned char* data = m_file.GetData();
+	m_header = (const PackHeader*)data;
+
+	if (!this->Validate())
+	{
+		LogError("Invalid pack archive %s", filename);
+		this->Close();
+		return false;
+	}
+
+	m_entries = (const PackEntry*)(data + m_header->indexOffset);
+	m_names = (const char*)(data + m_header->namesOffset);
+	m_restarts = (const CompressedRestart*)(data + m_header->restartsOffset);
+
+	return true;
+}
+
+bool PackArchive::Validate() const
+{
+	if (m_file.GetLength() < sizeof(PackHeader))
+	{
+		return false;
+	}
+
+	const PackHeader& header = *m_header;
+	if (header.magic != PACK_MAGIC || header.version != PACK_VERSION ||
+		header.size > m_file.GetLength())
+	{
+		return false;
+	}
+
+	// Indexul si numele trebuie sa fie in arhiva (calculam pe 64 de biti)
+	uint64_t indexEnd = (uint64_t)header.indexOffset + (uint64_t)header.entryCount * sizeof(PackEntry);
+	uint64_t namesEnd = (uint64_t)header.namesOffset + header.namesSize;
+	uint64_t restartsEnd = (uint64_t)header.restartsOffset + (uint64_t)header.restartCount * sizeof(CompressedRestart);
+	if (header.indexOffset % sizeof(uint32_t) != 0 || header.restartsOffset % sizeof(uint32_t) != 0 ||
+		indexEnd > header.size || namesEnd > header.size || restartsEnd > header.size)
+	{
+		return false;
+	}
+
+	const unsigned char* data = m_file.GetData();
+	const PackEntry* entries = (const PackEntry*)(data + header.indexOffset);
+	const char* names = (const char*)(data + header.namesOffset);
+	const CompressedRestart* restarts = (const CompressedRestart*)(data + header.restartsOffset);
+
+	// Ultimul nume trebuie terminat cu 0, ca niciun nume sa nu iasa din tabela
+	if (header.entryCount && (!header.namesSize || names[header.namesSize - 1] != '\0'))
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header.entryCount; i++)
+	{
+		const PackEntry& entry = entries[i];
+		if (entry.nameOffset >= header.namesSize ||
+			(uint64_t)entry.offset + entry.size > header.size ||
+			(i > 0 && entries[i - 1].hash > entry.hash))
+		{
+			return false;
+		}
+
+		// Intrarile necomprimate nu au puncte de reluare
+		if (entry.compression == PACK_STORED)
+		{
+			if (entry.originalSize != entry.size || entry.restartCount)
+			{
+				return false;
+			}
+			continue;
+		}
+		if (entry.compression != PACK_DEFLATE ||
+			(uint64_t)entry.firstRestart + entry.restartCount > header.restartCount)
+		{
+			return false;
+		}
+
+		// Punctele de reluare sunt crescatoare si in interiorul intrarii
+		for (uint32_t r = 0; r < entry.restartCount; r++)
+		{
+			const CompressedRestart& restart = restarts[entry.firstRestart + r];
+			if (restart.offset > entry.size || restart.position > entry.originalSize ||
+				(r > 0 && restart.position <= restarts[entry.firstRestart + r - 1].position))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void PackArchive::Close()
+{
+	m_file.Close();
+	m_header = NULL;
+	m_entries = NULL;
+	m_names = NULL;
+	m_restarts = NULL;
+}
+
+int PackArchive::Find(const char* name) const
+{
+	if (!m_header)
+	{
+		return -1;
+	}
+
+	std::string normalized = NormalizeName(name);
+	uint32_t hash = HashName(normalized.c_str());
+
+	// Prima intrare cu acest hash
+	int lo = 0, hi = (int)m_header->entryCount;
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (m_entries[mid].hash < hash)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	// Coliziunile se rezolva comparand numele
+	for (int i = lo; i < (int)m_header->entryCount && m_entries[i].hash == hash; i++)
+	{
+		if (strcmp(m_names + m_entries[i].nameOffset, normalized.c_str()) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+const unsigned char* PackArchive::GetEntryData(int entry) const
+{
+	return m_file.GetData() + m_entries[entry].offset;
+}
+
+File* PackArchive::OpenEntry(int entry) const
+{
+	const PackEntry& info = m_entries[entry];
+
+	if (info.compression == PACK_DEFLATE)
+	{
+		return new CompressedFile(this->GetEntryData(entry), info.size, info.originalSize,
+			m_restarts + info.firstRestart, info.restartCount);
+	}
+
+	return new MemoryFile(this->GetEntryData(entry), info.size);
+}
+
+MemoryFile* PackArchive::MapEntry(int entry) const
+{
+	const PackEntry& info = m_entries[entry];
+
+	if (info.compression != PACK_DEFLATE)
+	{
+		return new MemoryFile(this->GetEntryData(entry), info.size);
+	}
+
+	// Decomprimam tot continutul intr-un bloc al fisierului intors
+	CompressedFile source(this->GetEntryData(entry), info.size, info.originalSize,
+		m_restarts + info.firstRestart, info.restartCount);
+	unsigned char* data = new unsigned char[info.originalSize ? info.originalSize : 1];
+	if (source.Read(data, 1, info.originalSize) != info.originalSize)
+	{
+		delete[] data;
+		return NULL;
+	}
+
+	MemoryFile* file = new MemoryFile();
+	file->SetData(data, info.originalSize, true);
+	return file;
+}
+
+std::string PackArchive::NormalizeName(const char* name, bool foldCase)
+{
+	// Sarim peste "./" si separatorii de la inceput
+	for (;;)
+	{
+		if (name[0] == '.' && (name[1] == '/' || name[1] == '\\'))
+		{
+			name += 2;
+		}
+		else if (name[0] == '/' || name[0] == '\\')
+		{
+			name++;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	std::string normalized(name);
+	for (size_t i = 0; i < normalized.size(); i++)
+	{
+		char c = normalized[i];
+		if (c == '\\')
+		{
+			c = '/';
+		}
+		else if (foldCase && c >= 'A' && c <= 'Z')
+		{
+			c = (char)(c - 'A' + 'a');
+		}
+		normalized[i] = c;
+	}
+
+	return normalized;
+}
+
+uint32_t PackArchive::HashName(const char* name)
+{
+	uint32_t hash = 2166136261u;
+
+	for (; *name; name++)
+	{
+		hash = (hash ^ (unsigned char)*name) * 16777619u;
+	}
+
+	return hash;
+}
+
+/**
+ * Un fisier de pus in arhiva, pe durata scrierii
+ */
+struct PackSource
+{
+	std::string name;
+	uint32_t hash;
+	const char* path;
+};
+
+static bool PackSourceLess(const PackSource& a, const PackSource& b)
+{
+	return a.hash < b.hash || (a.hash == b.hash && a.name < b.name);
+}
+
+static uint32_t AlignOffset(uint32_t offset)
+{
+	return (offset + PACK_ALIGN - 1) & ~(uint32_t)(PACK_ALIGN - 1);
+}
+
+/**
+ * Scrie zerouri pana la offset
+ */
+static bool PadTo(FILE* file, uint32_t& position, uint32_t offset)
+{
+	static const char zeros[PACK_ALIGN] = { 0 };
+
+	size_t count = offset - position;
+	position = offset;
+
+	return count == 0 || fwrite(zeros, 1, count, file) == count;
+}
+
+bool PackArchive::Write(const char* filename, const char* const* names, const char* const* paths, int count,
+	bool compress)
+{
+	std::vector<PackSource> sources(count);
+	for (int i = 0; i < count; i++)
+	{
+		sources[i].name = NormalizeName(names[i]);
+		sources[i].hash = HashName(sources[i].name.c_str());
+		sources[i].path = paths[i];
+	}
+	std::sort(sources.begin(), sources.end(), PackSourceLess);
+
+	FILE* file = fopen(filename, "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	// Antetul se rescrie la sfarsit, cand stim toate pozitiile
+	PackHeader header;
+	memset(&header, 0, sizeof(header));
+	uint32_t position = sizeof(PackHeader);
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+	// Continutul fisierelor, comprimat daca merita
+	std::vector<PackEntry> entries(count);
+	std::vector<CompressedRestart> restarts;
+	std::string nameTable;
+	for (int i = 0; i < count && ok; i++)
+	{
+		MappedFile source;
+		ok = source.Open(sources[i].path) && PadTo(file, position, AlignOffset(position));
+		if (!ok)
+		{
+			break;
+		}
+
+		PackEntry& entry = entries[i];
+		entry.hash = sources[i].hash;
+		entry.nameOffset = (uint32_t)nameTable.size();
+		entry.offset = position;
+		entry.size = (uint32_t)source.GetLength();
+		entry.originalSize = entry.size;
+		entry.compression = PACK_STORED;
+		entry.firstRestart = 0;
+		entry.restartCount = 0;
+
+		const unsigned char* data = source.GetData();
+		unsigned char* compressed = NULL;
+		CompressedRestart* points = NULL;
+		size_t compressedSize = 0;
+		int pointCount = 0;
+		if (compress && entry.size &&
+			CompressedFile::Compress(data, entry.size, PACK_RESTART_INTERVAL, compressed, compressedSize, points, pointCount) &&
+			compressedSize < entry.size)
+		{
+			data = compressed;
+			entry.size = (uint32_t)compressedSize;
+			entry.compression = PACK_DEFLATE;
+			entry.firstRestart = (uint32_t)restarts.size();
+			entry.restartCount = pointCount;
+			restarts.insert(restarts.end(), points, points + pointCount);
+		}
+
+		ok = !entry.size || fwrite(data, 1, entry.size, file) == entry.size;
+		position += entry.size;
+
+		delete[] compressed;
+		delete[] points;
+
+		nameTable += sources[i].name;
+		nameTable += '\0';
+	}
+
+	// Indexul, punctele de reluare si numele
+	header.magic = PACK_MAGIC;
+	header.version = PACK_VERSION;
+	header.entryCount = count;
+	header.indexOffset = AlignOffset(position);
+	header.restartsOffset = header.indexOffset + count * sizeof(PackEntry);
+	header.restartCount = (uint32_t)restarts.size();
+	header.namesOffset = header.restartsOffset + header.restartCount * sizeof(CompressedRestart);
+	header.namesSize = (uint32_t)nameTable.size();
+	header.size = header.namesOffset + header.namesSize;
+
+	ok = ok && PadTo(file, position, header.indexOffset);
+	if (ok && count)
+	{
+		ok = fwrite(&entries[0], sizeof(PackEntry), count, file) == (size_t)count;
+	}
+	if (ok && !restarts.empty())
+	{
+		ok = fwrite(&restarts[0], sizeof(CompressedRestart), restarts.size(), file) == restarts.size();
+	}
+	if (ok && !nameTable.empty())
+	{
+		ok = fwrite(nameTable.data(), 1, nameTable.size(), file) == nameTable.size();
+	}
+
+	ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+	ok = fclose(file) == 0 && ok;
+
+	return ok;
+}
+
+PackArchive::~PackArchive()
+{
+	this->Close();
+}
@@ -0,0 +1,161 @@
+#ifndef PACKARCHIVE_H_
+#define PACKARCHIVE_H_
+
+#include <string>
+#include <Types.h>
+#include <MappedFile.h>
+#include <CompressedFile.h>
+
+/**
+ * Semnatura si versiunea formatului arhivei
+ */
+#define PACK_MAGIC			0x4B504B53	// "SKPK"
+#define PACK_VERSION		2
+
+/**
+ * Continutul fiecarui fisier incepe la un multiplu de PACK_ALIGN octeti,
+ * ca formatele binare sa poata fi folosite direct din arhiva
+ */
+#define PACK_ALIGN			16
+
+/**
+ * Intrarile comprimate au cate un punct de reluare la fiecare
+ * PACK_RESTART_INTERVAL octeti decomprimati
+ */
+#define PACK_RESTART_INTERVAL	(256 * 1024)
+
+/**
+ * Cum este pastrat continutul unei intrari
+ */
+enum PackCompression
+{
+	PACK_STORED,
+	PACK_DEFLATE
+};
+
+/**
+ * Antetul arhivei; toate pozitiile sunt offset-uri fata de inceputul ei
+ */
+struct PackHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t size;			// Dimensiunea intregii arhive
+	uint32_t entryCount;
+	uint32_t indexOffset;	// entryCount intrari PackEntry
+	uint32_t namesOffset;	// Numele, terminate cu 0
+	uint32_t namesSize;
+	uint32_t restartsOffset;	// restartCount puncte de reluare CompressedRestart
+	uint32_t restartCount;
+};
+
+/**
+ * O intrare din index; intrarile sunt ordonate dupa hash si apoi dupa nume
+ */
+struct PackEntry
+{
+	uint32_t hash;
+	uint32_t nameOffset;	// Relativ la namesOffset
+	uint32_t offset;
+	uint32_t size;			// Octetii din arhiva
+	uint32_t originalSize;	// Octetii decomprimati
+	uint32_t compression;	// PackCompression
+	uint32_t firstRestart;	// Punctele de reluare ale intrarii in tabela arhivei
+	uint32_t restartCount;
+};
+
+/**
+ * Arhiva cu mai multe fisiere, deschisa o singura data si mapata in
+ * memorie. Cautarea unui fisier este o cautare binara dupa hash-ul
+ * numelui in indexul ordonat, fara apeluri de sistem; fisierele gasite
+ * sunt folosite direct din mapare. Intrarile pot fi comprimate cu
+ * deflate; punctele lor de reluare sunt pastrate in index
+ */
+class PackArchive
+{
+private:
+	MappedFile m_file;
+
+	const PackHeader* m_header;
+	const PackEntry* m_entries;
+	const char* m_names;
+	const CompressedRestart* m_restarts;
+
+	/**
+	* Verifica antetul, indexul si ca toate intrarile sunt in arhiva
+	*/
+	bool Validate() const;
+
+	// Nu copiem arhivele
+	PackArchive(const PackArchive&);
+	PackArchive& operator=(const PackArchive&);
+
+public:
+	PackArchive();
+
+	/**
+	* Mapeaza arhiva si ii verifica indexul
+	*/
+	bool Open(const char* filename);
+
+	bool IsOpen() const { return m_header != NULL; }
+
+	/**
+	* Inchide arhiva; fisierele deschise din ea nu mai pot fi folosite
+	*/
+	void Close();
+
+	int GetEntryCount() const { return m_header ? (int)m_header->entryCount : 0; }
+	const char* GetEntryName(int entry) const { return m_names + m_entries[entry].nameOffset; }
+
+	/**
+	* Cauta un fisier dupa nume; intoarce indexul intrarii sau -1
+	*/
+	int Find(const char* name) const;
+
+	/**
+	* Continutul unei intrari, direct din mapare (comprimat pentru intrarile
+	* comprimate), dimensiunea lui si dimensiunea decomprimata
+	*/
+	const unsigned char* GetEntryData(int entry) const;
+	size_t GetEntrySize(int entry) const { return m_entries[entry].size; }
+	size_t GetEntryOriginalSize(int entry) const { return m_entries[entry].originalSize; }
+	bool IsEntryCompressed(int entry) const { return m_entries[entry].compression == PACK_DEFLATE; }
+
+	/**
+	* Deschide o intrare pentru citire secventiala: direct din mapare sau,
+	* pentru intrarile comprimate, decomprimata pe masura ce e citita.
+	* Obiectul intors trebuie sters de apelant
+	*/
+	File* OpenEntry(int entry) const;
+
+	/**
+	* Deschide o intrare cu tot continutul in memorie: direct din mapare sau,
+	* pentru intrarile comprimate, decomprimata intr-un bloc nou.
+	* Obiectul intors trebuie sters de apelant; NULL la eroare
+	*/
+	MemoryFile* MapEntry(int entry) const;
+
+	/**
+	* Aduce un nume la forma din index: separatori '/', fara "./" sau '/'
+	* la inceput si, daca foldCase, cu litere mici
+	*/
+	static std::string NormalizeName(const char* name, bool foldCase = true);
+
+	/**
+	* Hash-ul (FNV-1a) unui nume normalizat
+	*/
+	static uint32_t HashName(const char* name);
+
+	/**
+	* Scrie o arhiva cu fisierele date; in arhiva fisierele se numesc
+	* dupa numele din names, normalizate. Cu compress, fisierele care se
+	* micsoreaza sunt comprimate cu deflate
+	*/
+	static bool Write(const char* filename, const char* const* names, const char* const* paths, int count,
+		bool compress = false);
+
+	~PackArchive();
+};
+
+#endif /*PACKARCHIVE_H_*/
@@ -0,0 +1,140 @@
+#include <string.h>
+#include <MemoryFile.h>
+#include "TextReader.h"
+
+TextReader::TextReader() :
+	m_file(NULL), m_data(NULL), m_size(0), m_position(0), m_buffer(NULL), m_capacity(0),
+	m_end(true), m_lineNumber(0)
+{
+}
+
+TextReader::TextReader(const void* data, size_t size) :
+	m_file(NULL), m_data(NULL), m_size(0), m_position(0), m_buffer(NULL), m_capacity(0),
+	m_end(true), m_lineNumber(0)
+{
+	this->SetData(data, size);
+}
+
+TextReader::TextReader(File* file) :
+	m_file(NULL), m_data(NULL), m_size(0), m_position(0), m_buffer(NULL), m_capacity(0),
+	m_end(true), m_lineNumber(0)
+{
+	this->SetFile(file);
+}
+
+void TextReader::SetData(const void* data, size_t size)
+{
+	m_file = NULL;
+	m_data = (const char*)data;
+	m_size = size;
+	m_position = 0;
+	m_end = true;
+	m_lineNumber = 0;
+}
+
+void TextReader::SetFile(File* file)
+{
+	// Fisierele din memorie se citesc direct, de la pozitia curenta
+	MemoryFile* memory = dynamic_cast<MemoryFile*>(file);
+	if (memory)
+	{
+		size_t position = (size_t)memory->Tell();
+		this->SetData(memory->GetData() + position, memory->GetLength() - position);
+		return;
+	}
+
+	if (!m_buffer)
+	{
+		m_capacity = TEXTREADER_BUFFER_SIZE;
+		m_buffer = new char[m_capacity];
+	}
+
+	m_file = file;
+	m_data = m_buffer;
+	m_size = 0;
+	m_position = 0;
+	m_end = !file || !file->IsOpen();
+	m_lineNumber = 0;
+}
+
+bool TextReader::Fill()
+{
+	if (m_end)
+	{
+		return false;
+	}
+
+	// Bufferul plin cu o singura linie: il dublam
+	size_t left = m_size - m_position;
+	if (left == m_capacity)
+	{
+		char* buffer = new char[m_capacity * 2];
+		memcpy(buffer, m_buffer, left);
+		delete[] m_buffer;
+		m_buffer = buffer;
+		m_capacity *= 2;
+	}
+	else
+	{
+		memmove(m_buffer, m_buffer + m_position, left);
+	}
+
+	size_t count = m_file->Read(m_buffer + left, 1, m_capacity - left);
+	m_end = count == 0;
+
+	m_data = m_buffer;
+	m_position = 0;
+	m_size = left + count;
+
+	return count > 0;
+}
+
+bool TextReader::NextLine(StringView& line)
+{
+	// Cautam doar in octetii noi, ca liniile lungi sa nu fie parcurse de mai multe ori
+	size_t scanned = 0;
+	const char* newline;
+
+	for (;;)
+	{
+		const char* start = m_data + m_position + scanned;
+		size_t count = m_size - m_position - scanned;
+		newline = count ? (const char*)memchr(start, '\n', count) : NULL;
+
+		if (newline)
+		{
+			break;
+		}
+
+		scanned += count;
+		if (!this->Fill())
+		{
+			break;
+		}
+	}
+
+	const char* begin = m_data + m_position;
+	const char* end = newline ? newline : m_data + m_size;
+
+	// Ultima linie poate sa nu aiba "\n"
+	if (!newline && begin == end)
+	{
+		return false;
+	}
+
+	m_position = end - m_data + (newline ? 1 : 0);
+	if (end > begin && end[-1] == '\r')
+	{
+		end--;
+	}
+
+	line = StringView(begin, end - begin);
+	m_lineNumber++;
+
+	return true;
+}
+
+TextReader::~TextReader()
+{
+	delete[] m_buffer;
+}
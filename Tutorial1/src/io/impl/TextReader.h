@@ -0,0 +1,83 @@
+#ifndef TEXTREADER_H_
+#define TEXTREADER_H_
+
+#include <stddef.h>
+#include <File.h>
+#include <StringView.h>
+
+/**
+ * Cati octeti se citesc o data din fisierele care nu sunt in memorie
+ */
+#define TEXTREADER_BUFFER_SIZE		(64 * 1024)
+
+/**
+ * Citeste un text linie cu linie, fara copiere cand textul este deja
+ * in memorie (un bloc de memorie sau un MemoryFile, de ex. mapat sau
+ * dintr-o arhiva). Celelalte fisiere se citesc in bucati intr-un buffer
+ * care creste pentru liniile foarte lungi. Obiectul nu are stare
+ * partajata, deci mai multe fisiere pot fi citite in paralel
+ */
+class TextReader
+{
+private:
+	/**
+	* Fisierul citit prin buffer, sau NULL cand textul este in memorie
+	*/
+	File* m_file;
+
+	/**
+	* Textul din memorie, respectiv bufferul: octetii [m_position, m_size)
+	* sunt necititi
+	*/
+	const char* m_data;
+	size_t m_size;
+	size_t m_position;
+
+	char* m_buffer;
+	size_t m_capacity;
+	bool m_end;
+
+	int m_lineNumber;
+
+	/**
+	* Muta restul necitit la inceputul bufferului si citeste in continuare
+	*/
+	bool Fill();
+
+	// Nu copiem cititoarele
+	TextReader(const TextReader&);
+	TextReader& operator=(const TextReader&);
+
+public:
+	TextReader();
+
+	/**
+	* Citeste din size octeti de la data
+	*/
+	TextReader(const void* data, size_t size);
+
+	/**
+	* Citeste din fisier, de la pozitia curenta
+	*/
+	explicit TextReader(File* file);
+
+	void SetData(const void* data, size_t size);
+
+	void SetFile(File* file);
+
+	/**
+	* Urmatoarea linie, fara "\n" sau "\r\n"; intoarce false la sfarsitul
+	* textului. Pentru fisierele citite prin buffer, linia este valida
+	* pana la urmatorul apel
+	*/
+	bool NextLine(StringView& line);
+
+	/**
+	* Numarul ultimei linii intoarse, incepand de la 1
+	*/
+	int GetLineNumber() const { return m_lineNumber; }
+
+	~TextReader();
+};
+
+#endif /*TEXTREADER_H_*/
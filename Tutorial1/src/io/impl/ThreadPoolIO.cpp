@@ -0,0 +1,216 @@
+#include <string.h>
+#include <Log.h>
+#include <MemoryFile.h>
+#include "ThreadPoolIO.h"
+
+ThreadPoolIO::ThreadPoolIO(int threadCount) : m_stop(false), m_pending(0)
+{
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		Thread* thread = new Thread();
+		if (!thread->Start(Worker, this))
+		{
+			LogError("Failed to start I/O thread %d", i);
+			delete thread;
+			break;
+		}
+		m_threads.push_back(thread);
+	}
+}
+
+bool ThreadPoolIO::IsMemoryFile(File* file)
+{
+	return dynamic_cast<MemoryFile*>(file) != NULL;
+}
+
+long ThreadPoolIO::ReadNow(AsyncRequest& request)
+{
+	if (!request.file || !request.file->IsOpen() || request.offset < 0)
+	{
+		return -1;
+	}
+
+	// Din memorie copiem direct; continutul nu se schimba, deci nu blocam fisierul
+	MemoryFile* memory = dynamic_cast<MemoryFile*>(request.file);
+	if (memory)
+	{
+		size_t length = memory->GetLength();
+		if ((size_t)request.offset >= length)
+		{
+			return 0;
+		}
+
+		size_t size = length - request.offset < request.size ? length - request.offset : request.size;
+		memcpy(request.buffer, memory->GetData() + request.offset, size);
+		return (long)size;
+	}
+
+	if (request.file->Seek(request.offset, SEEK_SET) != 0)
+	{
+		return -1;
+	}
+
+	return (long)request.file->Read(request.buffer, 1, request.size);
+}
+
+void ThreadPoolIO::Worker(void* pool)
+{
+	ThreadPoolIO* self = (ThreadPoolIO*)pool;
+
+	for (;;)
+	{
+		AsyncRequest* request;
+		{
+			ScopedLock lock(self->m_mutex);
+			while (self->m_queue.empty() && !self->m_stop)
+			{
+				self->m_work.Wait(self->m_mutex);
+			}
+			if (self->m_queue.empty())
+			{
+				return;
+			}
+			request = self->m_queue.front();
+			self->m_queue.pop_front();
+		}
+
+		// Un File are o singura pozitie curenta, deci Seek+Read pe acelasi fisier se serializeaza
+		long result;
+		{
+			ScopedLock lock(self->m_fileLocks[((size_t)request->file / sizeof(void*)) % THREADPOOL_FILE_LOCKS]);
+			result = ReadNow(*request);
+		}
+
+		ScopedLock lock(self->m_mutex);
+		request->result = result;
+		self->m_completed.push_back(request);
+		self->m_finished.Broadcast();
+	}
+}
+
+bool ThreadPoolIO::Submit(AsyncRequest& request)
+{
+	if (!request.file || (!request.buffer && request.size))
+	{
+		return false;
+	}
+
+	request.result = 0;
+	request.done = false;
+	request.backend = this;
+	m_pending++;
+
+	// Fisierele din memorie nu au nevoie de fire; rezultatul se livreaza tot din Poll()
+	bool direct = IsMemoryFile(request.file) || m_threads.empty();
+	if (direct)
+	{
+		request.result = ReadNow(request);
+	}
+
+	ScopedLock lock(m_mutex);
+	if (direct)
+	{
+		m_completed.push_back(&request);
+	}
+	else
+	{
+		m_queue.push_back(&request);
+		m_work.Signal();
+	}
+
+	return true;
+}
+
+int ThreadPoolIO::Deliver(std::vector<AsyncRequest*>& completed)
+{
+	for (size_t i = 0; i < completed.size(); i++)
+	{
+		AsyncRequest& request = *completed[i];
+		request.done = true;
+		m_pending--;
+
+		if (request.callback)
+		{
+			request.callback(request);
+		}
+	}
+
+	return (int)completed.size();
+}
+
+int ThreadPoolIO::Poll()
+{
+	std::vector<AsyncRequest*> completed;
+	{
+		ScopedLock lock(m_mutex);
+		completed.swap(m_completed);
+	}
+
+	// Callback-urile ruleaza fara mutex, ca sa poata trimite alte cereri
+	return this->Deliver(completed);
+}
+
+void ThreadPoolIO::Wait(AsyncRequest& request)
+{
+	while (!request.done && request.backend == this)
+	{
+		std::vector<AsyncRequest*> completed;
+		{
+			ScopedLock lock(m_mutex);
+			while (m_completed.empty())
+			{
+				m_finished.Wait(m_mutex);
+			}
+			completed.swap(m_completed);
+		}
+		this->Deliver(completed);
+	}
+}
+
+void ThreadPoolIO::WaitAll()
+{
+	while (m_pending > 0)
+	{
+		std::vector<AsyncRequest*> completed;
+		{
+			ScopedLock lock(m_mutex);
+			while (m_completed.empty())
+			{
+				m_finished.Wait(m_mutex);
+			}
+			completed.swap(m_completed);
+		}
+		this->Deliver(completed);
+	}
+}
+
+int ThreadPoolIO::GetPending()
+{
+	return m_pending;
+}
+
+const char* ThreadPoolIO::GetName()
+{
+	return "thread pool";
+}
+
+ThreadPoolIO::~ThreadPoolIO()
+{
+	this->WaitAll();
+
+	{
+		ScopedLock lock(m_mutex);
+		m_stop = true;
+		m_work.Broadcast();
+	}
+
+	for (size_t i = 0; i < m_threads.size(); i++)
+	{
+		delete m_threads[i];
+	}
+}
@@ -0,0 +1,94 @@
+#ifndef THREADPOOLIO_H_
+#define THREADPOOLIO_H_
+
+#include <deque>
+#include <vector>
+#include <AsyncIO.h>
+#include <Thread.h>
+
+/**
+ * Cate mutexuri protejeaza fisierele; cererile pe acelasi File sunt
+ * serializate (Seek+Read nu este atomic), cele pe fisiere diferite
+ * pot rula in paralel
+ */
+#define THREADPOOL_FILE_LOCKS	16
+
+/**
+ * Clasa ce implementeaza interfata AsyncIO,
+ * portabila: un grup de fire care citesc prin Seek()/Read(), deci
+ * merge cu orice implementare File. Fisierele din memorie (MemoryFile)
+ * sunt copiate direct la Submit(), fara sa treaca prin fire
+ */
+class ThreadPoolIO : public AsyncIO
+{
+private:
+	std::vector<Thread*> m_threads;
+
+	/**
+	* Coada de cereri, cererile terminate si nelivrate; protejate de m_mutex
+	*/
+	Mutex m_mutex;
+	Condition m_work;
+	Condition m_finished;
+	std::deque<AsyncRequest*> m_queue;
+	std::vector<AsyncRequest*> m_completed;
+	bool m_stop;
+
+	/**
+	* Cereri trimise si nelivrate; doar pe firul proprietarului
+	*/
+	int m_pending;
+
+	Mutex m_fileLocks[THREADPOOL_FILE_LOCKS];
+
+	/**
+	* Bucla unui fir din grup
+	*/
+	static void Worker(void* pool);
+
+	/**
+	* Marcheaza cererile terminate si apeleaza callback-urile
+	*/
+	int Deliver(std::vector<AsyncRequest*>& completed);
+
+	// Nu copiem grupurile de fire
+	ThreadPoolIO(const ThreadPoolIO&);
+	ThreadPoolIO& operator=(const ThreadPoolIO&);
+
+public:
+	/**
+	* Porneste threadCount fire (cel putin unul)
+	*/
+	explicit ThreadPoolIO(int threadCount);
+
+	// Mostenite din AsyncIO
+	bool Submit(AsyncRequest& request);
+
+	int Poll();
+
+	void Wait(AsyncRequest& request);
+
+	void WaitAll();
+
+	int GetPending();
+
+	const char* GetName();
+
+	/**
+	* Citeste sincron o cerere, prin Seek()/Read(); intoarce octetii cititi
+	* sau -1. Pentru MemoryFile copiaza direct, fara sa mute pozitia
+	*/
+	static long ReadNow(AsyncRequest& request);
+
+	/**
+	* Verifica daca fisierul este deja in memorie
+	*/
+	static bool IsMemoryFile(File* file);
+
+	/**
+	* Asteapta cererile ramase si opreste firele
+	*/
+	virtual ~ThreadPoolIO();
+};
+
+#endif /*THREADPOOLIO_H_*/
@@ -0,0 +1,454 @@
+#include <string.h>
+#include <Log.h>
+#include <LocalFile.h>
+#include <Thread.h>
+#include "UringIO.h"
+
+// io_uring are nevoie de headerele nucleului (Linux 5.1+); liburing nu este folosit
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(IORING_FEAT_RW_CUR_POS)
+#define URING_AVAILABLE 1
+#endif
+#endif
+#endif
+
+UringIO::UringIO(int queueDepth) :
+	m_ring(-1), m_sqMemory(NULL), m_sqMemorySize(0), m_cqMemory(NULL), m_cqMemorySize(0),
+	m_entries(NULL), m_entriesSize(0), m_sqHead(NULL), m_sqTail(NULL), m_sqMask(NULL),
+	m_sqArray(NULL), m_cqHead(NULL), m_cqTail(NULL), m_cqMask(NULL), m_completions(NULL),
+	m_depth(queueDepth > 0 ? queueDepth : 1), m_inFlight(0), m_unsubmitted(0), m_fallback(NULL)
+{
+#ifdef URING_AVAILABLE
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	int ring = (int)syscall(__NR_io_uring_setup, (unsigned)m_depth, &params);
+	if (ring < 0)
+	{
+		LogError("Failed to create io_uring: %s", strerror(errno));
+		return;
+	}
+
+	// IORING_OP_READ a aparut o data cu IORING_FEAT_RW_CUR_POS (Linux 5.6)
+	if (!(params.features & IORING_FEAT_RW_CUR_POS))
+	{
+		LogError("io_uring is too old, IORING_OP_READ is not supported");
+		close(ring);
+		return;
+	}
+	m_ring = ring;
+
+	m_sqMemorySize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	m_cqMemorySize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+	// Nucleele noi mapeaza ambele inele dintr-o data
+	bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (single && m_cqMemorySize > m_sqMemorySize)
+	{
+		m_sqMemorySize = m_cqMemorySize;
+	}
+
+	m_sqMemory = mmap(NULL, m_sqMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		m_ring, IORING_OFF_SQ_RING);
+	if (m_sqMemory == MAP_FAILED)
+	{
+		m_sqMemory = NULL;
+	}
+
+	if (single)
+	{
+		m_cqMemory = m_sqMemory;
+	}
+	else
+	{
+		m_cqMemory = mmap(NULL, m_cqMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			m_ring, IORING_OFF_CQ_RING);
+		if (m_cqMemory == MAP_FAILED)
+		{
+			m_cqMemory = NULL;
+		}
+	}
+
+	m_entriesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	m_entries = mmap(NULL, m_entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		m_ring, IORING_OFF_SQES);
+	if (m_entries == MAP_FAILED)
+	{
+		m_entries = NULL;
+	}
+
+	if (!m_sqMemory || !m_cqMemory || !m_entries)
+	{
+		LogError("Failed to map io_uring: %s", strerror(errno));
+		this->Free();
+		return;
+	}
+
+	unsigned char* sq = (unsigned char*)m_sqMemory;
+	m_sqHead = (unsigned*)(sq + params.sq_off.head);
+	m_sqTail = (unsigned*)(sq + params.sq_off.tail);
+	m_sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+	m_sqArray = (unsigned*)(sq + params.sq_off.array);
+
+	unsigned char* cq = (unsigned char*)m_cqMemory;
+	m_cqHead = (unsigned*)(cq + params.cq_off.head);
+	m_cqTail = (unsigned*)(cq + params.cq_off.tail);
+	m_cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+	m_completions = cq + params.cq_off.cqes;
+
+	// Inelul de trimitere are cel putin queueDepth intrari (rotunjit la o putere a lui 2)
+	if ((unsigned)m_depth > params.sq_entries)
+	{
+		m_depth = (int)params.sq_entries;
+	}
+#endif
+}
+
+bool UringIO::IsSupported()
+{
+#ifdef URING_AVAILABLE
+	static int supported = -1;
+
+	if (supported < 0)
+	{
+		struct io_uring_params params;
+		memset(&params, 0, sizeof(params));
+
+		// Poate fi si dezactivat (de ex. de seccomp in containere)
+		int ring = (int)syscall(__NR_io_uring_setup, 1u, &params);
+		supported = ring >= 0 && (params.features & IORING_FEAT_RW_CUR_POS) ? 1 : 0;
+		if (ring >= 0)
+		{
+			close(ring);
+		}
+	}
+
+	return supported == 1;
+#else
+	return false;
+#endif
+}
+
+int UringIO::GetDescriptor(File* file)
+{
+#ifdef URING_AVAILABLE
+	// Citim direct de pe descriptor, pe langa bufferul FILE*; fisierul trebuie sa fie doar pentru citire
+	LocalFile* local = dynamic_cast<LocalFile*>(file);
+	if (local && local->IsOpen())
+	{
+		return fileno((FILE*)local->GetInternalData());
+	}
+#else
+	(void)file;
+#endif
+	return -1;
+}
+
+void UringIO::Push(AsyncRequest& request)
+{
+#ifdef URING_AVAILABLE
+	// Suntem singurii care scriu coada inelului de trimitere
+	unsigned tail = *m_sqTail;
+	unsigned index = tail & *m_sqMask;
+
+	// result tine octetii deja cititi, pentru citirile reluate dupa una partiala
+	struct io_uring_sqe* entry = (struct io_uring_sqe*)m_entries + index;
+	memset(entry, 0, sizeof(*entry));
+	entry->opcode = IORING_OP_READ;
+	entry->fd = GetDescriptor(request.file);
+	entry->off = (unsigned long long)request.offset + request.result;
+	entry->addr = (unsigned long long)(size_t)((unsigned char*)request.buffer + request.result);
+	entry->len = (unsigned)(request.size - request.result);
+	entry->user_data = (unsigned long long)(size_t)&request;
+
+	m_sqArray[index] = index;
+	__atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+	m_unsubmitted++;
+	m_inFlight++;
+#else
+	(void)request;
+#endif
+}
+
+bool UringIO::Enter(bool wait)
+{
+#ifdef URING_AVAILABLE
+	if (!m_unsubmitted && !wait)
+	{
+		return true;
+	}
+
+	for (;;)
+	{
+		int result = (int)syscall(__NR_io_uring_enter, m_ring, (unsigned)m_unsubmitted,
+			wait ? 1u : 0u, wait ? IORING_ENTER_GETEVENTS : 0u, NULL, 0);
+		if (result >= 0)
+		{
+			m_unsubmitted -= result;
+			return true;
+		}
+
+		// Intrerupti de un semnal reincercam; fara resurse, reincercam la urmatorul Poll()
+		if (errno == EAGAIN || errno == EBUSY)
+		{
+			return true;
+		}
+		if (errno != EINTR)
+		{
+			LogError("io_uring_enter failed: %s", strerror(errno));
+			return false;
+		}
+	}
+#else
+	(void)wait;
+	return false;
+#endif
+}
+
+void UringIO::Reap()
+{
+#ifdef URING_AVAILABLE
+	unsigned head = *m_cqHead;
+	unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+	while (head != tail)
+	{
+		struct io_uring_cqe* completion = (struct io_uring_cqe*)m_completions + (head & *m_cqMask);
+		AsyncRequest* request = (AsyncRequest*)(size_t)completion->user_data;
+		int result = completion->res;
+		head++;
+		m_inFlight--;
+
+		if (result < 0)
+		{
+			request->result = -1;
+			m_completed.push_back(request);
+		}
+		else
+		{
+			// O citire partiala care nu e la sfarsitul fisierului se continua
+			request->result += result;
+			if (result > 0 && (size_t)request->result < request->size)
+			{
+				m_waiting.push_front(request);
+			}
+			else
+			{
+				m_completed.push_back(request);
+			}
+		}
+	}
+
+	__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+#endif
+
+	while (m_inFlight < m_depth && !m_waiting.empty())
+	{
+		AsyncRequest* request = m_waiting.front();
+		m_waiting.pop_front();
+		this->Push(*request);
+	}
+}
+
+int UringIO::Deliver()
+{
+	std::vector<AsyncRequest*> completed;
+	completed.swap(m_completed);
+
+	// Callback-urile pot trimite alte cereri
+	for (size_t i = 0; i < completed.size(); i++)
+	{
+		AsyncRequest& request = *completed[i];
+		request.done = true;
+
+		if (request.callback)
+		{
+			request.callback(request);
+		}
+	}
+
+	return (int)completed.size();
+}
+
+bool UringIO::Submit(AsyncRequest& request)
+{
+	if (!request.file || (!request.buffer && request.size))
+	{
+		return false;
+	}
+
+	request.result = 0;
+	request.done = false;
+
+	int descriptor = m_ring >= 0 ? GetDescriptor(request.file) : -1;
+	if (descriptor < 0)
+	{
+		// Din memorie copiem direct, restul merge la grupul de fire
+		if (ThreadPoolIO::IsMemoryFile(request.file))
+		{
+			request.backend = this;
+			request.result = ThreadPoolIO::ReadNow(request);
+			m_completed.push_back(&request);
+			return true;
+		}
+
+		if (!m_fallback)
+		{
+			int threads = Thread::GetProcessorCount();
+			m_fallback = new ThreadPoolIO(threads < m_depth ? threads : m_depth);
+		}
+		return m_fallback->Submit(request);
+	}
+
+	request.backend = this;
+
+	if (request.offset < 0 || !request.size)
+	{
+		request.result = request.offset < 0 ? -1 : 0;
+		m_completed.push_back(&request);
+	}
+	else if (m_inFlight < m_depth)
+	{
+		this->Push(request);
+	}
+	else
+	{
+		m_waiting.push_back(&request);
+	}
+
+	return true;
+}
+
+int UringIO::Poll()
+{
+	int delivered = 0;
+
+	if (m_ring >= 0)
+	{
+		this->Enter(false);
+		this->Reap();
+		this->Enter(false);
+	}
+
+	delivered += this->Deliver();
+	if (m_fallback)
+	{
+		delivered += m_fallback->Poll();
+	}
+
+	return delivered;
+}
+
+void UringIO::Wait(AsyncRequest& request)
+{
+	if (request.backend != this)
+	{
+		if (request.backend && !request.done)
+		{
+			request.backend->Wait(request);
+		}
+		return;
+	}
+
+	while (!request.done)
+	{
+		// Asteptam in nucleu doar daca nu avem deja ceva de livrat
+		if (m_completed.empty() && m_inFlight > 0)
+		{
+			if (!this->Enter(true))
+			{
+				return;
+			}
+		}
+		else if (m_completed.empty() && m_waiting.empty())
+		{
+			return;
+		}
+
+		this->Reap();
+		this->Deliver();
+	}
+}
+
+void UringIO::WaitAll()
+{
+	for (;;)
+	{
+		if (!m_completed.empty())
+		{
+			this->Deliver();
+		}
+		else if (m_inFlight > 0)
+		{
+			if (!this->Enter(true))
+			{
+				return;
+			}
+			this->Reap();
+		}
+		else if (!m_waiting.empty())
+		{
+			this->Reap();
+		}
+		else if (m_fallback && m_fallback->GetPending() > 0)
+		{
+			m_fallback->WaitAll();
+		}
+		else
+		{
+			return;
+		}
+	}
+}
+
+int UringIO::GetPending()
+{
+	return m_inFlight + (int)m_waiting.size() + (int)m_completed.size() +
+		(m_fallback ? m_fallback->GetPending() : 0);
+}
+
+const char* UringIO::GetName()
+{
+	return m_ring >= 0 ? "io_uring" : "io_uring (unavailable, thread pool)";
+}
+
+void UringIO::Free()
+{
+#ifdef URING_AVAILABLE
+	if (m_entries)
+	{
+		munmap(m_entries, m_entriesSize);
+	}
+	if (m_cqMemory && m_cqMemory != m_sqMemory)
+	{
+		munmap(m_cqMemory, m_cqMemorySize);
+	}
+	if (m_sqMemory)
+	{
+		munmap(m_sqMemory, m_sqMemorySize);
+	}
+	if (m_ring >= 0)
+	{
+		close(m_ring);
+	}
+#endif
+
+	m_entries = NULL;
+	m_cqMemory = NULL;
+	m_sqMemory = NULL;
+	m_ring = -1;
+}
+
+UringIO::~UringIO()
+{
+	this->WaitAll();
+	this->Free();
+	delete m_fallback;
+}
@@ -0,0 +1,129 @@
+#ifndef URINGIO_H_
+#define URINGIO_H_
+
+#include <deque>
+#include <vector>
+#include <AsyncIO.h>
+#include <ThreadPoolIO.h>
+
+/**
+ * Clasa ce implementeaza interfata AsyncIO,
+ * pe Linux, cu io_uring (apeluri de sistem directe, fara liburing):
+ * citirile din LocalFile se fac cu IORING_OP_READ pe descriptorul
+ * fisierului, fara fire suplimentare si cu un singur apel de sistem
+ * pentru toate cererile trimise intre doua Poll()/Wait(). Celelalte
+ * fisiere (de ex. comprimate) sunt trimise unui ThreadPoolIO, iar cele
+ * din memorie sunt copiate direct. Pe alte sisteme IsSupported() este false
+ */
+class UringIO : public AsyncIO
+{
+private:
+	/**
+	* Descriptorul inelului si zonele mapate: inelul de trimitere,
+	* inelul de terminare si vectorul de intrari (SQE)
+	*/
+	int m_ring;
+	void* m_sqMemory;
+	size_t m_sqMemorySize;
+	void* m_cqMemory;
+	size_t m_cqMemorySize;
+	void* m_entries;
+	size_t m_entriesSize;
+
+	/**
+	* Campurile inelelor, in memoria partajata cu nucleul
+	*/
+	unsigned* m_sqHead;
+	unsigned* m_sqTail;
+	unsigned* m_sqMask;
+	unsigned* m_sqArray;
+	unsigned* m_cqHead;
+	unsigned* m_cqTail;
+	unsigned* m_cqMask;
+	void* m_completions;
+
+	/**
+	* Cate citiri pot fi in desfasurare; restul asteapta in m_waiting
+	*/
+	int m_depth;
+	int m_inFlight;
+	int m_unsubmitted;
+	std::deque<AsyncRequest*> m_waiting;
+
+	/**
+	* Cereri terminate, nelivrate inca
+	*/
+	std::vector<AsyncRequest*> m_completed;
+
+	/**
+	* Pentru fisierele fara descriptor; creat la prima nevoie
+	*/
+	ThreadPoolIO* m_fallback;
+
+	/**
+	* Descriptorul unui fisier local, sau -1
+	*/
+	static int GetDescriptor(File* file);
+
+	/**
+	* Scrie o intrare in inelul de trimitere
+	*/
+	void Push(AsyncRequest& request);
+
+	/**
+	* Trimite nucleului intrarile scrise; cu wait, asteapta si o terminare
+	*/
+	bool Enter(bool wait);
+
+	/**
+	* Culege terminarile din inel si trimite cererile care asteptau
+	*/
+	void Reap();
+
+	/**
+	* Marcheaza cererile terminate si apeleaza callback-urile
+	*/
+	int Deliver();
+
+	void Free();
+
+	// Nu copiem inelele
+	UringIO(const UringIO&);
+	UringIO& operator=(const UringIO&);
+
+public:
+	/**
+	* Creeaza un inel cu queueDepth intrari; verificati IsOpen()
+	*/
+	explicit UringIO(int queueDepth);
+
+	/**
+	* Inelul a fost creat
+	*/
+	bool IsOpen() const { return m_ring >= 0; }
+
+	// Mostenite din AsyncIO
+	bool Submit(AsyncRequest& request);
+
+	int Poll();
+
+	void Wait(AsyncRequest& request);
+
+	void WaitAll();
+
+	int GetPending();
+
+	const char* GetName();
+
+	/**
+	* Sistemul suporta io_uring cu IORING_OP_READ (Linux 5.6 sau mai nou)
+	*/
+	static bool IsSupported();
+
+	/**
+	* Asteapta cererile ramase si inchide inelul
+	*/
+	virtual ~UringIO();
+};
+
+#endif /*URINGIO_H_*/
@@ -0,0 +1,180 @@
+#include <string.h>
+#include <LocalFile.h>
+#include <MappedFile.h>
+#include "VirtualFileSystem.h"
+
+VirtualFileSystem::VirtualFileSystem()
+{
+}
+
+/**
+ * Prefixul unei montari, normalizat si terminat cu '/'
+ */
+static std::string MountPrefix(const char* mountPoint)
+{
+	std::string point = PackArchive::NormalizeName(mountPoint ? mountPoint : "");
+	if (!point.empty() && point[point.size() - 1] != '/')
+	{
+		point += '/';
+	}
+	return point;
+}
+
+void VirtualFileSystem::MountDirectory(const char* directory, const char* mountPoint)
+{
+	Mount mount;
+	mount.point = MountPrefix(mountPoint);
+	mount.directory = directory;
+	mount.pack = NULL;
+
+	// Numele relative se lipesc direct dupa director
+	if (!mount.directory.empty())
+	{
+		char last = mount.directory[mount.directory.size() - 1];
+		if (last != '/' && last != '\\')
+		{
+			mount.directory += '/';
+		}
+	}
+
+	m_mounts.push_back(mount);
+}
+
+bool VirtualFileSystem::MountPack(const char* filename, const char* mountPoint)
+{
+	PackArchive* pack = new PackArchive();
+	if (!pack->Open(filename))
+	{
+		delete pack;
+		return false;
+	}
+
+	Mount mount;
+	mount.point = MountPrefix(mountPoint);
+	mount.pack = pack;
+
+	m_mounts.push_back(mount);
+	return true;
+}
+
+void VirtualFileSystem::UnmountAll()
+{
+	for (size_t i = 0; i < m_mounts.size(); i++)
+	{
+		delete m_mounts[i].pack;
+	}
+	m_mounts.clear();
+}
+
+bool VirtualFileSystem::MatchMount(const Mount& mount, const std::string& key)
+{
+	return key.compare(0, mount.point.size(), mount.point) == 0;
+}
+
+MemoryFile* VirtualFileSystem::OpenMapped(const char* name)
+{
+	// Cheia (pentru arhive) si calea cu literele pastrate (pentru directoare)
+	std::string key = PackArchive::NormalizeName(name);
+	std::string path = PackArchive::NormalizeName(name, false);
+
+	for (size_t i = 0; i < m_mounts.size(); i++)
+	{
+		const Mount& mount = m_mounts[i];
+		if (!MatchMount(mount, key))
+		{
+			continue;
+		}
+
+		if (mount.pack)
+		{
+			int entry = mount.pack->Find(key.c_str() + mount.point.size());
+			if (entry >= 0)
+			{
+				return mount.pack->MapEntry(entry);
+			}
+		}
+		else
+		{
+			std::string local = mount.directory + path.substr(mount.point.size());
+			MappedFile* file = new MappedFile();
+			if (file->Open(local.c_str()))
+			{
+				return file;
+			}
+			delete file;
+		}
+	}
+
+	return NULL;
+}
+
+File* VirtualFileSystem::Open(const char* name, const char* mode)
+{
+	bool write = strpbrk(mode, "wa+") != NULL;
+	std::string key = PackArchive::NormalizeName(name);
+	std::string path = PackArchive::NormalizeName(name, false);
+
+	for (size_t i = 0; i < m_mounts.size(); i++)
+	{
+		const Mount& mount = m_mounts[i];
+		if (!MatchMount(mount, key))
+		{
+			continue;
+		}
+
+		// Din arhive doar citim, decomprimand pe masura ce se citeste
+		if (mount.pack)
+		{
+			int entry = write ? -1 : mount.pack->Find(key.c_str() + mount.point.size());
+			if (entry >= 0)
+			{
+				return mount.pack->OpenEntry(entry);
+			}
+			continue;
+		}
+
+		std::string local = mount.directory + path.substr(mount.point.size());
+		File* file = write ? (File*)new LocalFile() : (File*)new MappedFile();
+		if (file->Open(local.c_str(), mode))
+		{
+			return file;
+		}
+		delete file;
+	}
+
+	return NULL;
+}
+
+bool VirtualFileSystem::Exists(const char* name)
+{
+	std::string key = PackArchive::NormalizeName(name);
+	std::string path = PackArchive::NormalizeName(name, false);
+
+	for (size_t i = 0; i < m_mounts.size(); i++)
+	{
+		const Mount& mount = m_mounts[i];
+		if (!MatchMount(mount, key))
+		{
+			continue;
+		}
+
+		if (mount.pack)
+		{
+			if (mount.pack->Find(key.c_str() + mount.point.size()) >= 0)
+			{
+				return true;
+			}
+		}
+		else if (LocalFile::Exists((mount.directory + path.substr(mount.point.size())).c_str()))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+VirtualFileSystem::~VirtualFileSystem()
+{
+	this->UnmountAll();
+}
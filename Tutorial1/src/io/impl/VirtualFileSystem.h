@@ -0,0 +1,84 @@
+#ifndef VIRTUALFILESYSTEM_H_
+#define VIRTUALFILESYSTEM_H_
+
+#include <string>
+#include <vector>
+#include <File.h>
+#include <MemoryFile.h>
+#include <PackArchive.h>
+
+/**
+ * Sistem de fisiere virtual: numele sunt cautate, in ordinea montarii,
+ * intr-o lista de directoare si arhive. Fiecare montare are un punct de
+ * montare (prefix al numelui; "" se potriveste cu orice nume), iar prima
+ * montare care contine fisierul castiga. In arhive cautarea este in
+ * index, fara apeluri de sistem
+ */
+class VirtualFileSystem
+{
+private:
+	/**
+	* O montare: prefixul normalizat si directorul sau arhiva
+	*/
+	struct Mount
+	{
+		std::string point;
+		std::string directory;
+		PackArchive* pack;
+	};
+
+	std::vector<Mount> m_mounts;
+
+	/**
+	* Verifica daca numele normalizat incepe cu prefixul montarii
+	*/
+	static bool MatchMount(const Mount& mount, const std::string& key);
+
+	// Nu copiem sistemele de fisiere
+	VirtualFileSystem(const VirtualFileSystem&);
+	VirtualFileSystem& operator=(const VirtualFileSystem&);
+
+public:
+	VirtualFileSystem();
+
+	/**
+	* Adauga un director la sfarsitul listei de montari
+	*/
+	void MountDirectory(const char* directory, const char* mountPoint = "");
+
+	/**
+	* Deschide o arhiva si o adauga la sfarsitul listei de montari
+	*/
+	bool MountPack(const char* filename, const char* mountPoint = "");
+
+	/**
+	* Sterge toate montarile si inchide arhivele; fisierele deschise din
+	* arhive nu mai pot fi folosite
+	*/
+	void UnmountAll();
+
+	/**
+	* Deschide un fisier pentru citire, cu continutul direct in memorie:
+	* din arhiva fara copiere (intrarile comprimate sunt decomprimate
+	* intr-un bloc nou) sau mapat din director. Intoarce NULL daca
+	* fisierul nu exista; obiectul intors trebuie sters de apelant
+	*/
+	MemoryFile* OpenMapped(const char* name);
+
+	/**
+	* Deschide un fisier; pentru citire din arhive (intrarile comprimate
+	* sunt decomprimate pe masura ce se citesc) sau mapat din directoare,
+	* pentru scriere in primul director montat care se potriveste.
+	* Obiectul intors trebuie sters de apelant
+	*/
+	File* Open(const char* name, const char* mode = "rb");
+
+	/**
+	* Verifica daca un fisier exista in vreuna din montari
+	*/
+	bool Exists(const char* name);
+
+	~VirtualFileSystem();
+};
+
+#endif /*VIRTUALFILESYSTEM_H_*/
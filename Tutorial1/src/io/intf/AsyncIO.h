@@ -0,0 +1,116 @@
+#ifndef ASYNCIO_H_
+#define ASYNCIO_H_
+
+#include <stddef.h>
+#include <File.h>
+
+class AsyncIO;
+struct AsyncRequest;
+
+/**
+ * Functia apelata la terminarea unei citiri asincrone
+ */
+typedef void (*AsyncCallback)(AsyncRequest& request);
+
+/**
+ * O citire asincrona: size octeti de la offset din file, pusi in buffer.
+ * Cererea este a apelantului si trebuie sa ramana valida (impreuna cu
+ * fisierul si bufferul) pana cand done devine true
+ */
+struct AsyncRequest
+{
+	File* file;
+	long offset;
+	size_t size;
+	void* buffer;
+
+	/**
+	* Optional, apelata cu cererea terminata; user este pentru apelant
+	*/
+	AsyncCallback callback;
+	void* user;
+
+	/**
+	* Rezultatul: octetii cititi (mai putini la sfarsitul fisierului)
+	* sau -1 la eroare; valid doar dupa ce done devine true
+	*/
+	long result;
+	bool done;
+
+	/**
+	* Folosit intern de implementare
+	*/
+	AsyncIO* backend;
+
+	AsyncRequest() :
+		file(NULL), offset(0), size(0), buffer(NULL), callback(NULL), user(NULL),
+		result(0), done(false), backend(NULL)
+	{
+	}
+
+	AsyncRequest(File* file, long offset, size_t size, void* buffer,
+		AsyncCallback callback = NULL, void* user = NULL) :
+		file(file), offset(offset), size(size), buffer(buffer), callback(callback), user(user),
+		result(0), done(false), backend(NULL)
+	{
+	}
+};
+
+/**
+ * Clasa abstracta pura ce reprezinta un mecanism de citire asincrona
+ * din obiecte File. Citirile se pun in coada cu Submit() si se termina
+ * in fundal; rezultatul (done, result si apelul callback-ului) este
+ * livrat doar din Poll()/Wait()/WaitAll(), pe firul care le apeleaza,
+ * deci callback-urile nu au nevoie de sincronizare (de ex. pot fi
+ * apelate din bucla principala GLUT). Obiectul nu este sigur pentru
+ * apeluri din mai multe fire
+ */
+class AsyncIO
+{
+public:
+	/**
+	* Pune o citire in coada; intoarce false daca cererea este invalida
+	*/
+	virtual bool Submit(AsyncRequest& request) = 0;
+
+	/**
+	* Livreaza citirile terminate, fara sa astepte; intoarce cate au fost
+	*/
+	virtual int Poll() = 0;
+
+	/**
+	* Asteapta terminarea unei cereri (ca un future); livreaza si alte
+	* cereri terminate intre timp
+	*/
+	virtual void Wait(AsyncRequest& request) = 0;
+
+	/**
+	* Asteapta terminarea tuturor cererilor
+	*/
+	virtual void WaitAll() = 0;
+
+	/**
+	* Numarul de cereri care nu au fost inca livrate
+	*/
+	virtual int GetPending() = 0;
+
+	/**
+	* Numele implementarii, pentru mesaje
+	*/
+	virtual const char* GetName() = 0;
+
+	/**
+	* Pentru a folosi polimorfismul destructorilor; cererile
+	* nelivrate sunt asteptate
+	*/
+	virtual ~AsyncIO(){};
+};
+
+/**
+ * Creeaza cea mai buna implementare disponibila: io_uring pe Linux,
+ * altfel un grup de fire; queueDepth este numarul maxim de citiri in
+ * desfasurare. Obiectul intors trebuie sters de apelant
+ */
+AsyncIO* CreateAsyncIO(int queueDepth);
+
+#endif /*ASYNCIO_H_*/
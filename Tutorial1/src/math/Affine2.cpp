@@ -0,0 +1,44 @@
+#include "Affine2.h"
+
+void Affine2::ToMatrix4(float m[16]) const
+{
+	m[0] = a;	m[4] = c;	m[8] = 0.0f;	m[12] = tx;
+	m[1] = b;	m[5] = d;	m[9] = 0.0f;	m[13] = ty;
+	m[2] = 0.0f;	m[6] = 0.0f;	m[10] = 1.0f;	m[14] = 0.0f;
+	m[3] = 0.0f;	m[7] = 0.0f;	m[11] = 0.0f;	m[15] = 1.0f;
+}
+
+void Affine2TransformPoints(const Affine2& m, const Vec2* in, Vec2* out, int count)
+{
+	// Copiem matricea local, ca sa nu fie recitita din memorie
+	// daca out se suprapune cu ea
+	const float a = m.a, b = m.b, c = m.c, d = m.d, tx = m.tx, ty = m.ty;
+
+	for (int i = 0; i < count; i++)
+	{
+		float x = in[i].x, y = in[i].y;
+		out[i].x = a * x + c * y + tx;
+		out[i].y = b * x + d * y + ty;
+	}
+}
+
+void Affine2TransformPoints(const Affine2& m, const float* inX, const float* inY,
+							float* outX, float* outY, int count)
+{
+	const float a = m.a, b = m.b, c = m.c, d = m.d, tx = m.tx, ty = m.ty;
+
+	for (int i = 0; i < count; i++)
+	{
+		float x = inX[i], y = inY[i];
+		outX[i] = a * x + c * y + tx;
+		outY[i] = b * x + d * y + ty;
+	}
+}
+
+void Affine2MultiplyArray(const Affine2* lhs, const Affine2* rhs, Affine2* out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		out[i] = lhs[i] * rhs[i];
+	}
+}
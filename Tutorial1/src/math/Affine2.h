@@ -0,0 +1,144 @@
+#ifndef AFFINE2_H_
+#define AFFINE2_H_
+
+#include <math.h>
+#include <Vec2.h>
+
+/**
+ * Transformare afina 2D (rotatie/scalare + translatie), stocata
+ * ca matrice 2x3 pe coloane, la fel ca OpenGL:
+ *
+ *   | a  c  tx |
+ *   | b  d  ty |
+ *
+ * Inlocuieste glTranslatef/glRotatef/glGetFloatv pe calea de animatie,
+ * astfel incat pozele se pot calcula fara context OpenGL
+ */
+struct Affine2
+{
+	float a, b, c, d, tx, ty;
+
+	/**
+	* Constructorul implicit nu initializeaza matricea (vezi Identity())
+	*/
+	Affine2() {}
+
+	Affine2(float a, float b, float c, float d, float tx, float ty) :
+		a(a), b(b), c(c), d(d), tx(tx), ty(ty) {}
+
+	static Affine2 Identity()
+	{
+		return Affine2(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+	}
+
+	static Affine2 Translation(float x, float y)
+	{
+		return Affine2(1.0f, 0.0f, 0.0f, 1.0f, x, y);
+	}
+
+	/**
+	* Rotatie in jurul originii; unghiul este in radiani
+	*/
+	static Affine2 Rotation(float angle)
+	{
+		float s = (float)sin(angle), co = (float)cos(angle);
+		return Affine2(co, s, -s, co, 0.0f, 0.0f);
+	}
+
+	/**
+	* Echivalent cu Translation(x, y) * Rotation(angle), dar fara inmultire
+	*/
+	static Affine2 RotationTranslation(float angle, float x, float y)
+	{
+		float s = (float)sin(angle), co = (float)cos(angle);
+		return Affine2(co, s, -s, co, x, y);
+	}
+
+	/**
+	* Compunere: rezultatul aplica intai m, apoi transformarea curenta
+	*/
+	Affine2 operator*(const Affine2& m) const
+	{
+		return Affine2(
+			a * m.a + c * m.b,
+			b * m.a + d * m.b,
+			a * m.c + c * m.d,
+			b * m.c + d * m.d,
+			a * m.tx + c * m.ty + tx,
+			b * m.tx + d * m.ty + ty);
+	}
+
+	/**
+	* Inmulteste la dreapta cu o translatie, la fel ca glTranslatef
+	*/
+	Affine2& Translate(float x, float y)
+	{
+		tx += a * x + c * y;
+		ty += b * x + d * y;
+		return *this;
+	}
+
+	/**
+	* Inmulteste la dreapta cu o rotatie, la fel ca glRotatef(angle, 0, 0, 1);
+	* unghiul este in radiani
+	*/
+	Affine2& Rotate(float angle)
+	{
+		float s = (float)sin(angle), co = (float)cos(angle);
+		float na = a * co + c * s, nb = b * co + d * s;
+		c = c * co - a * s;
+		d = d * co - b * s;
+		a = na;
+		b = nb;
+		return *this;
+	}
+
+	Vec2 TransformPoint(const Vec2& p) const
+	{
+		return Vec2(a * p.x + c * p.y + tx, b * p.x + d * p.y + ty);
+	}
+
+	/**
+	* Transforma o directie (fara translatie)
+	*/
+	Vec2 TransformVector(const Vec2& v) const
+	{
+		return Vec2(a * v.x + c * v.y, b * v.x + d * v.y);
+	}
+
+	Vec2 GetTranslation() const
+	{
+		return Vec2(tx, ty);
+	}
+
+	/**
+	* Unghiul de rotatie, in radiani; are sens doar fara scalare neuniforma
+	*/
+	float GetAngle() const
+	{
+		return (float)atan2(b, a);
+	}
+
+	/**
+	* Scrie matricea 4x4 pe coloane, pentru glLoadMatrixf/glMultMatrixf
+	*/
+	void ToMatrix4(float m[16]) const;
+};
+
+/**
+ * Transforma count puncte cu aceeasi matrice; in si out pot fi acelasi tablou
+ */
+void Affine2TransformPoints(const Affine2& m, const Vec2* in, Vec2* out, int count);
+
+/**
+ * Varianta pe tablouri separate pentru x si y (structure-of-arrays)
+ */
+void Affine2TransformPoints(const Affine2& m, const float* inX, const float* inY,
+							float* outX, float* outY, int count);
+
+/**
+ * out[i] = lhs[i] * rhs[i], pentru count matrici
+ */
+void Affine2MultiplyArray(const Affine2* lhs, const Affine2* rhs, Affine2* out, int count);
+
+#endif /*AFFINE2_H_*/
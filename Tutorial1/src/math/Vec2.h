@@ -0,0 +1,38 @@
+#ifndef VEC2_H_
+#define VEC2_H_
+
+/**
+ * Vector/punct in plan; folosit de calculele de animatie
+ * pe CPU in locul stivei de matrici OpenGL
+ */
+struct Vec2
+{
+	float x, y;
+
+	/**
+	* Constructorul implicit nu initializeaza componentele,
+	* ca sa putem aloca tablouri mari fara cost
+	*/
+	Vec2() {}
+
+	Vec2(float x, float y) : x(x), y(y) {}
+
+	Vec2 operator+(const Vec2& v) const { return Vec2(x + v.x, y + v.y); }
+
+	Vec2 operator-(const Vec2& v) const { return Vec2(x - v.x, y - v.y); }
+
+	Vec2 operator*(float s) const { return Vec2(x * s, y * s); }
+
+	Vec2& operator+=(const Vec2& v) { x += v.x; y += v.y; return *this; }
+
+	Vec2& operator-=(const Vec2& v) { x -= v.x; y -= v.y; return *this; }
+
+	Vec2& operator*=(float s) { x *= s; y *= s; return *this; }
+
+	/**
+	* Produsul scalar
+	*/
+	float Dot(const Vec2& v) const { return x * v.x + y * v.y; }
+};
+
+#endif /*VEC2_H_*/
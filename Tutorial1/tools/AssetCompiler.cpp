@@ -0,0 +1,601 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <Types.h>
+#include <MappedFile.h>
+#include <Skeleton.h>
+#include <AnimClip.h>
+#include <Skinning.h>
+#include <AnimAsset.h>
+#include <SkeletonTextParser.h>
+#include <MeshTextParser.h>
+#include <Thread.h>
+
+/* Offline asset compiler: turns the text skeleton/animation and mesh
+* files into the binary asset the game maps at load time. It does all the
+* work the text loaders used to do at startup and checks the data on the
+* way: bone names must be unique and all values finite, every mesh
+* influence must name a bone of the skeleton and have a usable weight.
+* Weights are merged, trimmed to SKIN_INFLUENCES and renormalized, names
+* are resolved to bone indices and identical keyframe timelines are
+* stored once.
+*
+* An output ending in .h is written as a C++ header instead, with the
+* asset as static data compiled into the program and its hierarchy as a
+* FixedSkeleton topology (see writeHeader).
+*
+* Each output is rebuilt only when the hash of its inputs (and of the
+* compiler's own format) differs from the one recorded in the cache file:
+*	AssetCompiler [-f] [-cache file] <skeleton.txt> <mesh.txt> <output.ska|.h> [...]
+*/
+
+/* Bump to invalidate every cached build when the compiler's output
+* changes without a new ANIM_ASSET_VERSION
+*/
+#define COMPILER_VERSION		2
+
+#define DEFAULT_CACHE_FILE		"AssetCompiler.cache"
+#define MAX_CACHE_ENTRIES		256
+#define MAX_PATH_LENGTH			260
+
+typedef struct
+{
+	char output[MAX_PATH_LENGTH];
+	uint64_t hash;
+} CacheEntry;
+
+static CacheEntry cache[MAX_CACHE_ENTRIES];
+static int cacheCount = 0;
+
+/* 64 bit FNV-1a over a block of bytes, continuing from hash */
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size)
+{
+	const unsigned char *p = (const unsigned char *)data;
+	size_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		hash ^= p[i];
+		hash *= (uint64_t)0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+static uint64_t hashInt(uint64_t hash, uint32_t value)
+{
+	return hashBytes(hash, &value, sizeof(value));
+}
+
+static void cacheLoad(const char *path)
+{
+	FILE *f = fopen(path, "rt");
+	char line[MAX_PATH_LENGTH + 32];
+	char *name, *end;
+	unsigned long high, low;
+	char half[9];
+
+	if (!f)
+		return;
+
+	/* Each line is "<16 hex digits> <output path>" */
+	while (cacheCount < MAX_CACHE_ENTRIES && fgets(line, sizeof(line), f))
+	{
+		if (strlen(line) < 18 || line[16] != ' ')
+			continue;
+
+		memcpy(half, line, 8);
+		half[8] = '\0';
+		high = strtoul(half, NULL, 16);
+		low = strtoul(line + 8, &end, 16);
+		if (end != line + 16)
+			continue;
+
+		name = line + 17;
+		name[strcspn(name, "\r\n")] = '\0';
+		if (!*name || strlen(name) >= MAX_PATH_LENGTH)
+			continue;
+
+		strcpy(cache[cacheCount].output, name);
+		cache[cacheCount].hash = ((uint64_t)high << 32) | (uint64_t)low;
+		cacheCount++;
+	}
+
+	fclose(f);
+}
+
+static int cacheSave(const char *path)
+{
+	FILE *f = fopen(path, "wt");
+	int i;
+
+	if (!f)
+		return 0;
+
+	for (i = 0; i < cacheCount; i++)
+		fprintf(f, "%08lx%08lx %s\n", (unsigned long)(cache[i].hash >> 32),
+			(unsigned long)(cache[i].hash & 0xFFFFFFFF), cache[i].output);
+
+	return fclose(f) == 0;
+}
+
+static CacheEntry *cacheFind(const char *output)
+{
+	int i;
+
+	for (i = 0; i < cacheCount; i++)
+		if (!strcmp(cache[i].output, output))
+			return &cache[i];
+
+	return NULL;
+}
+
+static void cacheStore(const char *output, uint64_t hash)
+{
+	CacheEntry *entry = cacheFind(output);
+
+	if (!entry)
+	{
+		if (cacheCount == MAX_CACHE_ENTRIES || strlen(output) >= MAX_PATH_LENGTH)
+			return;
+		entry = &cache[cacheCount++];
+		strcpy(entry->output, output);
+	}
+
+	entry->hash = hash;
+}
+
+static int fileExists(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+
+	if (!f)
+		return 0;
+	fclose(f);
+	return 1;
+}
+
+/* NaN and the infinities give NaN here */
+static int isFinite(float value)
+{
+	return value - value == 0.0f;
+}
+
+/* The checks the skeleton parser doesn't do itself */
+static int skeletonValidate(const char *path, const Skeleton *skel)
+{
+	int i, j, n = skel->GetBoneCount();
+
+	if (!n)
+	{
+		fprintf(stderr, "%s: no bones\n", path);
+		return 0;
+	}
+
+	if (n > SKIN_MAX_BONES)
+	{
+		fprintf(stderr, "%s: %d bones, the mesh format allows %d\n", path, n, SKIN_MAX_BONES);
+		return 0;
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		if (!isFinite(skel->GetX()[i]) || !isFinite(skel->GetY()[i]) ||
+			!isFinite(skel->GetAngles()[i]) || !isFinite(skel->GetLengths()[i]))
+		{
+			fprintf(stderr, "%s: bone %s has invalid values\n", path, skel->GetName(i));
+			return 0;
+		}
+
+		/* The mesh refers to bones by name, so names must be unique */
+		for (j = 0; j < i; j++)
+		{
+			if (!strcmp(skel->GetName(i), skel->GetName(j)))
+			{
+				fprintf(stderr, "%s: bone name %s is used twice\n", path, skel->GetName(i));
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+static int clipValidate(const char *path, const AnimClip *clip)
+{
+	int i, k, n;
+	const float *values;
+
+	for (i = 0; i < clip->GetChannelCount(); i++)
+	{
+		/* Only animated channels keep their values; the others are checked at the ends */
+		if (clip->GetChannelKind(i) == ANIM_CHANNEL_ANIMATED)
+		{
+			n = clip->GetKeyCount(i);
+			values = clip->GetKeyValues(i);
+			for (k = 0; k < n && isFinite(values[k]); k++)
+				;
+			if (k == n)
+				continue;
+		}
+		else if (isFinite(clip->SampleChannel(i, 0.0f)) && isFinite(clip->SampleChannel(i, clip->GetDuration())))
+			continue;
+
+		fprintf(stderr, "%s: invalid keyframe value on bone %d\n", path, clip->GetChannelBone(i));
+		return 0;
+	}
+
+	return 1;
+}
+
+/* Prints a float so that it reads back to the same value */
+static void formatFloat(char *text, float value)
+{
+	sprintf(text, "%.9g", value);
+	if (!strpbrk(text, ".e"))
+		strcat(text, ".0");
+	strcat(text, "f");
+}
+
+/* One array of the generated header, a few values per line. C++ has no
+* empty arrays, so those get a single unused element
+*/
+static void emitBegin(FILE *f, const char *type, const char *prefix, const char *field, int count)
+{
+	fprintf(f, "static %s %s_%s[%d] =\n{", type, prefix, field, count ? count : 1);
+}
+
+static void emitEnd(FILE *f, int count)
+{
+	fprintf(f, count ? "\n};\n\n" : "\n\t0\n};\n\n");
+}
+
+static void emitSeparator(FILE *f, int i, int perLine)
+{
+	fprintf(f, i % perLine ? ", " : (i ? ",\n\t" : "\n\t"));
+}
+
+static void emitInts(FILE *f, const char *type, const char *prefix, const char *field, const int *values, int count)
+{
+	int i;
+
+	emitBegin(f, type, prefix, field, count);
+	for (i = 0; i < count; i++)
+	{
+		emitSeparator(f, i, 12);
+		fprintf(f, "%d", values[i]);
+	}
+	emitEnd(f, count);
+}
+
+static void emitBytes(FILE *f, const char *type, const char *prefix, const char *field, const uint8_t *values, int count)
+{
+	int i;
+
+	emitBegin(f, type, prefix, field, count);
+	for (i = 0; i < count; i++)
+	{
+		emitSeparator(f, i, 16);
+		fprintf(f, "%d", values[i]);
+	}
+	emitEnd(f, count);
+}
+
+static void emitFloats(FILE *f, const char *type, const char *prefix, const char *field, const float *values, int count)
+{
+	char text[32];
+	int i;
+
+	emitBegin(f, type, prefix, field, count);
+	for (i = 0; i < count; i++)
+	{
+		emitSeparator(f, i, 6);
+		formatFloat(text, values[i]);
+		fputs(text, f);
+	}
+	emitEnd(f, count);
+}
+
+/* The symbol prefix is the output file name without its extension */
+static void headerPrefix(const char *output, char *prefix, int size)
+{
+	const char *name = output, *p;
+	int n = 0;
+
+	for (p = output; *p; p++)
+		if (*p == '/' || *p == '\\')
+			name = p + 1;
+
+	if (*name >= '0' && *name <= '9')
+		prefix[n++] = '_';
+	for (p = name; *p && *p != '.' && n < size - 1; p++)
+		prefix[n++] = ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9')) ? *p : '_';
+	prefix[n] = '\0';
+}
+
+/* Writes the asset as a C++ header: static arrays that go straight into
+* the executable's data, and a function that attaches the skeleton, the
+* clip and the mesh to them. Nothing is parsed or allocated at startup.
+* The arrays are plain C++03 aggregates (no constexpr in Visual Studio
+* 2008); the constant ones end up in read-only data. The rest pose, the
+* palette and the skinned positions are written while animating, so they
+* are shared by everyone who attaches the same embedded asset
+*/
+static int writeHeader(const char *output, const char *skeletonPath, const char *meshPath,
+	const Skeleton *skel, const AnimClip *clip, const SkinMesh *mesh)
+{
+	AnimClipData data = clip->GetData();
+	SkinStream stream = mesh->GetStream();
+	char prefix[64], guard[64], text[32];
+	int i, j, n = skel->GetBoneCount(), links[2][SKIN_MAX_BONES];
+	uint8_t flags[SKIN_MAX_BONES];
+	FILE *f;
+
+	if (mesh->IsVariable() || !(f = fopen(output, "wt")))
+		return 0;
+
+	headerPrefix(output, prefix, sizeof(prefix));
+	for (i = 0; prefix[i]; i++)
+		guard[i] = (char)toupper((unsigned char)prefix[i]);
+	guard[i] = '\0';
+
+	fprintf(f, "/* Generated by AssetCompiler from %s and %s, do not edit.\n", skeletonPath, meshPath);
+	fprintf(f, "* Include it in one source file and call %s_Attach(); FixedSkeleton<%s_Topology>\n* computes its poses\n*/\n\n", prefix, prefix);
+	fprintf(f, "#ifndef %s_H_\n#define %s_H_\n\n", guard, guard);
+	fprintf(f, "#include <Skeleton.h>\n#include <AnimClip.h>\n#include <Skinning.h>\n#include <FixedSkeleton.h>\n\n");
+
+	/* The hierarchy as a compile time topology, for FixedSkeleton */
+	fprintf(f, "FIXED_TOPOLOGY(%s_Topology, %d)\n", prefix, n);
+	for (i = 0; i < n; i++)
+		fprintf(f, "FIXED_BONE(%s_Topology, %d, %d)\n", prefix, i, skel->GetParent(i));
+	fprintf(f, "\n");
+
+	/* The skeleton; the pose arrays start as the rest pose */
+	for (i = 0; i < n; i++)
+	{
+		flags[i] = skel->GetFlags(i);
+		links[0][i] = skel->GetFirstChild(i);
+		links[1][i] = skel->GetNextSibling(i);
+	}
+
+	emitInts(f, "const int", prefix, "parent", skel->GetParents(), n);
+	emitFloats(f, "float", prefix, "x", skel->GetX(), n);
+	emitFloats(f, "float", prefix, "y", skel->GetY(), n);
+	emitFloats(f, "float", prefix, "angle", skel->GetAngles(), n);
+	emitFloats(f, "float", prefix, "length", skel->GetLengths(), n);
+	fprintf(f, "static Affine2 %s_world[%d];\n\n", prefix, n);
+	emitBytes(f, "const uint8_t", prefix, "flags", flags, n);
+
+	fprintf(f, "static const char %s_name[%d][BONE_NAME_LENGTH] =\n{", prefix, n);
+	for (i = 0; i < n; i++)
+	{
+		fprintf(f, i ? ",\n\t\"" : "\n\t\"");
+		for (j = 0; skel->GetName(i)[j]; j++)
+			fprintf(f, strchr("\"\\?", skel->GetName(i)[j]) ? "\\%c" : "%c", skel->GetName(i)[j]);
+		fprintf(f, "\"");
+	}
+	fprintf(f, "\n};\n\n");
+
+	emitInts(f, "const int", prefix, "firstChild", links[0], n);
+	emitInts(f, "const int", prefix, "nextSibling", links[1], n);
+
+	/* The clip */
+	emitInts(f, "const int", prefix, "timelineStart", data.timelineStart, data.timelineCount);
+	emitInts(f, "const int", prefix, "timelineKeys", data.timelineKeys, data.timelineCount);
+	emitBegin(f, "const uint32_t", prefix, "timelineHash", data.timelineCount);
+	for (i = 0; i < data.timelineCount; i++)
+	{
+		emitSeparator(f, i, 6);
+		fprintf(f, "0x%08lXu", (unsigned long)data.timelineHash[i]);
+	}
+	emitEnd(f, data.timelineCount);
+	emitInts(f, "const int", prefix, "timelineFirst", data.timelineFirst, data.timelineCount);
+	emitInts(f, "const int", prefix, "timelineLast", data.timelineLast, data.timelineCount);
+	emitFloats(f, "const float", prefix, "times", data.times, data.timeTotal);
+	emitInts(f, "const int", prefix, "bone", data.bone, data.channelCount);
+	emitBytes(f, "const uint8_t", prefix, "target", data.target, data.channelCount);
+	emitBytes(f, "const uint8_t", prefix, "kind", data.kind, data.channelCount);
+	emitInts(f, "const int", prefix, "timeline", data.timeline, data.channelCount);
+	emitInts(f, "const int", prefix, "valueStart", data.valueStart, data.channelCount);
+	emitInts(f, "const int", prefix, "nextChannel", data.nextChannel, data.channelCount);
+	emitFloats(f, "const float", prefix, "values", data.values, data.valueTotal);
+
+	/* The mesh, in the compact format, and room for the skinned positions */
+	n = stream.vertexCount;
+	emitFloats(f, "const float", prefix, "meshX", stream.x, n);
+	emitFloats(f, "const float", prefix, "meshY", stream.y, n);
+	emitBytes(f, "const uint8_t", prefix, "meshBone", stream.bone, n * SKIN_INFLUENCES);
+	emitBegin(f, "const uint16_t", prefix, "meshWeight", n * SKIN_INFLUENCES);
+	for (i = 0; i < n * SKIN_INFLUENCES; i++)
+	{
+		emitSeparator(f, i, 12);
+		fprintf(f, "%d", stream.weight[i]);
+	}
+	emitEnd(f, n * SKIN_INFLUENCES);
+	fprintf(f, "static float %s_skinnedX[%d];\n", prefix, n ? n : 1);
+	fprintf(f, "static float %s_skinnedY[%d];\n\n", prefix, n ? n : 1);
+
+	fprintf(f, "static void %s_Attach(Skeleton& skeleton, AnimClip& clip, SkinMesh& mesh)\n{\n", prefix);
+	fprintf(f, "\tSkeletonData bones;\n\tAnimClipData data;\n\tSkinStream stream;\n\n");
+	fprintf(f, "\tbones.boneCount = %d;\n", skel->GetBoneCount());
+	fprintf(f, "\tbones.parent = %s_parent;\n", prefix);
+	fprintf(f, "\tbones.x = %s_x;\n", prefix);
+	fprintf(f, "\tbones.y = %s_y;\n", prefix);
+	fprintf(f, "\tbones.angle = %s_angle;\n", prefix);
+	fprintf(f, "\tbones.length = %s_length;\n", prefix);
+	fprintf(f, "\tbones.world = %s_world;\n", prefix);
+	fprintf(f, "\tbones.flags = %s_flags;\n", prefix);
+	fprintf(f, "\tbones.name = %s_name;\n", prefix);
+	fprintf(f, "\tbones.firstChild = %s_firstChild;\n", prefix);
+	fprintf(f, "\tbones.nextSibling = %s_nextSibling;\n", prefix);
+	fprintf(f, "\tskeleton.Attach(bones);\n\n");
+	fprintf(f, "\tdata.timelineCount = %d;\n", data.timelineCount);
+	fprintf(f, "\tdata.timelineStart = %s_timelineStart;\n", prefix);
+	fprintf(f, "\tdata.timelineKeys = %s_timelineKeys;\n", prefix);
+	fprintf(f, "\tdata.timelineHash = %s_timelineHash;\n", prefix);
+	fprintf(f, "\tdata.timelineFirst = %s_timelineFirst;\n", prefix);
+	fprintf(f, "\tdata.timelineLast = %s_timelineLast;\n", prefix);
+	fprintf(f, "\tdata.timeTotal = %d;\n", data.timeTotal);
+	fprintf(f, "\tdata.times = %s_times;\n", prefix);
+	fprintf(f, "\tdata.channelCount = %d;\n", data.channelCount);
+	fprintf(f, "\tdata.bone = %s_bone;\n", prefix);
+	fprintf(f, "\tdata.target = %s_target;\n", prefix);
+	fprintf(f, "\tdata.kind = %s_kind;\n", prefix);
+	fprintf(f, "\tdata.timeline = %s_timeline;\n", prefix);
+	fprintf(f, "\tdata.valueStart = %s_valueStart;\n", prefix);
+	fprintf(f, "\tdata.nextChannel = %s_nextChannel;\n", prefix);
+	fprintf(f, "\tdata.constantFirst = %d;\n", data.constantFirst);
+	fprintf(f, "\tdata.constantLast = %d;\n", data.constantLast);
+	fprintf(f, "\tdata.constantCount = %d;\n", data.constantCount);
+	fprintf(f, "\tdata.linearFirst = %d;\n", data.linearFirst);
+	fprintf(f, "\tdata.linearLast = %d;\n", data.linearLast);
+	fprintf(f, "\tdata.linearCount = %d;\n", data.linearCount);
+	fprintf(f, "\tdata.valueTotal = %d;\n", data.valueTotal);
+	fprintf(f, "\tdata.values = %s_values;\n", prefix);
+	fprintf(f, "\tdata.keyTotal = %d;\n", data.keyTotal);
+	formatFloat(text, data.duration);
+	fprintf(f, "\tdata.duration = %s;\n", text);
+	fprintf(f, "\tclip.Attach(data);\n\n");
+	fprintf(f, "\tstream.vertexCount = %d;\n", n);
+	fprintf(f, "\tstream.x = %s_meshX;\n", prefix);
+	fprintf(f, "\tstream.y = %s_meshY;\n", prefix);
+	fprintf(f, "\tstream.bone = %s_meshBone;\n", prefix);
+	fprintf(f, "\tstream.weight = %s_meshWeight;\n", prefix);
+	fprintf(f, "\tmesh.Attach(stream, %s_skinnedX, %s_skinnedY);\n}\n\n", prefix, prefix);
+	fprintf(f, "#endif /*%s_H_*/\n", guard);
+
+	return fclose(f) == 0;
+}
+
+/* Binary assets and generated headers are told apart by the extension */
+static int isHeader(const char *output)
+{
+	const char *ext = strrchr(output, '.');
+
+	return ext && !strcmp(ext, ".h");
+}
+
+/* Compiles one asset; returns 0 on error, 1 when built, 2 when up to date */
+static int compileAsset(const char *skeletonPath, const char *meshPath, const char *output, int force)
+{
+	MappedFile skeletonFile, meshFile;
+	SkeletonTextParser skeletonParser;
+	MeshTextParser meshParser;
+	Skeleton skeleton;
+	AnimClip clip;
+	SkinMesh mesh;
+	CacheEntry *entry;
+	uint64_t hash = (uint64_t)0xCBF29CE484222325ULL;
+
+	if (!skeletonFile.Open(skeletonPath))
+	{
+		fprintf(stderr, "Can't open file %s for reading\n", skeletonPath);
+		return 0;
+	}
+	if (!meshFile.Open(meshPath))
+	{
+		fprintf(stderr, "Can't open file %s for reading\n", meshPath);
+		return 0;
+	}
+
+	/* The key covers the compiler and the formats, then both inputs */
+	hash = hashInt(hash, COMPILER_VERSION);
+	hash = hashInt(hash, ANIM_ASSET_VERSION);
+	hash = hashInt(hash, SKIN_INFLUENCES);
+	hash = hashInt(hash, (uint32_t)skeletonFile.GetLength());
+	hash = hashBytes(hash, skeletonFile.GetData(), skeletonFile.GetLength());
+	hash = hashInt(hash, (uint32_t)meshFile.GetLength());
+	hash = hashBytes(hash, meshFile.GetData(), meshFile.GetLength());
+
+	entry = cacheFind(output);
+	if (!force && entry && entry->hash == hash && fileExists(output))
+	{
+		printf("%s is up to date\n", output);
+		return 2;
+	}
+
+	if (!skeletonParser.Parse((const char *)skeletonFile.GetData(), skeletonFile.GetLength(),
+		skeleton, clip, Thread::GetProcessorCount()))
+	{
+		fprintf(stderr, "%s:%d: %s\n", skeletonPath, skeletonParser.GetErrorLine(), skeletonParser.GetError());
+		return 0;
+	}
+
+	if (!skeletonValidate(skeletonPath, &skeleton) || !clipValidate(skeletonPath, &clip))
+		return 0;
+
+	if (!meshParser.Parse((const char *)meshFile.GetData(), meshFile.GetLength(), skeleton, mesh))
+	{
+		fprintf(stderr, "%s:%d: %s\n", meshPath, meshParser.GetErrorLine(), meshParser.GetError());
+		return 0;
+	}
+
+	if (meshParser.GetDroppedCount())
+		printf("%s: %d influences dropped, weights renormalized\n", meshPath, meshParser.GetDroppedCount());
+
+	if (isHeader(output) ? !writeHeader(output, skeletonPath, meshPath, &skeleton, &clip, &mesh) :
+		!AnimAsset::Write(output, skeleton, clip, mesh))
+	{
+		fprintf(stderr, "Can't write %s\n", output);
+		remove(output);
+		return 0;
+	}
+
+	printf("%s: %d bones, %d channels (%d constant), %d timelines, %d of %d keys stored, %d vertices\n",
+		output, skeleton.GetBoneCount(), clip.GetChannelCount(), clip.GetConstantCount(),
+		clip.GetTimelineCount(), clip.GetValueCount(), clip.GetSourceKeyCount(), mesh.GetVertexCount());
+
+	cacheStore(output, hash);
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	const char *cachePath = DEFAULT_CACHE_FILE;
+	int i = 1, force = 0, built = 0, current = 0, failed = 0;
+
+	for (; i < argc && argv[i][0] == '-'; i++)
+	{
+		if (!strcmp(argv[i], "-f"))
+			force = 1;
+		else if (!strcmp(argv[i], "-cache") && i + 1 < argc)
+			cachePath = argv[++i];
+		else
+			break;
+	}
+
+	if (i == argc || (argc - i) % 3)
+	{
+		fprintf(stderr, "Usage: %s [-f] [-cache file] <skeleton.txt> <mesh.txt> <output.ska|.h> [...]\n", argv[0]);
+		fprintf(stderr, "  -f      rebuild even when the inputs didn't change\n");
+		fprintf(stderr, "  -cache  file with the input hashes (default %s)\n", DEFAULT_CACHE_FILE);
+		return EXIT_FAILURE;
+	}
+
+	cacheLoad(cachePath);
+
+	for (; i < argc; i += 3)
+	{
+		switch (compileAsset(argv[i], argv[i + 1], argv[i + 2], force))
+		{
+		case 0:
+			failed++;
+			break;
+		case 1:
+			built++;
+			break;
+		default:
+			current++;
+			break;
+		}
+	}
+
+	if (built && !cacheSave(cachePath))
+		fprintf(stderr, "Can't write cache file %s\n", cachePath);
+
+	printf("%d built, %d up to date, %d failed\n", built, current, failed);
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}